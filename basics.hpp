@@ -32,47 +32,49 @@
 template <class _T>
 _T && declval() {}
 // Global Operator aliases
-//(1) Compound assignment operators
-template <class _T, class _S>
+//(1) Compound assignment operators, unless _T declares a usable one itself
+#define _NO_MEMBER_(OP) requires (!requires(_T & t, const _S & s) { t.operator OP(s); })
+template <class _T, class _S> _NO_MEMBER_(+=)
 inline constexpr _T & operator+=(_T & t, const _S & s) noexcept {
 	return t = t + s;
 }
-template <class _T, class _S>
+template <class _T, class _S> _NO_MEMBER_(-=)
 inline constexpr _T & operator-=(_T & t, const _S & s) noexcept {
 	return t = t - s;
 }
-template <class _T, class _S>
+template <class _T, class _S> _NO_MEMBER_(*=)
 inline constexpr _T & operator*=(_T & t, const _S & s) noexcept {
 	return t = t * s;
 }
-template <class _T, class _S>
+template <class _T, class _S> _NO_MEMBER_(/=)
 inline constexpr _T & operator/=(_T & t, const _S & s) noexcept {
 	return t = t / s;
 }
-template <class _T, class _S>
+template <class _T, class _S> _NO_MEMBER_(%=)
 inline constexpr _T & operator%=(_T & t, const _S & s) noexcept {
 	return t = t % s;
 }
-template <class _T, class _S>
+template <class _T, class _S> _NO_MEMBER_(&=)
 inline constexpr _T & operator&=(_T & t, const _S & s) noexcept {
 	return t = t & s;
 }
-template <class _T, class _S>
+template <class _T, class _S> _NO_MEMBER_(|=)
 inline constexpr _T & operator|=(_T & t, const _S & s) noexcept {
 	return t = t | s;
 }
-template <class _T, class _S>
+template <class _T, class _S> _NO_MEMBER_(^=)
 inline constexpr _T & operator^=(_T & t, const _S & s) noexcept {
 	return t = t ^ s;
 }
-template <class _T, class _S>
+template <class _T, class _S> _NO_MEMBER_(<<=)
 inline constexpr _T & operator<<=(_T & t, const _S & s) noexcept {
 	return t = t << s;
 }
-template <class _T, class _S>
+template <class _T, class _S> _NO_MEMBER_(>>=)
 inline constexpr _T & operator>>=(_T & t, const _S & s) noexcept {
 	return t = t >> s;
 }
+#undef _NO_MEMBER_
 //(2) Comparison operaters deduced with operator== and operator<, deprecated in C++20
 template <class _T, class _S>
 inline constexpr auto operator!=(const _T & t, const _S & s) noexcept {
@@ -0,0 +1,349 @@
+#pragma once
+#ifndef _MATHLAB_BATCH_
+#define _MATHLAB_BATCH_ 1
+#include "dynamic.hpp"
+// Fewest batch elements an operation hands to a thread of its own
+#ifndef _MATHLAB_BATCH_GRAIN
+#define _MATHLAB_BATCH_GRAIN 16384
+#endif
+namespace Mathlab {
+	// 0 Lanes
+	// One register of consecutive batch elements: the kernel's SIMD wrapper for the types
+	// it multiplies and divides, a lone scalar otherwise
+	template <class _T> struct _ScalarLanes {
+		typedef _T type;
+		static constexpr size_t width = 1;
+		static type load(const _T* p) noexcept { return *p; }
+		static void store(_T* p, type v) noexcept { *p = v; }
+		static type set(_T t) noexcept { return t; }
+		static type add(type u, type v) noexcept { return u + v; }
+		static type sub(type u, type v) noexcept { return u - v; }
+		static type mul(type u, type v) noexcept { return u * v; }
+		static type div(type u, type v) noexcept { return u / v; }
+	};
+	template <class _T> using _BatchLanes = ::std::conditional_t<Kernel::_Simd<_T>::hasMul &&
+		Kernel::_Simd<_T>::hasDiv, Kernel::_Simd<_T>, _ScalarLanes<_T>>;
+	// A register of _BatchLanes with arithmetic operators, so that the closed forms of the
+	// kernel run on lanes as they do on scalars
+	template <class _T> struct _Lane {
+		typedef _BatchLanes<_T> _V;
+		typename _V::type v;
+		_Lane() noexcept : v(_V::set(0)) {}
+		_Lane(_T t) noexcept : v(_V::set(t)) {}
+		static _Lane load(const _T* p) noexcept { return _Lane(_V::load(p), 0); }
+		void store(_T* p) const noexcept { _V::store(p, v); }
+		friend _Lane operator+(_Lane a, _Lane b) noexcept { return _Lane(_V::add(a.v, b.v), 0); }
+		friend _Lane operator-(_Lane a, _Lane b) noexcept { return _Lane(_V::sub(a.v, b.v), 0); }
+		friend _Lane operator*(_Lane a, _Lane b) noexcept { return _Lane(_V::mul(a.v, b.v), 0); }
+		friend _Lane operator/(_Lane a, _Lane b) noexcept { return _Lane(_V::div(a.v, b.v), 0); }
+		friend _Lane operator-(_Lane a) noexcept { return _Lane(_V::sub(_V::set(0), a.v), 0); }
+	private:
+		_Lane(typename _V::type v, int) noexcept : v(v) {}
+	};
+	// Elements per tile: one cache line of each entry
+	template <class _T> inline constexpr size_t _batchLine = sizeof(_T) < _DYNAMIC_ALIGN ? _DYNAMIC_ALIGN / sizeof(_T) : 1;
+	//Calls f(b0, b1) on ranges of the tiles [0, n), spread over the pool
+	template <class _T, class _F> inline void _forBatch(size_t n, const _F& f) {
+		parallelFor(0, n, (_MATHLAB_BATCH_GRAIN + _batchLine<_T> - 1) / _batchLine<_T>, f);
+	}
+	// 1 Storage
+	// A batch of size() elements of E entries each, kept as tiles of L elements: a tile
+	// stores entry 0 of its L elements, then entry 1, and so on, each run one cache line.
+	// One entry of consecutive elements thus fills a vector register, so operations
+	// vectorize across elements rather than within one, while a tile stays contiguous:
+	// one plane per entry would stream from E distant places at once, more than the TLB
+	// and the prefetchers follow when E is 9 or 16. The last tile is padded, and kernels
+	// run over the padding instead of finishing with a scalar tail.
+	template <Arithmetic _T, size_t E> class _BatchStorage {
+	protected:
+		static constexpr size_t L = _batchLine<_T>;
+		_T* _data;
+		size_t _size, _tiles;
+		_BatchStorage(size_t n) : _data(_allocate<_T>((n + L - 1) / L * E * L)), _size(n), _tiles((n + L - 1) / L) {}
+		_BatchStorage(const _BatchStorage& other) : _BatchStorage(other._size) {
+			for (size_t i = 0; i < _tiles * E * L; ++i) _data[i] = other._data[i];
+		}
+		_BatchStorage(_BatchStorage&& other) noexcept
+			: _data(other._data), _size(other._size), _tiles(other._tiles) {
+			other._data = nullptr, other._size = other._tiles = 0;
+		}
+		~_BatchStorage() noexcept { _deallocate(_data, _tiles * E * L); }
+		void _swap(_BatchStorage& other) noexcept {
+			swap(_data, other._data), swap(_size, other._size), swap(_tiles, other._tiles);
+		}
+		void _check(size_t k) const {
+			if (k >= _size) throw Error(ERANGE, "Out of range");
+		}
+	public:
+		typedef _T ValueType;
+		static constexpr size_t entries = E;
+		//Elements per tile
+		static constexpr size_t tileSize = L;
+		size_t size() const noexcept { return _size; }
+		size_t tiles() const noexcept { return _tiles; }
+		_T* data() noexcept { return _data; }
+		const _T* data() const noexcept { return _data; }
+		//Entry e of element k
+		_T& entry(size_t e, size_t k) noexcept { return _data[(k / L * E + e) * L + k % L]; }
+		const _T& entry(size_t e, size_t k) const noexcept { return _data[(k / L * E + e) * L + k % L]; }
+	};
+	template <Arithmetic _T, size_t M, size_t N = M> class MatrixBatch : public _BatchStorage<_T, M * N> {
+		typedef _BatchStorage<_T, M * N> _B;
+	public:
+		static constexpr size_t rows = M;
+		static constexpr size_t columns = N;
+		explicit MatrixBatch(size_t n = 0) : _B(n) {}
+		//n copies of m
+		MatrixBatch(size_t n, const Matrix<_T, M, N>& m) : _B(n) {
+			for (size_t k = 0; k < n; ++k) set(k, m);
+		}
+		MatrixBatch(const Matrix<_T, M, N>* m, size_t n) : _B(n) {
+			for (size_t k = 0; k < n; ++k) set(k, m[k]);
+		}
+		template <Arithmetic _S> explicit MatrixBatch(const MatrixBatch<_S, M, N>& other) : _B(other.size()) {
+			const _S* q = other.data();
+			if constexpr (_B::L == MatrixBatch<_S, M, N>::tileSize)
+				for (size_t i = 0; i < _B::_tiles * M * N * _B::L; ++i) _B::_data[i] = q[i];
+			else for (size_t k = 0; k < _B::_size; ++k)
+				for (size_t e = 0; e < M * N; ++e) _B::entry(e, k) = other.entry(e, k);
+		}
+		MatrixBatch(const MatrixBatch&) = default;
+		MatrixBatch(MatrixBatch&&) noexcept = default;
+		MatrixBatch& operator=(MatrixBatch other) noexcept {
+			return _B::_swap(other), *this;
+		}
+		using _B::entry;
+		_T& entry(size_t i, size_t j, size_t k) noexcept { return _B::entry(i * N + j, k); }
+		const _T& entry(size_t i, size_t j, size_t k) const noexcept { return _B::entry(i * N + j, k); }
+		//Gathers element k
+		Matrix<_T, M, N> operator[](size_t k) const {
+			_B::_check(k);
+			Matrix<_T, M, N> m;
+			for (size_t e = 0; e < M * N; ++e) m.begin()[e] = _B::entry(e, k);
+			return m;
+		}
+		void set(size_t k, const Matrix<_T, M, N>& m) {
+			_B::_check(k);
+			for (size_t e = 0; e < M * N; ++e) _B::entry(e, k) = m.begin()[e];
+		}
+	};
+	template <Arithmetic _T, size_t N> class VectorBatch : public _BatchStorage<_T, N> {
+		typedef _BatchStorage<_T, N> _B;
+	public:
+		static constexpr size_t dimension = N;
+		explicit VectorBatch(size_t n = 0) : _B(n) {}
+		VectorBatch(size_t n, const Vector<_T, N>& v) : _B(n) {
+			for (size_t k = 0; k < n; ++k) set(k, v);
+		}
+		VectorBatch(const Vector<_T, N>* v, size_t n) : _B(n) {
+			for (size_t k = 0; k < n; ++k) set(k, v[k]);
+		}
+		VectorBatch(const VectorBatch&) = default;
+		VectorBatch(VectorBatch&&) noexcept = default;
+		VectorBatch& operator=(VectorBatch other) noexcept {
+			return _B::_swap(other), *this;
+		}
+		Vector<_T, N> operator[](size_t k) const {
+			_B::_check(k);
+			Vector<_T, N> v;
+			for (size_t e = 0; e < N; ++e) v[e] = _B::entry(e, k);
+			return v;
+		}
+		void set(size_t k, const Vector<_T, N>& v) {
+			_B::_check(k);
+			for (size_t e = 0; e < N; ++e) _B::entry(e, k) = v[e];
+		}
+	};
+	// 2 Products
+	// Operand readers for _batchProduct: entry e over the register at offset w of tile t,
+	// from the tiles of a batch of E entries or broadcast from a single matrix or vector
+	template <class _T, size_t E> struct _BatchTiles {
+		const _T* data;
+		_Lane<_T> operator()(size_t e, size_t t, size_t w) const noexcept {
+			return _Lane<_T>::load(data + (t * E + e) * _batchLine<_T> + w);
+		}
+	};
+	template <class _T> struct _BatchBroadcast {
+		const _T* data;
+		_Lane<_T> operator()(size_t e, size_t, size_t) const noexcept { return _Lane<_T>(data[e]); }
+	};
+	//c = a*b element by element for a(M*P) and b(P*N), either of them possibly broadcast
+	template <size_t M, size_t P, size_t N, class _T, class _A, class _B>
+	inline void _batchProduct(const _A& a, const _B& b, _T* c, size_t tiles) {
+		constexpr size_t L = _batchLine<_T>;
+		_forBatch<_T>(tiles, [&](size_t t0, size_t t1) {
+			for (size_t t = t0; t < t1; ++t) for (size_t w = 0; w < L; w += _BatchLanes<_T>::width)
+				for (size_t i = 0; i < M; ++i) for (size_t j = 0; j < N; ++j) {
+					_Lane<_T> s = a(i * P, t, w) * b(j, t, w);
+					for (size_t l = 1; l < P; ++l) s = s + a(i * P + l, t, w) * b(l * N + j, t, w);
+					s.store(c + (t * M * N + i * N + j) * L + w);
+				}
+		});
+	}
+	template <class _T, size_t M, size_t P, size_t N>
+	inline MatrixBatch<_T, M, N> operator*(const MatrixBatch<_T, M, P>& lhs, const MatrixBatch<_T, P, N>& rhs) {
+		if (lhs.size() != rhs.size()) throw Error(EDOM, "Dimension mismatch");
+		MatrixBatch<_T, M, N> res(lhs.size());
+		_batchProduct<M, P, N>(_BatchTiles<_T, M * P>{ lhs.data() }, _BatchTiles<_T, P * N>{ rhs.data() },
+			res.data(), res.tiles());
+		return res;
+	}
+	template <class _T, size_t M, size_t P, size_t N>
+	inline MatrixBatch<_T, M, N> operator*(const MatrixBatch<_T, M, P>& lhs, const Matrix<_T, P, N>& rhs) {
+		MatrixBatch<_T, M, N> res(lhs.size());
+		_batchProduct<M, P, N>(_BatchTiles<_T, M * P>{ lhs.data() }, _BatchBroadcast<_T>{ rhs.begin() },
+			res.data(), res.tiles());
+		return res;
+	}
+	template <class _T, size_t M, size_t P, size_t N>
+	inline MatrixBatch<_T, M, N> operator*(const Matrix<_T, M, P>& lhs, const MatrixBatch<_T, P, N>& rhs) {
+		MatrixBatch<_T, M, N> res(rhs.size());
+		_batchProduct<M, P, N>(_BatchBroadcast<_T>{ lhs.begin() }, _BatchTiles<_T, P * N>{ rhs.data() },
+			res.data(), res.tiles());
+		return res;
+	}
+	template <class _T, size_t M, size_t N>
+	inline VectorBatch<_T, M> operator*(const MatrixBatch<_T, M, N>& lhs, const VectorBatch<_T, N>& rhs) {
+		if (lhs.size() != rhs.size()) throw Error(EDOM, "Dimension mismatch");
+		VectorBatch<_T, M> res(lhs.size());
+		_batchProduct<M, N, 1>(_BatchTiles<_T, M * N>{ lhs.data() }, _BatchTiles<_T, N>{ rhs.data() },
+			res.data(), res.tiles());
+		return res;
+	}
+	//One transform applied to every vector of the batch
+	template <class _T, size_t M, size_t N>
+	inline VectorBatch<_T, M> operator*(const Matrix<_T, M, N>& lhs, const VectorBatch<_T, N>& rhs) {
+		VectorBatch<_T, M> res(rhs.size());
+		_batchProduct<M, N, 1>(_BatchBroadcast<_T>{ lhs.begin() }, _BatchTiles<_T, N>{ rhs.data() },
+			res.data(), res.tiles());
+		return res;
+	}
+	//Every transform of the batch applied to one vector
+	template <class _T, size_t M, size_t N>
+	inline VectorBatch<_T, M> operator*(const MatrixBatch<_T, M, N>& lhs, const Vector<_T, N>& rhs) {
+		VectorBatch<_T, M> res(lhs.size());
+		_batchProduct<M, N, 1>(_BatchTiles<_T, M * N>{ lhs.data() }, _BatchBroadcast<_T>{ &rhs[0] },
+			res.data(), res.tiles());
+		return res;
+	}
+	// 3 Determinant and inverse
+	// Up to 4*4 the closed forms run on whole registers; larger elements go one by one
+	// through LUDecomposition, where pivoting differs from element to element
+	template <class _T, size_t N> DynamicVector<_T> det(const MatrixBatch<_T, N, N>& m) {
+		const size_t n = m.size();
+		DynamicVector<_T> d(n);
+		if constexpr (N <= 4) {
+			constexpr size_t L = _batchLine<_T>, W = _BatchLanes<_T>::width;
+			_forBatch<_T>(m.tiles(), [&](size_t t0, size_t t1) {
+				_Lane<_T> a[N * N], b[N * N];
+				_T r[W];
+				for (size_t t = t0; t < t1; ++t) for (size_t w = 0; w < L && t * L + w < n; w += W) {
+					const _T* p = m.data() + t * N * N * L + w;
+					for (size_t e = 0; e < N * N; ++e) a[e] = _Lane<_T>::load(p + e * L);
+					Kernel::adjugate<N>(a, b).store(r);
+					for (size_t q = 0; q < W && t * L + w + q < n; ++q) d[t * L + w + q] = r[q];
+				}
+			});
+		} else for (size_t k = 0; k < n; ++k) d[k] = det(m[k]);
+		return d;
+	}
+	template <class _T, size_t N> MatrixBatch<Promoted<_T>, N, N> inv(const MatrixBatch<_T, N, N>& m) {
+		typedef Promoted<_T> _P;
+		if constexpr (!SameAs<_T, _P>) return inv(MatrixBatch<_P, N, N>(m));
+		else {
+			MatrixBatch<_T, N, N> res(m.size());
+			if constexpr (N <= 4) {
+				constexpr size_t L = _batchLine<_T>;
+				_forBatch<_T>(m.tiles(), [&](size_t t0, size_t t1) {
+					_Lane<_T> a[N * N], b[N * N];
+					for (size_t t = t0; t < t1; ++t) for (size_t w = 0; w < L; w += _BatchLanes<_T>::width) {
+						const size_t o = t * N * N * L + w;
+						for (size_t e = 0; e < N * N; ++e) a[e] = _Lane<_T>::load(m.data() + o + e * L);
+						const _Lane<_T> r = _Lane<_T>(1) / Kernel::adjugate<N>(a, b);
+						for (size_t e = 0; e < N * N; ++e) (b[e] * r).store(res.data() + o + e * L);
+					}
+				});
+			} else for (size_t k = 0; k < m.size(); ++k) res.set(k, inv(m[k]));
+			return res;
+		}
+	}
+	// 4 Linear transformation
+	// The builders of matrix.hpp over a batch of angles or quaternions
+	template <class _T, class _F> inline void _batchRotation(const DynamicVector<_T>& theta, const _F& f) {
+		constexpr size_t L = _batchLine<Promoted<_T>>;
+		const size_t n = theta.size();
+		_forBatch<Promoted<_T>>((n + L - 1) / L, [&](size_t t0, size_t t1) {
+			for (size_t k = t0 * L; k < t1 * L && k < n; ++k) f(k, cos(theta[k]), sin(theta[k]));
+		});
+	}
+	template <class _T> MatrixBatch<Promoted<_T>, 2> rotate2D(const DynamicVector<_T>& theta) {
+		MatrixBatch<Promoted<_T>, 2> m(theta.size());
+		_batchRotation(theta, [&](size_t k, Promoted<_T> c, Promoted<_T> s) {
+			m.entry(0, k) = c, m.entry(1, k) = -s, m.entry(2, k) = s, m.entry(3, k) = c;
+		});
+		return m;
+	}
+	//Rotate by X axis
+	template <class _T> MatrixBatch<Promoted<_T>, 3> roll(const DynamicVector<_T>& theta) {
+		MatrixBatch<Promoted<_T>, 3> m(theta.size());
+		_batchRotation(theta, [&](size_t k, Promoted<_T> c, Promoted<_T> s) {
+			m.entry(0, k) = 1, m.entry(4, k) = c, m.entry(5, k) = -s, m.entry(7, k) = s, m.entry(8, k) = c;
+		});
+		return m;
+	}
+	//Rotate by Y axis
+	template <class _T> MatrixBatch<Promoted<_T>, 3> pitch(const DynamicVector<_T>& theta) {
+		MatrixBatch<Promoted<_T>, 3> m(theta.size());
+		_batchRotation(theta, [&](size_t k, Promoted<_T> c, Promoted<_T> s) {
+			m.entry(0, k) = c, m.entry(2, k) = s, m.entry(4, k) = 1, m.entry(6, k) = -s, m.entry(8, k) = c;
+		});
+		return m;
+	}
+	//Rotate by Z axis
+	template <class _T> MatrixBatch<Promoted<_T>, 3> yaw(const DynamicVector<_T>& theta) {
+		MatrixBatch<Promoted<_T>, 3> m(theta.size());
+		_batchRotation(theta, [&](size_t k, Promoted<_T> c, Promoted<_T> s) {
+			m.entry(0, k) = c, m.entry(1, k) = -s, m.entry(3, k) = s, m.entry(4, k) = c, m.entry(8, k) = 1;
+		});
+		return m;
+	}
+	template <class _T> MatrixBatch<_T, 3> rotateQuaternion(const VectorBatch<_T, 4>& v) {
+		constexpr size_t L = _batchLine<_T>;
+		MatrixBatch<_T, 3> m(v.size());
+		_forBatch<_T>(v.tiles(), [&](size_t t0, size_t t1) {
+			typedef _Lane<_T> _L;
+			for (size_t t = t0; t < t1; ++t) for (size_t w = 0; w < L; w += _BatchLanes<_T>::width) {
+				const _T* p = v.data() + t * 4 * L + w;
+				_T* q = m.data() + t * 9 * L + w;
+				const _L v0 = _L::load(p), v1 = _L::load(p + L), v2 = _L::load(p + 2 * L), v3 = _L::load(p + 3 * L),
+					w2 = v0 * v0, x = v1 * v1, y = v2 * v2, z = v3 * v3,
+					s = _L(2) / (w2 + x + y + z),
+					a = v0 * v1 * s, b = v0 * v2 * s, c = v0 * v3 * s,
+					d = v2 * v3 * s, e = v1 * v3 * s, f = v1 * v2 * s;
+				(_L(1) - s * (y + z)).store(q), (f - c).store(q + L), (e + b).store(q + 2 * L);
+				(f + c).store(q + 3 * L), (_L(1) - s * (z + x)).store(q + 4 * L), (d - a).store(q + 5 * L);
+				(e - b).store(q + 6 * L), (d + a).store(q + 7 * L), (_L(1) - s * (x + y)).store(q + 8 * L);
+			}
+		});
+		return m;
+	}
+	// 5 Affine transformation
+	template <class _T, size_t N>
+	MatrixBatch<_T, N + 1> affine(const MatrixBatch<_T, N>& linear, const VectorBatch<_T, N>& transform) {
+		const size_t n = linear.size();
+		if (transform.size() != n) throw Error(EDOM, "Dimension mismatch");
+		MatrixBatch<_T, N + 1> res(n);
+		for (size_t k = 0; k < n; ++k) {
+			for (size_t i = 0; i < N; ++i) {
+				for (size_t j = 0; j < N; ++j) res.entry(i, j, k) = linear.entry(i, j, k);
+				res.entry(i, N, k) = transform.entry(i, k);
+			}
+			res.entry(N, N, k) = 1;
+		}
+		return res;
+	}
+	template <class _T, size_t N> MatrixBatch<_T, N + 1> affine(const MatrixBatch<_T, N>& linear) {
+		return affine(linear, VectorBatch<_T, N>(linear.size()));
+	}
+}
+#endif
\ No newline at end of file
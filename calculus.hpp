@@ -1,6 +1,7 @@
 #pragma once
 #include "math.hpp"
 #include "function.hpp"
+#include "parallel.hpp"
 namespace Mathlab {
 	//0 Index Sequences
 	template <size_t... N> using Indices = ::std::index_sequence<N...>;
@@ -46,23 +47,41 @@ namespace Mathlab {
 		};
 	}
 	//2 Integration
+	//Composite trapezoidal rule over the fewest equal steps no wider than dx; the interior
+	//samples are summed on the thread pool, 16384 to a chunk
 	template <Arithmetic _T, Invocable<_T> _F>
-	constexpr auto integrate(const _F& f, _T a, _T b, _T dx = 0x1p-16) -> decltype(_F()(_T())) {
+	constexpr auto integrate(const _F& f, _T a, _T b, _T dx = 0x1p-16) -> decltype(f(a)) {
+		typedef decltype(f(a)) _V;
 		if (isnan(b - a) || dx <= 0) return nan(EDOM);
 		else if (a == b) return 0;
 		else if (a > b) return -integrate(f, b, a, dx);
-		else if (a + dx >= b) return (f(a) + f(b)) * 0.5f * (b - a);
-		auto result = (f(a) + f(b)) * 0.5 * dx;
-		for (_T x = a; x < b; x += dx) r += (f(x) + f(x + dx)) * dx;
+		size_t n = size_t((b - a) / dx);
+		if (n * dx < b - a) ++n;
+		const _T h = (b - a) / n;
+		const auto samples = [&](size_t i0, size_t i1) {
+			_V s = 0;
+			for (size_t i = i0; i < i1; ++i) s += f(a + i * h);
+			return s;
+		};
+		const _V inner = ::std::is_constant_evaluated() ? samples(1, n) : parallelReduce(size_t(1), n,
+			size_t(16384), _V(0), samples, [](_V x, _V y) -> _V { return x + y; });
+		return ((f(a) + f(b)) / 2 + inner) * h;
 	}
 	//3 Solve Equation
 	//3.1 Using Newton Method at x=a
+	//Stops at an exact zero, once a step no longer moves a, or after 100 steps. For every
+	//root of a polynomial at once see PolynomialRoots in poly.hpp
 	template <Arithmetic _T, Invocable<_T> _F>
 	constexpr _T solveNewton(const _F& f, _T a, _T dx = 0x1p-16) {
 		auto t = f(a);
 		if (!t) return a;
 		auto df = diff(Function<decltype(t), _T>(f), dx);
-		return solve(f, a - t / df(a), dx);
+		for (size_t i = 0; i < 100 && t; ++i, t = f(a)) {
+			const _T b = a - t / df(a);
+			if (b == a || isnan(b)) return b;
+			a = b;
+		}
+		return a;
 	}
 	//3.1 Using Binary Search between x=a and x=b
 	template <Arithmetic _T, Invocable<_T> _F>
@@ -1,25 +1,981 @@
 #pragma once
-#include "math.hpp"
+#ifndef _MATHLAB_DYNAMIC_
+#define _MATHLAB_DYNAMIC_ 1
+#include <new>
+#include "matrix.hpp"
 namespace Mathlab {
-	template <Arithmetic _T = double> class DynamicMatrix {
-		_T *_data;
+	// 0 Aligned heap storage, one cache line per allocation boundary
+	inline constexpr size_t _DYNAMIC_ALIGN = 64;
+	template <class _T> constexpr _T* _allocate(size_t n) {
+		if (!n) return nullptr;
+		if (::std::is_constant_evaluated()) return new _T[n]{};
+		_T* p = static_cast<_T*>(::operator new(n * sizeof(_T), ::std::align_val_t(_DYNAMIC_ALIGN)));
+		for (size_t i = 0; i < n; ++i) ::new (p + i) _T();
+		return p;
+	}
+	template <class _T> constexpr void _deallocate(_T* p, size_t n) noexcept {
+		if (!p) return;
+		if (::std::is_constant_evaluated()) return delete[] p;
+		if constexpr (!::std::is_trivially_destructible_v<_T>) while (n--) p[n].~_T();
+		::operator delete(p, ::std::align_val_t(_DYNAMIC_ALIGN));
+	}
+	// Owning array for element types DynamicVector does not hold, such as Complex
+	template <class _T> class _Buffer {
+		_T* _data;
+		size_t _size;
+	public:
+		explicit constexpr _Buffer(size_t n = 0) : _data(_allocate<_T>(n)), _size(n) {}
+		constexpr _Buffer(const _Buffer& other) : _Buffer(other._size) {
+			for (size_t i = 0; i < _size; ++i) _data[i] = other._data[i];
+		}
+		constexpr _Buffer(_Buffer&& other) noexcept : _data(other._data), _size(other._size) {
+			other._data = nullptr, other._size = 0;
+		}
+		constexpr ~_Buffer() noexcept { _deallocate(_data, _size); }
+		constexpr _Buffer& operator=(_Buffer other) noexcept {
+			swap(_data, other._data), swap(_size, other._size);
+			return *this;
+		}
+		constexpr size_t size() const noexcept { return _size; }
+		constexpr _T* data() noexcept { return _data; }
+		constexpr const _T* data() const noexcept { return _data; }
+		constexpr _T& operator[](size_t i) noexcept { return _data[i]; }
+		constexpr const _T& operator[](size_t i) const noexcept { return _data[i]; }
+	};
+	// 1 Non-owning strided view of a matrix, used for blocks, rows, columns and transposes
+	template <class _T> class MatrixView {
+		_T* _data;
+		size_t _rows, _cols, _rs, _cs;
+		typedef struct { size_t a, b; } _index_t;
+	public:
+		typedef _T ValueType;
+		constexpr MatrixView(_T* d, size_t r, size_t c, size_t rs, size_t cs) noexcept
+			: _data(d), _rows(r), _cols(c), _rs(rs), _cs(cs) {}
+		constexpr size_t rows() const noexcept { return _rows; }
+		constexpr size_t columns() const noexcept { return _cols; }
+		constexpr size_t rowStride() const noexcept { return _rs; }
+		constexpr size_t columnStride() const noexcept { return _cs; }
+		constexpr _T* data() const noexcept { return _data; }
+		constexpr _T& operator[](_index_t z) const noexcept {
+			return _data[z.a * _rs + z.b * _cs];
+		}
+#ifdef __cpp_multidimensional_subscript
+		constexpr _T& operator[](size_t a, size_t b) const noexcept {
+			return _data[a * _rs + b * _cs];
+		}
+#endif
+		constexpr _T& at(size_t a, size_t b) const {
+			if (a >= _rows || b >= _cols) throw Error(ERANGE, "Out of range");
+			return _data[a * _rs + b * _cs];
+		}
+		constexpr MatrixView block(size_t i, size_t j, size_t m, size_t n) const {
+			if (i + m > _rows || j + n > _cols) throw Error(ERANGE, "Out of range");
+			return MatrixView(_data + i * _rs + j * _cs, m, n, _rs, _cs);
+		}
+		constexpr MatrixView row(size_t i) const { return block(i, 0, 1, _cols); }
+		constexpr MatrixView column(size_t j) const { return block(0, j, _rows, 1); }
+		constexpr MatrixView transposed() const noexcept {
+			return MatrixView(_data, _cols, _rows, _cs, _rs);
+		}
+		constexpr operator MatrixView<const _T>() const noexcept {
+			return MatrixView<const _T>(_data, _rows, _cols, _rs, _cs);
+		}
+		// Copy the elements of another view of the same shape into this one
+		template <class _S> constexpr const MatrixView& assign(const MatrixView<_S>& v) const {
+			if (v.rows() != _rows || v.columns() != _cols) throw Error(EDOM, "Dimension mismatch");
+			for (size_t i = 0; i < _rows; ++i) for (size_t j = 0; j < _cols; ++j)
+				(*this)[{i, j}] = v[{i, j}];
+			return *this;
+		}
+	};
+	// 2 Runtime-sized vector
+	template <Arithmetic _T = double> class DynamicVector {
+		_T* _data;
+		size_t _size;
+	public:
+		typedef _T ValueType;
+		constexpr DynamicVector() noexcept : _data(nullptr), _size(0) {}
+		explicit constexpr DynamicVector(size_t n, const _T& t = 0)
+			: _data(_allocate<_T>(n)), _size(n) {
+			if (t) for (size_t i = 0; i < n; ++i) _data[i] = t;
+		}
+		template <Arithmetic _S> constexpr DynamicVector(const InitializerList<_S>& il)
+			: _data(_allocate<_T>(il.size())), _size(il.size()) {
+			size_t i = 0;
+			for (const _S& s : il) _data[i++] = s;
+		}
+		template <Arithmetic _S, size_t N> constexpr DynamicVector(const Vector<_S, N>& v)
+			: _data(_allocate<_T>(N)), _size(N) {
+			for (size_t i = 0; i < N; ++i) _data[i] = v[i];
+		}
+		constexpr DynamicVector(const DynamicVector& other)
+			: _data(_allocate<_T>(other._size)), _size(other._size) {
+			for (size_t i = 0; i < _size; ++i) _data[i] = other._data[i];
+		}
+		template <Arithmetic _S> explicit constexpr DynamicVector(const DynamicVector<_S>& other)
+			: _data(_allocate<_T>(other.size())), _size(other.size()) {
+			for (size_t i = 0; i < _size; ++i) _data[i] = other[i];
+		}
+		constexpr DynamicVector(DynamicVector&& other) noexcept
+			: _data(other._data), _size(other._size) {
+			other._data = nullptr, other._size = 0;
+		}
+		constexpr ~DynamicVector() noexcept {
+			_deallocate(_data, _size);
+		}
+		constexpr DynamicVector& operator=(const DynamicVector& other) {
+			if (this == &other) return *this;
+			if (_size != other._size) {
+				_deallocate(_data, _size);
+				_data = _allocate<_T>(_size = other._size);
+			}
+			for (size_t i = 0; i < _size; ++i) _data[i] = other._data[i];
+			return *this;
+		}
+		constexpr DynamicVector& operator=(DynamicVector&& other) noexcept {
+			Mathlab::swap(_data, other._data), Mathlab::swap(_size, other._size);
+			return *this;
+		}
+		constexpr _T* begin() noexcept { return _data; }
+		constexpr _T* end() noexcept { return _data + _size; }
+		constexpr const _T* begin() const noexcept { return _data; }
+		constexpr const _T* end() const noexcept { return _data + _size; }
+		constexpr _T* data() noexcept { return _data; }
+		constexpr const _T* data() const noexcept { return _data; }
+		constexpr size_t size() const noexcept { return _size; }
+		constexpr bool empty() const noexcept { return !_size; }
+		constexpr _T& operator[](size_t a) noexcept { return _data[a]; }
+		constexpr const _T& operator[](size_t a) const noexcept { return _data[a]; }
+		constexpr _T& at(size_t a) {
+			return a >= _size ? throw Error(ERANGE, "Out of range") : _data[a];
+		}
+		constexpr operator bool() const noexcept {
+			for (size_t i = 0; i < _size; ++i) if (_data[i]) return true;
+			return false;
+		}
+		template <Arithmetic _S> constexpr DynamicVector& operator+=(const DynamicVector<_S>& other) {
+			if (_size != other.size()) throw Error(EDOM, "Dimension mismatch");
+			if constexpr (SameAs<_T, _S> && Kernel::Vectorizable<_T>)
+				if (!::std::is_constant_evaluated()) return Kernel::add(_data, other.data(), _size), *this;
+			for (size_t i = 0; i < _size; ++i) _data[i] += other[i];
+			return *this;
+		}
+		template <Arithmetic _S> constexpr DynamicVector& operator-=(const DynamicVector<_S>& other) {
+			if (_size != other.size()) throw Error(EDOM, "Dimension mismatch");
+			if constexpr (SameAs<_T, _S> && Kernel::Vectorizable<_T>)
+				if (!::std::is_constant_evaluated()) return Kernel::sub(_data, other.data(), _size), *this;
+			for (size_t i = 0; i < _size; ++i) _data[i] -= other[i];
+			return *this;
+		}
+		template <Arithmetic _S> constexpr DynamicVector& operator*=(const _S& s) noexcept {
+			if constexpr (Kernel::VectorizableWith<_T, _S>)
+				if (!::std::is_constant_evaluated()) return Kernel::mul(_data, _T(s), _size), *this;
+			for (size_t i = 0; i < _size; ++i) _data[i] *= s;
+			return *this;
+		}
+		template <Arithmetic _S> constexpr DynamicVector& operator/=(const _S& s) noexcept {
+			if constexpr (Kernel::VectorizableWith<_T, _S>)
+				if (!::std::is_constant_evaluated()) return Kernel::div(_data, _T(s), _size), *this;
+			for (size_t i = 0; i < _size; ++i) _data[i] /= s;
+			return *this;
+		}
+		template <Arithmetic _S> constexpr bool operator==(const DynamicVector<_S>& rhs) const noexcept {
+			if (_size != rhs.size()) return false;
+			for (size_t i = 0; i < _size; ++i) if (_data[i] != rhs[i]) return false;
+			return true;
+		}
+		// Length-n column view over the elements
+		constexpr MatrixView<_T> view() noexcept { return MatrixView<_T>(_data, _size, 1, 1, 1); }
+		constexpr MatrixView<const _T> view() const noexcept {
+			return MatrixView<const _T>(_data, _size, 1, 1, 1);
+		}
+	};
+	// 3 Runtime-sized dense matrix, row-major unless ColumnMajor
+	template <Arithmetic _T = double, bool ColumnMajor = false> class DynamicMatrix {
+		_T* _data;
 		size_t _rows, _cols;
+		typedef struct { size_t a, b; } _index_t;
+		constexpr size_t _at(size_t a, size_t b) const noexcept {
+			return ColumnMajor ? b * _rows + a : a * _cols + b;
+		}
 	public:
-		constexpr DynamicMatrix(size_t x, size_t y) : _rows(x), _cols(y),
-			_data(new _T[x * y]{0}) {}
-		constexpr DynamicMatrix(const DynamicMatrix &other)
-			: _rows(other.rows), _cols(other.cols) {
-			size_t n = *other._dims;
-			_dims = new size_t[_ndims]{n};
-			for (size_t i = 1; i < _ndims; ++i) n *= _dims[i] = other._dims[i];
-			_data = new _T[n]{*other._data};
-			while (--n) _data[n] = other._data[n];
+		typedef _T ValueType;
+		static constexpr bool columnMajor = ColumnMajor;
+		constexpr DynamicMatrix() noexcept : _data(nullptr), _rows(0), _cols(0) {}
+		//Zero matrix, or t on the main diagonal as in Matrix(t)
+		constexpr DynamicMatrix(size_t x, size_t y, const _T& t = 0)
+			: _data(_allocate<_T>(x * y)), _rows(x), _cols(y) {
+			if (t) for (size_t i = 0; i < x && i < y; ++i) _data[_at(i, i)] = t;
+		}
+		//Elements listed row by row, the rest zero-filled
+		template <Arithmetic _S> constexpr DynamicMatrix(size_t x, size_t y, const InitializerList<_S>& il)
+			: _data(_allocate<_T>(x * y)), _rows(x), _cols(y) {
+			size_t a = 0;
+			for (const _S& s : il) if (a < x * y) _data[_at(a / y, a % y)] = s, ++a;
+		}
+		template <Arithmetic _S, size_t M, size_t N> constexpr DynamicMatrix(const Matrix<_S, M, N>& m)
+			: _data(_allocate<_T>(M * N)), _rows(M), _cols(N) {
+			for (size_t i = 0; i < M; ++i) for (size_t j = 0; j < N; ++j) _data[_at(i, j)] = m[i][j];
+		}
+		template <class _S> explicit constexpr DynamicMatrix(const MatrixView<_S>& v)
+			: _data(_allocate<_T>(v.rows() * v.columns())), _rows(v.rows()), _cols(v.columns()) {
+			for (size_t i = 0; i < _rows; ++i) for (size_t j = 0; j < _cols; ++j)
+				_data[_at(i, j)] = v[{i, j}];
+		}
+		constexpr DynamicMatrix(const DynamicMatrix& other)
+			: _data(_allocate<_T>(other.size())), _rows(other._rows), _cols(other._cols) {
+			for (size_t n = 0; n < size(); ++n) _data[n] = other._data[n];
+		}
+		template <Arithmetic _S, bool C> explicit constexpr DynamicMatrix(const DynamicMatrix<_S, C>& other)
+			: DynamicMatrix(other.view()) {}
+		constexpr DynamicMatrix(DynamicMatrix&& other) noexcept
+			: _data(other._data), _rows(other._rows), _cols(other._cols) {
+			other._data = nullptr, other._rows = other._cols = 0;
+		}
+		constexpr ~DynamicMatrix() noexcept {
+			_deallocate(_data, size());
+		}
+		constexpr DynamicMatrix& operator=(const DynamicMatrix& other) {
+			if (this == &other) return *this;
+			if (size() != other.size()) {
+				_deallocate(_data, size());
+				_data = _allocate<_T>(other.size());
+			}
+			_rows = other._rows, _cols = other._cols;
+			for (size_t n = 0; n < size(); ++n) _data[n] = other._data[n];
+			return *this;
+		}
+		constexpr DynamicMatrix& operator=(DynamicMatrix&& other) noexcept {
+			Mathlab::swap(_data, other._data);
+			Mathlab::swap(_rows, other._rows), Mathlab::swap(_cols, other._cols);
+			return *this;
+		}
+		constexpr size_t rows() const noexcept { return _rows; }
+		constexpr size_t columns() const noexcept { return _cols; }
+		constexpr size_t size() const noexcept { return _rows * _cols; }
+		constexpr bool empty() const noexcept { return !_data; }
+		constexpr _T* data() noexcept { return _data; }
+		constexpr const _T* data() const noexcept { return _data; }
+		constexpr _T* begin() noexcept { return _data; }
+		constexpr _T* end() noexcept { return _data + size(); }
+		constexpr const _T* begin() const noexcept { return _data; }
+		constexpr const _T* end() const noexcept { return _data + size(); }
+		constexpr operator bool() const noexcept {
+			for (size_t n = 0; n < size(); ++n) if (_data[n]) return true;
+			return false;
+		}
+		// Element access, starting at 0
+		constexpr _T* operator[](size_t z) noexcept requires (!ColumnMajor) {
+			return _data + z * _cols;
+		}
+		constexpr const _T* operator[](size_t z) const noexcept requires (!ColumnMajor) {
+			return _data + z * _cols;
+		}
+		constexpr _T& operator[](_index_t z) noexcept {
+			return _data[_at(z.a, z.b)];
+		}
+		constexpr const _T& operator[](_index_t z) const noexcept {
+			return _data[_at(z.a, z.b)];
+		}
+#ifdef __cpp_multidimensional_subscript
+		constexpr _T& operator[](size_t a, size_t b) noexcept {
+			return _data[_at(a, b)];
+		}
+		constexpr const _T& operator[](size_t a, size_t b) const noexcept {
+			return _data[_at(a, b)];
+		}
+#endif
+		constexpr _T& at(size_t a, size_t b) {
+			if (a >= _rows || b >= _cols) throw Error(ERANGE, "Out of range");
+			return _data[_at(a, b)];
+		}
+		constexpr const _T& at(size_t a, size_t b) const {
+			if (a >= _rows || b >= _cols) throw Error(ERANGE, "Out of range");
+			return _data[_at(a, b)];
+		}
+		// Views share storage with the matrix and must not outlive it
+		constexpr MatrixView<_T> view() noexcept {
+			return ColumnMajor ? MatrixView<_T>(_data, _rows, _cols, 1, _rows)
+				: MatrixView<_T>(_data, _rows, _cols, _cols, 1);
+		}
+		constexpr MatrixView<const _T> view() const noexcept {
+			return ColumnMajor ? MatrixView<const _T>(_data, _rows, _cols, 1, _rows)
+				: MatrixView<const _T>(_data, _rows, _cols, _cols, 1);
+		}
+		constexpr operator MatrixView<_T>() noexcept { return view(); }
+		constexpr operator MatrixView<const _T>() const noexcept { return view(); }
+		constexpr MatrixView<_T> block(size_t i, size_t j, size_t m, size_t n) {
+			return view().block(i, j, m, n);
+		}
+		constexpr MatrixView<const _T> block(size_t i, size_t j, size_t m, size_t n) const {
+			return view().block(i, j, m, n);
+		}
+		constexpr MatrixView<_T> row(size_t x) { return view().row(x); }
+		constexpr MatrixView<const _T> row(size_t x) const { return view().row(x); }
+		constexpr MatrixView<_T> column(size_t y) { return view().column(y); }
+		constexpr MatrixView<const _T> column(size_t y) const { return view().column(y); }
+		// Compound operators
+		template <Arithmetic _S, bool C>
+		constexpr DynamicMatrix& operator+=(const DynamicMatrix<_S, C>& other) {
+			if (_rows != other.rows() || _cols != other.columns()) throw Error(EDOM, "Dimension mismatch");
+			if constexpr (SameAs<_T, _S> && C == ColumnMajor && Kernel::Vectorizable<_T>)
+				if (!::std::is_constant_evaluated()) return Kernel::add(_data, other.data(), size()), *this;
+			for (size_t i = 0; i < _rows; ++i) for (size_t j = 0; j < _cols; ++j)
+				_data[_at(i, j)] += other[{i, j}];
+			return *this;
+		}
+		template <Arithmetic _S, bool C>
+		constexpr DynamicMatrix& operator-=(const DynamicMatrix<_S, C>& other) {
+			if (_rows != other.rows() || _cols != other.columns()) throw Error(EDOM, "Dimension mismatch");
+			if constexpr (SameAs<_T, _S> && C == ColumnMajor && Kernel::Vectorizable<_T>)
+				if (!::std::is_constant_evaluated()) return Kernel::sub(_data, other.data(), size()), *this;
+			for (size_t i = 0; i < _rows; ++i) for (size_t j = 0; j < _cols; ++j)
+				_data[_at(i, j)] -= other[{i, j}];
+			return *this;
+		}
+		template <Arithmetic _S> constexpr DynamicMatrix& operator*=(const _S& s) noexcept {
+			if constexpr (Kernel::VectorizableWith<_T, _S>)
+				if (!::std::is_constant_evaluated()) return Kernel::mul(_data, _T(s), size()), *this;
+			for (size_t n = 0; n < size(); ++n) _data[n] *= s;
+			return *this;
+		}
+		template <Arithmetic _S> constexpr DynamicMatrix& operator/=(const _S& s) noexcept {
+			if constexpr (Kernel::VectorizableWith<_T, _S>)
+				if (!::std::is_constant_evaluated()) return Kernel::div(_data, _T(s), size()), *this;
+			for (size_t n = 0; n < size(); ++n) _data[n] /= s;
+			return *this;
+		}
+		template <Arithmetic _S, bool C>
+		constexpr bool operator==(const DynamicMatrix<_S, C>& rhs) const noexcept {
+			if (_rows != rhs.rows() || _cols != rhs.columns()) return false;
+			for (size_t i = 0; i < _rows; ++i) for (size_t j = 0; j < _cols; ++j)
+				if (_data[_at(i, j)] != rhs[{i, j}]) return false;
+			return true;
 		}
-		constexpr DynamicMatrix(const InitializerList<_T> &il) {
-			il.begin();
+		// Elementary row and column operations
+		constexpr DynamicMatrix& rswap(size_t dst, size_t src) noexcept {
+			if (dst != src) for (size_t j = 0; j < _cols; ++j)
+				swap(_data[_at(dst, j)], _data[_at(src, j)]);
+			return *this;
 		}
-		constexpr ~DynamicMatrix() {
-			delete[] _data;
+		constexpr DynamicMatrix& radd(size_t dst, size_t src, _T t = 0) noexcept {
+			if (t) for (size_t j = 0; j < _cols; ++j) _data[_at(dst, j)] += _data[_at(src, j)] * t;
+			return *this;
+		}
+		constexpr DynamicMatrix& rmul(size_t dst, _T t = 1) noexcept {
+			if (t != 1) for (size_t j = 0; j < _cols; ++j) _data[_at(dst, j)] *= t;
+			return *this;
+		}
+		constexpr DynamicMatrix& cswap(size_t dst, size_t src) noexcept {
+			if (dst != src) for (size_t i = 0; i < _rows; ++i)
+				swap(_data[_at(i, dst)], _data[_at(i, src)]);
+			return *this;
+		}
+		constexpr DynamicMatrix& cadd(size_t dst, size_t src, _T t = 0) noexcept {
+			if (t) for (size_t i = 0; i < _rows; ++i) _data[_at(i, dst)] += _data[_at(i, src)] * t;
+			return *this;
+		}
+		constexpr DynamicMatrix& cmul(size_t dst, _T t = 1) noexcept {
+			if (t != 1) for (size_t i = 0; i < _rows; ++i) _data[_at(i, dst)] *= t;
+			return *this;
+		}
+	};
+	// 4 Operators
+	template <class _T, class _S> inline constexpr auto
+	operator+(const DynamicVector<_T>& lhs, const DynamicVector<_S>& rhs) {
+		DynamicVector<CommonType<_T, _S>> v(lhs);
+		return v += rhs, v;
+	}
+	template <class _T, class _S> inline constexpr auto
+	operator-(const DynamicVector<_T>& lhs, const DynamicVector<_S>& rhs) {
+		DynamicVector<CommonType<_T, _S>> v(lhs);
+		return v -= rhs, v;
+	}
+	template <class _T, Arithmetic _S> inline constexpr auto
+	operator*(const DynamicVector<_T>& lhs, const _S& rhs) {
+		DynamicVector<CommonType<_T, _S>> v(lhs);
+		return v *= rhs, v;
+	}
+	template <Arithmetic _T, class _S> inline constexpr auto
+	operator*(const _T& lhs, const DynamicVector<_S>& rhs) {
+		return rhs * lhs;
+	}
+	template <class _T, Arithmetic _S> inline constexpr auto
+	operator/(const DynamicVector<_T>& lhs, const _S& rhs) {
+		DynamicVector<CommonType<_T, _S>> v(lhs);
+		return v /= rhs, v;
+	}
+	template <class _T> inline constexpr DynamicVector<_T> operator-(const DynamicVector<_T>& v) {
+		return v * -1;
+	}
+	//Inner product, conjugating the right operand as Vector does
+	template <class _T, class _S> inline constexpr auto
+	operator*(const DynamicVector<_T>& lhs, const DynamicVector<_S>& rhs) {
+		if (lhs.size() != rhs.size()) throw Error(EDOM, "Dimension mismatch");
+		Multiplies<_T, _S> a = 0;
+		for (size_t i = 0; i < lhs.size(); ++i) a += lhs[i] * conj(rhs[i]);
+		return a;
+	}
+	//Euclidean norm, scaled against overflow
+	template <class _T> constexpr Promoted<_T> abs(const DynamicVector<_T>& v) noexcept {
+		Promoted<_T> scale = 0, ssq = 1;
+		for (const _T& t : v) if (t) {
+			Promoted<_T> a = abs(t);
+			if (scale < a) ssq = 1 + ssq * (scale / a) * (scale / a), scale = a;
+			else ssq += (a / scale) * (a / scale);
+		}
+		return scale * sqrt(ssq);
+	}
+	template <class _T, class _S, bool C> inline constexpr auto
+	operator+(const DynamicMatrix<_T, C>& lhs, const DynamicMatrix<_S, C>& rhs) {
+		DynamicMatrix<CommonType<_T, _S>, C> m(lhs);
+		return m += rhs, m;
+	}
+	template <class _T, class _S, bool C> inline constexpr auto
+	operator-(const DynamicMatrix<_T, C>& lhs, const DynamicMatrix<_S, C>& rhs) {
+		DynamicMatrix<CommonType<_T, _S>, C> m(lhs);
+		return m -= rhs, m;
+	}
+	template <class _T, Arithmetic _S, bool C> inline constexpr auto
+	operator*(const DynamicMatrix<_T, C>& lhs, const _S& rhs) {
+		DynamicMatrix<CommonType<_T, _S>, C> m(lhs);
+		return m *= rhs, m;
+	}
+	template <Arithmetic _T, class _S, bool C> inline constexpr auto
+	operator*(const _T& lhs, const DynamicMatrix<_S, C>& rhs) {
+		return rhs * lhs;
+	}
+	template <class _T, Arithmetic _S, bool C> inline constexpr auto
+	operator/(const DynamicMatrix<_T, C>& lhs, const _S& rhs) {
+		DynamicMatrix<CommonType<_T, _S>, C> m(lhs);
+		return m /= rhs, m;
+	}
+	template <class _T, bool C>
+	inline constexpr DynamicMatrix<_T, C> operator+(const DynamicMatrix<_T, C>& m) {
+		return m;
+	}
+	template <class _T, bool C>
+	inline constexpr DynamicMatrix<_T, C> operator-(const DynamicMatrix<_T, C>& m) {
+		return m * -1;
+	}
+	template <class _T, class _S, bool C> constexpr DynamicMatrix<Multiplies<_T, _S>, C>
+	operator*(const DynamicMatrix<_T, C>& lhs, const DynamicMatrix<_S, C>& rhs) {
+		const size_t m = lhs.rows(), n = lhs.columns(), p = rhs.columns();
+		if (rhs.rows() != n) throw Error(EDOM, "Dimension mismatch");
+		typedef Multiplies<_T, _S> _R;
+		DynamicMatrix<_R, C> res(m, p);
+		if constexpr (SameAs<_T, _S>) if (!::std::is_constant_evaluated()) {
+			//A column-major matrix is the row-major storage of its transpose: C' = B'A'
+			if constexpr (C) Kernel::gemm<_T>(p, n, m, rhs.data(), n, lhs.data(), m, res.data(), m);
+			else Kernel::gemm<_T>(m, n, p, lhs.data(), n, rhs.data(), p, res.data(), p);
+			return res;
+		}
+		for (size_t i = 0; i < m; ++i) for (size_t j = 0; j < n; ++j) {
+			const _R t = lhs[{i, j}];
+			for (size_t k = 0; k < p; ++k) res[{i, k}] += t * rhs[{j, k}];
+		}
+		return res;
+	}
+	template <class _T, class _S, bool C> constexpr DynamicVector<Multiplies<_T, _S>>
+	operator*(const DynamicMatrix<_T, C>& lhs, const DynamicVector<_S>& rhs) {
+		const size_t m = lhs.rows(), n = lhs.columns();
+		if (rhs.size() != n) throw Error(EDOM, "Dimension mismatch");
+		DynamicVector<Multiplies<_T, _S>> v(m);
+		if constexpr (C) { //column sweeps keep lhs accesses contiguous
+			for (size_t j = 0; j < n; ++j) {
+				const _S s = rhs[j];
+				const _T* a = lhs.data() + j * m;
+				for (size_t i = 0; i < m; ++i) v[i] += a[i] * s;
+			}
+		} else for (size_t i = 0; i < m; ++i) {
+			const _T* a = lhs[i];
+			Multiplies<_T, _S> t = 0;
+			for (size_t j = 0; j < n; ++j) t += a[j] * rhs[j];
+			v[i] = t;
+		}
+		return v;
+	}
+	template <class _T, class _S, bool C> constexpr DynamicVector<Multiplies<_T, _S>>
+	operator*(const DynamicVector<_T>& lhs, const DynamicMatrix<_S, C>& rhs) {
+		const size_t m = rhs.rows(), n = rhs.columns();
+		if (lhs.size() != m) throw Error(EDOM, "Dimension mismatch");
+		DynamicVector<Multiplies<_T, _S>> v(n);
+		for (size_t i = 0; i < m; ++i) for (size_t j = 0; j < n; ++j) v[j] += lhs[i] * rhs[{i, j}];
+		return v;
+	}
+	// 5 Matrix operations
+	template <class _T, bool C = false>
+	constexpr DynamicMatrix<_T, C> identityMatrix(size_t n) {
+		return DynamicMatrix<_T, C>(n, n, 1);
+	}
+	//Transposes the storage, which is rows*columns, or columns*rows if column-major
+	template <bool Conj, class _T, bool C> constexpr DynamicMatrix<_T, C> _transpose(const DynamicMatrix<_T, C>& m) {
+		const size_t r = C ? m.columns() : m.rows(), c = C ? m.rows() : m.columns();
+		DynamicMatrix<_T, C> n(m.columns(), m.rows());
+		Kernel::transpose<Conj>(r, c, m.data(), c, n.data(), r);
+		return n;
+	}
+	template <class _T, bool C> constexpr DynamicMatrix<_T, C> transpose(const DynamicMatrix<_T, C>& m) {
+		return _transpose<false>(m);
+	}
+	template <class _T, bool C> constexpr DynamicMatrix<_T, C> transjugate(const DynamicMatrix<_T, C>& m) {
+		return _transpose<true>(m);
+	}
+	template <class _T, bool C> constexpr DynamicMatrix<_T, C>& transposeInPlace(DynamicMatrix<_T, C>& m) {
+		if (m.rows() != m.columns()) throw Error(EDOM, "Not a square matrix");
+		Kernel::transposeSquare(m.rows(), m.data(), m.rows());
+		return m;
+	}
+	template <class _T, bool C> constexpr _T track(const DynamicMatrix<_T, C>& m) {
+		if (m.rows() != m.columns()) throw Error(EDOM, "Not a square matrix");
+		_T t = 0;
+		for (size_t n = 0; n < m.rows(); ++n) t += m[{n, n}];
+		return t;
+	}
+	//Runtime-sized LU decomposition, blocked for large n
+	template <class _T> class LUDecomposition<_T, 0> {
+		typedef Promoted<_T> _P;
+		DynamicMatrix<_P> _lu;
+		DynamicVector<size_t> _piv;
+		int _sign;
+	public:
+		typedef _P ValueType;
+		template <bool C> constexpr LUDecomposition(const DynamicMatrix<_T, C>& m)
+			: _lu(m), _piv(m.rows()), _sign(0) {
+			if (m.rows() != m.columns()) throw Error(EDOM, "Not a square matrix");
+			_sign = Kernel::luFactor(_lu.rows(), _lu.rows(), _lu.data(), _lu.rows(), _piv.data());
+		}
+		constexpr size_t size() const noexcept { return _lu.rows(); }
+		constexpr bool singular() const noexcept { return !_sign; }
+		//L below the diagonal (unit diagonal implied) and U on and above it
+		constexpr const DynamicMatrix<_P>& packed() const noexcept { return _lu; }
+		constexpr const size_t* pivots() const noexcept { return _piv.data(); }
+		constexpr _P det() const noexcept {
+			_P t = _sign;
+			for (size_t i = 0; i < size() && t; ++i) t *= _lu[i][i];
+			return t;
+		}
+		template <class _S> constexpr DynamicVector<_P> solve(const DynamicVector<_S>& b) const {
+			if (b.size() != size()) throw Error(EDOM, "Dimension mismatch");
+			if (singular()) throw Error(EDOM, "Singular matrix");
+			DynamicVector<_P> x(b);
+			Kernel::luSolve(size(), 1, _lu.data(), size(), _piv.data(), x.data(), 1);
+			return x;
+		}
+		//Multiple right-hand sides, one per column of b
+		template <class _S, bool C> constexpr DynamicMatrix<_P> solve(const DynamicMatrix<_S, C>& b) const {
+			if (b.rows() != size()) throw Error(EDOM, "Dimension mismatch");
+			if (singular()) throw Error(EDOM, "Singular matrix");
+			DynamicMatrix<_P> x(b);
+			Kernel::luSolve(size(), x.columns(), _lu.data(), size(), _piv.data(), x.data(), x.columns());
+			return x;
+		}
+		constexpr DynamicMatrix<_P> inv() const {
+			return solve(identityMatrix<_P>(size()));
+		}
+	};
+	template <class _T, bool C> LUDecomposition(const DynamicMatrix<_T, C>&) -> LUDecomposition<_T, 0>;
+	template <class _T> class CholeskyDecomposition<_T, 0> {
+		typedef Promoted<_T> _P;
+		DynamicMatrix<_P> _l;
+		bool _positive;
+	public:
+		typedef _P ValueType;
+		template <bool C> constexpr CholeskyDecomposition(const DynamicMatrix<_T, C>& m)
+			: _l(m), _positive(false) {
+			if (m.rows() != m.columns()) throw Error(EDOM, "Not a square matrix");
+			_positive = Kernel::cholFactor(size(), _l.data(), size());
+			for (size_t i = 0; i < size(); ++i) for (size_t j = i + 1; j < size(); ++j) _l[i][j] = 0;
+		}
+		constexpr size_t size() const noexcept { return _l.rows(); }
+		constexpr bool positive() const noexcept { return _positive; }
+		constexpr const DynamicMatrix<_P>& lower() const noexcept { return _l; }
+		constexpr _P det() const noexcept {
+			_P t = _positive;
+			for (size_t i = 0; i < size() && t; ++i) t *= _l[i][i] * _l[i][i];
+			return t;
+		}
+		template <class _S> constexpr DynamicVector<_P> solve(const DynamicVector<_S>& b) const {
+			if (b.size() != size()) throw Error(EDOM, "Dimension mismatch");
+			if (!_positive) throw Error(EDOM, "Not positive definite");
+			DynamicVector<_P> x(b);
+			Kernel::cholSolve(size(), 1, _l.data(), size(), x.data(), 1);
+			return x;
+		}
+		//Multiple right-hand sides, one per column of b
+		template <class _S, bool C> constexpr DynamicMatrix<_P> solve(const DynamicMatrix<_S, C>& b) const {
+			if (b.rows() != size()) throw Error(EDOM, "Dimension mismatch");
+			if (!_positive) throw Error(EDOM, "Not positive definite");
+			DynamicMatrix<_P> x(b);
+			Kernel::cholSolve(size(), x.columns(), _l.data(), size(), x.data(), x.columns());
+			return x;
+		}
+		constexpr DynamicMatrix<_P> inv() const {
+			return solve(identityMatrix<_P>(size()));
+		}
+	};
+	template <class _T, bool C> CholeskyDecomposition(const DynamicMatrix<_T, C>&) -> CholeskyDecomposition<_T, 0>;
+	template <class _T> class LDLDecomposition<_T, 0> {
+		typedef Promoted<_T> _P;
+		DynamicMatrix<_P> _ld;
+		bool _singular;
+	public:
+		typedef _P ValueType;
+		template <bool C> constexpr LDLDecomposition(const DynamicMatrix<_T, C>& m)
+			: _ld(m), _singular(true) {
+			if (m.rows() != m.columns()) throw Error(EDOM, "Not a square matrix");
+			_singular = !Kernel::ldlFactor(size(), _ld.data(), size());
+			for (size_t i = 0; i < size(); ++i) for (size_t j = i + 1; j < size(); ++j) _ld[i][j] = 0;
+		}
+		constexpr size_t size() const noexcept { return _ld.rows(); }
+		constexpr bool singular() const noexcept { return _singular; }
+		//L below the diagonal (unit diagonal implied) and D on it
+		constexpr const DynamicMatrix<_P>& packed() const noexcept { return _ld; }
+		constexpr DynamicVector<_P> diagonal() const {
+			DynamicVector<_P> d(size());
+			for (size_t i = 0; i < size(); ++i) d[i] = _ld[i][i];
+			return d;
+		}
+		constexpr _P det() const noexcept {
+			_P t = !_singular;
+			for (size_t i = 0; i < size() && t; ++i) t *= _ld[i][i];
+			return t;
+		}
+		template <class _S> constexpr DynamicVector<_P> solve(const DynamicVector<_S>& b) const {
+			if (b.size() != size()) throw Error(EDOM, "Dimension mismatch");
+			if (_singular) throw Error(EDOM, "Singular matrix");
+			DynamicVector<_P> x(b);
+			Kernel::ldlSolve(size(), 1, _ld.data(), size(), x.data(), 1);
+			return x;
+		}
+		//Multiple right-hand sides, one per column of b
+		template <class _S, bool C> constexpr DynamicMatrix<_P> solve(const DynamicMatrix<_S, C>& b) const {
+			if (b.rows() != size()) throw Error(EDOM, "Dimension mismatch");
+			if (_singular) throw Error(EDOM, "Singular matrix");
+			DynamicMatrix<_P> x(b);
+			Kernel::ldlSolve(size(), x.columns(), _ld.data(), size(), x.data(), x.columns());
+			return x;
+		}
+		constexpr DynamicMatrix<_P> inv() const {
+			return solve(identityMatrix<_P>(size()));
 		}
 	};
-}
\ No newline at end of file
+	template <class _T, bool C> LDLDecomposition(const DynamicMatrix<_T, C>&) -> LDLDecomposition<_T, 0>;
+	template <class _T> class PivotedCholesky<_T, 0> {
+		typedef Promoted<_T> _P;
+		typedef decltype(real(_P())) _R;
+		DynamicMatrix<_P> _l;
+		DynamicVector<size_t> _piv;
+		size_t _rank;
+	public:
+		typedef _P ValueType;
+		template <bool C> constexpr PivotedCholesky(const DynamicMatrix<_T, C>& m, _R tol = -1)
+			: _l(m), _piv(m.rows()), _rank(0) {
+			if (m.rows() != m.columns()) throw Error(EDOM, "Not a square matrix");
+			const size_t n = size();
+			if (tol < 0) {
+				_R big = 0;
+				for (size_t i = 0; i < n; ++i) if (big < real(_l[i][i])) big = real(_l[i][i]);
+				tol = big * Limits<_R>::epsilon() * n;
+			}
+			_rank = Kernel::cholPivoted(n, _l.data(), n, _piv.data(), tol);
+			for (size_t i = 0; i < n; ++i) for (size_t j = i + 1; j < n; ++j) _l[i][j] = 0;
+		}
+		constexpr size_t size() const noexcept { return _l.rows(); }
+		constexpr size_t rank() const noexcept { return _rank; }
+		//Index k was swapped with pivots()[k] at step k
+		constexpr const size_t* pivots() const noexcept { return _piv.data(); }
+		constexpr const DynamicMatrix<_P>& lower() const noexcept { return _l; }
+	};
+	template <class _T, bool C> PivotedCholesky(const DynamicMatrix<_T, C>&) -> PivotedCholesky<_T, 0>;
+	template <class _T> class QRDecomposition<_T, 0, 0> {
+		typedef Promoted<_T> _P;
+		DynamicMatrix<_P> _qr;
+		DynamicVector<_P> _tau;
+	public:
+		typedef _P ValueType;
+		template <bool C> constexpr QRDecomposition(const DynamicMatrix<_T, C>& m)
+			: _qr(m), _tau(m.rows() < m.columns() ? m.rows() : m.columns()) {
+			Kernel::qrFactor(rows(), columns(), _qr.data(), columns(), _tau.data());
+		}
+		constexpr size_t rows() const noexcept { return _qr.rows(); }
+		constexpr size_t columns() const noexcept { return _qr.columns(); }
+		//Whether R has a zero on its diagonal, that is A has deficient column rank
+		constexpr bool singular() const noexcept {
+			for (size_t i = 0; i < _tau.size(); ++i) if (!_qr[i][i]) return true;
+			return rows() < columns();
+		}
+		//R on and above the diagonal, the reflector vectors (unit head implied) below it
+		constexpr const DynamicMatrix<_P>& packed() const noexcept { return _qr; }
+		constexpr const _P* tau() const noexcept { return _tau.data(); }
+		constexpr DynamicMatrix<_P> R() const {
+			DynamicMatrix<_P> r(_tau.size(), columns());
+			for (size_t i = 0; i < r.rows(); ++i) for (size_t j = i; j < columns(); ++j) r[i][j] = _qr[i][j];
+			return r;
+		}
+		//The first min(rows, columns) columns of Q
+		constexpr DynamicMatrix<_P> Q() const {
+			const size_t k = _tau.size();
+			DynamicMatrix<_P> q(rows(), k, 1);
+			Kernel::qrMultiply(rows(), k, _qr.data(), columns(), _tau.data(), q.data(), k, k, false);
+			return q;
+		}
+		template <class _S> constexpr DynamicVector<_P> solve(const DynamicVector<_S>& b) const {
+			if (b.size() != rows()) throw Error(EDOM, "Dimension mismatch");
+			if (singular()) throw Error(EDOM, "Rank deficient matrix");
+			DynamicVector<_P> y(b), x(columns());
+			Kernel::qrSolve(rows(), columns(), _qr.data(), columns(), _tau.data(), y.data(), 1, 1);
+			for (size_t i = 0; i < x.size(); ++i) x[i] = y[i];
+			return x;
+		}
+		//Multiple right-hand sides, one per column of b
+		template <class _S, bool C> constexpr DynamicMatrix<_P> solve(const DynamicMatrix<_S, C>& b) const {
+			if (b.rows() != rows()) throw Error(EDOM, "Dimension mismatch");
+			if (singular()) throw Error(EDOM, "Rank deficient matrix");
+			DynamicMatrix<_P> y(b), x(columns(), b.columns());
+			Kernel::qrSolve(rows(), columns(), _qr.data(), columns(), _tau.data(), y.data(), y.columns(), y.columns());
+			for (size_t i = 0; i < x.rows(); ++i) for (size_t j = 0; j < x.columns(); ++j) x[i][j] = y[i][j];
+			return x;
+		}
+	};
+	template <class _T, bool C> QRDecomposition(const DynamicMatrix<_T, C>&) -> QRDecomposition<_T, 0, 0>;
+	template <class _T> class HermitianEigenDecomposition<_T, 0> {
+		typedef Promoted<_T> _P;
+		typedef decltype(real(_P())) _R;
+		DynamicVector<_R> _w;
+		DynamicMatrix<_P> _v;
+	public:
+		typedef _P ValueType;
+		template <bool C> constexpr HermitianEigenDecomposition(const DynamicMatrix<_T, C>& m, bool vectors = true)
+			: _w(m.rows()), _v(vectors ? m.rows() : 0, vectors ? m.rows() : 0) {
+			if (m.rows() != m.columns()) throw Error(EDOM, "Not a square matrix");
+			DynamicMatrix<_P> a(m);
+			Kernel::hermitianEigen(size(), a.data(), size(), _w.data(), vectors ? _v.data() : nullptr, size());
+		}
+		constexpr size_t size() const noexcept { return _w.size(); }
+		constexpr const DynamicVector<_R>& eigenvalues() const noexcept { return _w; }
+		//Empty unless constructed with vectors
+		constexpr const DynamicMatrix<_P>& eigenvectors() const noexcept { return _v; }
+	};
+	template <class _T, bool C> HermitianEigenDecomposition(const DynamicMatrix<_T, C>&, bool = true)
+		-> HermitianEigenDecomposition<_T, 0>;
+	template <class _T> class SchurDecomposition<_T, 0> {
+		typedef Promoted<_T> _P;
+		DynamicMatrix<_P> _t, _z;
+		_Buffer<Complex<_P>> _w;
+		bool _converged;
+	public:
+		typedef _P ValueType;
+		template <bool C> constexpr SchurDecomposition(const DynamicMatrix<_T, C>& m, bool schur = true)
+			: _t(m), _z(schur ? m.rows() : 0, schur ? m.rows() : 0), _w(m.rows()), _converged(false) {
+			if (m.rows() != m.columns()) throw Error(EDOM, "Not a square matrix");
+			DynamicVector<_P> wr(size()), wi(size());
+			_converged = Kernel::realSchur(size(), _t.data(), size(), wr.data(), wi.data(),
+				schur ? _z.data() : nullptr, size());
+			for (size_t i = 0; i < size(); ++i) _w[i] = Complex<_P>{ wr[i], wi[i] };
+			if (!schur) _t = DynamicMatrix<_P>();
+		}
+		constexpr size_t size() const noexcept { return _w.size(); }
+		constexpr bool converged() const noexcept { return _converged; }
+		constexpr const Complex<_P>* eigenvalues() const noexcept { return _w.data(); }
+		//Empty unless constructed with schur
+		constexpr const DynamicMatrix<_P>& T() const noexcept { return _t; }
+		constexpr const DynamicMatrix<_P>& Z() const noexcept { return _z; }
+	};
+	template <class _T, bool C> SchurDecomposition(const DynamicMatrix<_T, C>&, bool = true)
+		-> SchurDecomposition<_T, 0>;
+	template <class _T> class SingularValueDecomposition<_T, 0, 0> {
+		typedef Promoted<_T> _P;
+		typedef decltype(real(_P())) _R;
+		DynamicVector<_R> _s;
+		DynamicMatrix<_P> _u, _v;
+		size_t _m, _n;
+		bool _converged;
+	public:
+		typedef _P ValueType;
+		template <bool C> constexpr SingularValueDecomposition(const DynamicMatrix<_T, C>& m, bool vectors = true)
+			: _s(m.rows() < m.columns() ? m.rows() : m.columns()), _u(vectors ? m.rows() : 0, vectors ? _s.size() : 0),
+			_v(vectors ? m.columns() : 0, vectors ? _s.size() : 0), _m(m.rows()), _n(m.columns()), _converged(false) {
+			DynamicMatrix<_P> a(m);
+			_converged = Kernel::svd(_m, _n, a.data(), _n, _s.data(),
+				vectors ? _u.data() : nullptr, _s.size(), vectors ? _v.data() : nullptr, _s.size());
+		}
+		constexpr size_t rows() const noexcept { return _m; }
+		constexpr size_t columns() const noexcept { return _n; }
+		constexpr bool converged() const noexcept { return _converged; }
+		constexpr const DynamicVector<_R>& singularValues() const noexcept { return _s; }
+		//Empty unless constructed with vectors
+		constexpr const DynamicMatrix<_P>& U() const noexcept { return _u; }
+		constexpr const DynamicMatrix<_P>& V() const noexcept { return _v; }
+		//Number of singular values above tol, max(m, n)*eps*s[0] if negative
+		constexpr size_t rank(_R tol = -1) const noexcept {
+			if (tol < 0) tol = Kernel::svdTolerance(_m, _n, _s.data());
+			size_t r = 0;
+			while (r < _s.size() && tol < _s[r]) ++r;
+			return r;
+		}
+		constexpr _R norm() const noexcept { return _s.size() ? _s[0] : _R(0); }
+		constexpr _R cond() const noexcept {
+			return !_s.size() ? _R(0) : _s[_s.size() - 1] ? _s[0] / _s[_s.size() - 1] : infinity<_R>();
+		}
+		constexpr DynamicMatrix<_P> pinv(_R tol = -1) const {
+			if (!_u.rows() && _s.size()) throw Error(EDOM, "Singular vectors not computed");
+			if (tol < 0) tol = Kernel::svdTolerance(_m, _n, _s.data());
+			DynamicMatrix<_P> p(_n, _m);
+			Kernel::svdPinv(_m, _n, _s.data(), _u.data(), _s.size(), _v.data(), _s.size(), tol, p.data(), _m);
+			return p;
+		}
+	};
+	template <class _T, bool C> SingularValueDecomposition(const DynamicMatrix<_T, C>&, bool = true)
+		-> SingularValueDecomposition<_T, 0, 0>;
+	//Rank-k approximation U*diag(s)*V^H of a large m*n matrix by the randomized range finder
+	//of Halko, Martinsson and Tropp: A times k + oversample random vectors, refined by power
+	//iterations against slowly decaying spectra and orthonormalized by QR, gives a basis
+	//Q of about the dominant column space; the SVD of the small Q^H*A completes it. About
+	//(4 + 4*power)*m*n*(k + oversample) flops, all but the small SVD in gemm
+	template <class _T> class RandomizedSVD {
+		typedef Promoted<_T> _P;
+		typedef decltype(real(_P())) _R;
+		DynamicVector<_R> _s;
+		DynamicMatrix<_P> _u, _v;
+		//Replace the m*l matrix y with an orthonormal basis of its columns
+		static void _orthonormalize(size_t m, size_t l, _P* y) {
+			DynamicVector<_P> tau(l);
+			DynamicMatrix<_P> q(m, l, _P(1));
+			Kernel::qrFactor(m, l, y, l, tau.data());
+			Kernel::qrMultiply(m, l, y, l, tau.data(), q.data(), l, l, false);
+			for (size_t i = 0; i < m * l; ++i) y[i] = q.data()[i];
+		}
+	public:
+		typedef _P ValueType;
+		template <bool C> RandomizedSVD(const DynamicMatrix<_T, C>& m, size_t k, size_t power = 2,
+			size_t oversample = 10, unsigned long long seed = 5489) {
+			const DynamicMatrix<_P> a(m);
+			const size_t M = a.rows(), N = a.columns(), r = M < N ? M : N;
+			if (k > r) k = r;
+			const size_t l = k + oversample < r ? k + oversample : r;
+			DynamicMatrix<_P> omega(N, l), y(M, l), qh(l, M), b(l, N), z(N, l);
+			for (_P& t : omega) { //Uniform on [-1, 1) from splitmix64
+				unsigned long long x = seed += 0x9E3779B97F4A7C15ull;
+				x = (x ^ x >> 30) * 0xBF58476D1CE4E5B9ull, x = (x ^ x >> 27) * 0x94D049BB133111EBull;
+				t = _P(_R(int64_t((x ^ x >> 31) >> 11)) / _R(1ull << 52) - 1);
+			}
+			Kernel::gemm(M, N, l, a.data(), N, omega.data(), l, y.data(), l);
+			_orthonormalize(M, l, y.data());
+			for (size_t p = 0; p <= power; ++p) { //B = Q^H*A, then on power steps Y = A*orth(B^H)
+				Kernel::transpose<true>(M, l, y.data(), l, qh.data(), M);
+				b = DynamicMatrix<_P>(l, N);
+				Kernel::gemm(l, M, N, qh.data(), M, a.data(), N, b.data(), N);
+				if (p == power) break;
+				Kernel::transpose<true>(l, N, b.data(), N, z.data(), l);
+				_orthonormalize(N, l, z.data());
+				y = DynamicMatrix<_P>(M, l);
+				Kernel::gemm(M, N, l, a.data(), N, z.data(), l, y.data(), l);
+				_orthonormalize(M, l, y.data());
+			}
+			const SingularValueDecomposition<_P> svd(b);
+			DynamicMatrix<_P> u(M, l);
+			Kernel::gemm(M, l, l, y.data(), l, svd.U().data(), l, u.data(), l);
+			_s = DynamicVector<_R>(k), _u = DynamicMatrix<_P>(M, k), _v = DynamicMatrix<_P>(N, k);
+			for (size_t i = 0; i < k; ++i) _s[i] = svd.singularValues()[i];
+			for (size_t i = 0; i < M; ++i) for (size_t j = 0; j < k; ++j) _u[{i, j}] = u[{i, j}];
+			for (size_t i = 0; i < N; ++i) for (size_t j = 0; j < k; ++j) _v[{i, j}] = svd.V()[{i, j}];
+		}
+		constexpr size_t rank() const noexcept { return _s.size(); }
+		constexpr const DynamicVector<_R>& singularValues() const noexcept { return _s; }
+		constexpr const DynamicMatrix<_P>& U() const noexcept { return _u; }
+		constexpr const DynamicMatrix<_P>& V() const noexcept { return _v; }
+	};
+	template <class _T, bool C> RandomizedSVD(const DynamicMatrix<_T, C>&, size_t, size_t = 2, size_t = 10,
+		unsigned long long = 5489) -> RandomizedSVD<_T>;
+	template <class _T, bool C> constexpr Promoted<_T> det(const DynamicMatrix<_T, C>& m) {
+		return LUDecomposition<_T>(m).det();
+	}
+	template <class _T, bool C> constexpr DynamicMatrix<Promoted<_T>, C> inv(const DynamicMatrix<_T, C>& m) {
+		if constexpr (C) return DynamicMatrix<Promoted<_T>, C>(LUDecomposition<_T>(m).inv());
+		else return LUDecomposition<_T>(m).inv();
+	}
+	template <class _T, bool C> constexpr size_t rank(const DynamicMatrix<_T, C>& m) {
+		return SingularValueDecomposition<_T>(m, false).rank();
+	}
+	template <class _T, bool C> constexpr auto norm2(const DynamicMatrix<_T, C>& m) {
+		return SingularValueDecomposition<_T>(m, false).norm();
+	}
+	template <class _T, bool C> constexpr auto cond(const DynamicMatrix<_T, C>& m) {
+		return SingularValueDecomposition<_T>(m, false).cond();
+	}
+	template <class _T, bool C> constexpr DynamicMatrix<Promoted<_T>> pinv(const DynamicMatrix<_T, C>& m) {
+		return SingularValueDecomposition<_T>(m).pinv();
+	}
+	template <class _T, bool C> constexpr bool isSymmetric(const DynamicMatrix<_T, C>& m) noexcept {
+		if (m.rows() != m.columns()) return 0;
+		for (size_t i = 0; i < m.rows(); ++i) for (size_t j = 0; j < i; ++j)
+			if (m[{j, i}] != m[{i, j}]) return 0;
+		return 1;
+	}
+	template <class _T, bool C> constexpr bool isHermitian(const DynamicMatrix<_T, C>& m) noexcept {
+		if (m.rows() != m.columns()) return 0;
+		for (size_t i = 0; i < m.rows(); ++i) for (size_t j = 0; j <= i; ++j)
+			if (m[{j, i}] != conj(m[{i, j}])) return 0;
+		return 1;
+	}
+	//Solve A*x = b, through Cholesky when A is Hermitian positive definite and LU otherwise
+	template <class _T, class _S, bool C>
+	constexpr DynamicVector<Promoted<_T>> solve(const DynamicMatrix<_T, C>& a, const DynamicVector<_S>& b) {
+		if (isHermitian(a)) {
+			const CholeskyDecomposition<_T> c(a);
+			if (c.positive()) return c.solve(b);
+		}
+		return LUDecomposition<_T>(a).solve(b);
+	}
+	template <class _T, class _S, bool C, bool D>
+	constexpr DynamicMatrix<Promoted<_T>> solve(const DynamicMatrix<_T, C>& a, const DynamicMatrix<_S, D>& b) {
+		if (isHermitian(a)) {
+			const CholeskyDecomposition<_T> c(a);
+			if (c.positive()) return c.solve(b);
+		}
+		return LUDecomposition<_T>(a).solve(b);
+	}
+	//Minimize |A*x - b| over x for a tall A through QR
+	template <class _T, class _S, bool C>
+	constexpr DynamicVector<Promoted<_T>> leastSquares(const DynamicMatrix<_T, C>& a, const DynamicVector<_S>& b) {
+		return QRDecomposition<_T>(a).solve(b);
+	}
+	template <class _T, class _S, bool C, bool D>
+	constexpr DynamicMatrix<Promoted<_T>> leastSquares(const DynamicMatrix<_T, C>& a, const DynamicMatrix<_S, D>& b) {
+		return QRDecomposition<_T>(a).solve(b);
+	}
+	template <class _T, bool C>
+	constexpr DynamicMatrix<_T, C> _powMul(const DynamicMatrix<_T, C>& x, const DynamicMatrix<_T, C>& y) {
+		const size_t n = x.rows();
+		if constexpr (EitherOf<_T, float, double>)
+			if (n >= _MATHLAB_STRASSEN && !::std::is_constant_evaluated()) {
+				DynamicMatrix<_T, C> z(n, n);
+				if constexpr (C) Kernel::strassen(n, y.data(), n, x.data(), n, z.data(), n); //C' = B'A'
+				else Kernel::strassen(n, x.data(), n, y.data(), n, z.data(), n);
+				return z;
+			}
+		return x * y;
+	}
+	//m^n; a negative n inverts m once and raises the inverse
+	template <class _T, bool C> constexpr DynamicMatrix<_T, C> pow(const DynamicMatrix<_T, C>& m, int n) {
+		if (m.rows() != m.columns()) throw Error(EDOM, "Not a square matrix");
+		return _pow(n < 0 ? DynamicMatrix<_T, C>(inv(m)) : m, n < 0 ? 0ull - n : n,
+			identityMatrix<_T, C>(m.rows()));
+	}
+	template <class _T, bool C> constexpr DynamicMatrix<Promoted<_T>, C> expm(const DynamicMatrix<_T, C>& m) {
+		if (m.rows() != m.columns()) throw Error(EDOM, "Not a square matrix");
+		return _expm(DynamicMatrix<Promoted<_T>, C>(m), identityMatrix<Promoted<_T>, C>(m.rows()), m.rows());
+	}
+	template <class _T, bool C> inline constexpr DynamicMatrix<Promoted<_T>, C> exp(const DynamicMatrix<_T, C>& m) {
+		return expm(m);
+	}
+	//exp(t*m)*v, for propagating a state vector without forming exp(t*m)
+	template <class _T, class _S, bool C> constexpr DynamicVector<Promoted<_T>>
+	expmv(const DynamicMatrix<_T, C>& m, const DynamicVector<_S>& v, Promoted<_T> t = 1) {
+		if (m.rows() != m.columns()) throw Error(EDOM, "Not a square matrix");
+		if (v.size() != m.rows()) throw Error(EDOM, "Dimension mismatch");
+		return _expmv(DynamicMatrix<Promoted<_T>, C>(m), DynamicVector<Promoted<_T>>(v), m.rows(), t);
+	}
+}
+#endif
\ No newline at end of file
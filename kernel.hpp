@@ -0,0 +1,1927 @@
+#pragma once
+#ifndef _MATHLAB_KERNEL_
+#define _MATHLAB_KERNEL_ 1
+#include "math.hpp"
+#include "parallel.hpp"
+// Widest x86 vector extension enabled by the compiler flags; define as 0 to disable
+#ifndef _MATHLAB_SIMD
+#if defined(__AVX512F__)
+#define _MATHLAB_SIMD 512
+#elif defined(__AVX2__)
+#define _MATHLAB_SIMD 256
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_IX86_FP) && _M_IX86_FP >= 2
+#define _MATHLAB_SIMD 128
+#else
+#define _MATHLAB_SIMD 0
+#endif
+#endif
+#if _MATHLAB_SIMD
+#include <immintrin.h>
+#endif
+// Smallest square size Kernel::strassen recurses on instead of calling gemm
+#ifndef _MATHLAB_STRASSEN
+#define _MATHLAB_STRASSEN 512
+#endif
+// Longest factor Kernel::convolve multiplies by schoolbook instead of Karatsuba
+#ifndef _MATHLAB_KARATSUBA
+#define _MATHLAB_KARATSUBA 32
+#endif
+namespace Mathlab {
+	// Low-level kernels over contiguous row-major storage, shared by Matrix and Vector
+	namespace Kernel {
+		// 1 General matrix multiplication
+		// Cache blocking follows the Goto scheme: a KC*NR sliver of B lives in L1,
+		// an MC*KC block of A in L2 and a KC*NC panel of B in L3.
+		// A size of 0 means "not known at compile time".
+		template <class _T, size_t M = 0, size_t N = 0, size_t P = 0> struct GemmBlocking {
+			static constexpr size_t _round(size_t x, size_t r) noexcept {
+				return (x + r - 1) / r * r;
+			}
+			static constexpr size_t _clamp(size_t x, size_t r, size_t cap) noexcept {
+				return x && _round(x, r) < cap ? _round(x, r) : cap;
+			}
+			// Register tile: MR rows of A against NR columns of B (two 256-bit lanes)
+			static constexpr size_t MR = 4;
+			static constexpr size_t NR = sizeof(_T) <= 8 ? 64 / sizeof(_T) : 4;
+			static constexpr size_t KC = _clamp(N, 1, 16384 / (NR * sizeof(_T)) / 2 * 2);
+			static constexpr size_t MC = _clamp(M, MR, 131072 / (KC * sizeof(_T)) / MR * MR);
+			static constexpr size_t NC = _clamp(P, NR, 2048 / NR * NR);
+			// Below this many multiply-adds packing costs more than it saves
+			static constexpr bool worthy = !(M && N && P) || M * N * P >= 4096;
+		};
+		// Copy an mc*kc block of A into MR-row panels, zero-padding the last one.
+		// With TA, a holds the block transposed (kc*mc).
+		template <size_t MR, bool TA, class _T> inline void _packA(size_t mc, size_t kc,
+			const _T* a, size_t lda, _T* pack, const _T& alpha) noexcept {
+			for (size_t i = 0; i < mc; i += MR) {
+				const size_t mr = mc - i < MR ? mc - i : MR;
+				for (size_t p = 0; p < kc; ++p, pack += MR) {
+					size_t r = 0;
+					for (; r < mr; ++r) pack[r] = alpha * (TA ? a[p * lda + i + r] : a[(i + r) * lda + p]);
+					for (; r < MR; ++r) pack[r] = 0;
+				}
+			}
+		}
+		// Copy a kc*nc panel of B into NR-column slivers, zero-padding the last one.
+		// With TB, b holds the panel transposed (nc*kc) and is read along its rows.
+		template <size_t NR, bool TB, class _T> inline void _packB(size_t kc, size_t nc,
+			const _T* b, size_t ldb, _T* pack) noexcept {
+			for (size_t j = 0; j < nc; j += NR) {
+				const size_t nr = nc - j < NR ? nc - j : NR;
+				if constexpr (TB) {
+					for (size_t s = 0; s < NR; ++s) {
+						const _T* row = b + (j + s) * ldb;
+						for (size_t p = 0; p < kc; ++p) pack[p * NR + s] = s < nr ? row[p] : _T(0);
+					}
+					pack += kc * NR;
+				} else for (size_t p = 0; p < kc; ++p, pack += NR) {
+					const _T* row = b + p * ldb + j;
+					size_t s = 0;
+					for (; s < nr; ++s) pack[s] = row[s];
+					for (; s < NR; ++s) pack[s] = 0;
+				}
+			}
+		}
+		// C[mr][nr] += A-panel * B-sliver, accumulated in an MR*NR register tile
+		template <size_t MR, size_t NR, class _T> inline void _gemmMicro(size_t kc,
+			const _T* a, const _T* b, _T* c, size_t ldc, size_t mr, size_t nr) noexcept {
+			_T ab[MR][NR] = {};
+			for (size_t p = 0; p < kc; ++p, a += MR, b += NR)
+				for (size_t i = 0; i < MR; ++i) for (size_t j = 0; j < NR; ++j)
+					ab[i][j] += a[i] * b[j];
+			for (size_t i = 0; i < mr; ++i) for (size_t j = 0; j < nr; ++j)
+				c[i * ldc + j] += ab[i][j];
+		}
+		// C(m*p) += alpha * A(m*n) * B(n*p), all row-major with leading dimensions.
+		// TA and TB take A or B from the storage of its transpose, a as n*m or b as p*n.
+		template <class _T, size_t M = 0, size_t N = 0, size_t P = 0, bool TA = false, bool TB = false>
+		void gemm(size_t m, size_t n, size_t p, const _T* a, size_t lda,
+			const _T* b, size_t ldb, _T* c, size_t ldc, const _T& alpha = 1) noexcept {
+			typedef GemmBlocking<_T, M, N, P> _B;
+			if (!_B::worthy) {
+				for (size_t i = 0; i < m; ++i) for (size_t k = 0; k < n; ++k) {
+					const _T t = alpha * (TA ? a[k * lda + i] : a[i * lda + k]);
+					for (size_t j = 0; j < p; ++j) c[i * ldc + j] += t * (TB ? b[j * ldb + k] : b[k * ldb + j]);
+				}
+				return;
+			}
+			_T* packB = new _T[_B::KC * _B::NC];
+			const size_t blocks = (m + _B::MC - 1) / _B::MC;
+			const bool parallel = blocks > 1 && m * n * p >= _MATHLAB_PARALLEL_GRAIN;
+			for (size_t jc = 0; jc < p; jc += _B::NC) {
+				const size_t nc = p - jc < _B::NC ? p - jc : _B::NC;
+				for (size_t pc = 0; pc < n; pc += _B::KC) {
+					const size_t kc = n - pc < _B::KC ? n - pc : _B::KC;
+					_packB<_B::NR, TB>(kc, nc, TB ? b + jc * ldb + pc : b + pc * ldb + jc, ldb, packB);
+					//The MC-row blocks of A write disjoint rows of C, one task each
+					const auto rows = [&](size_t i0, size_t i1) {
+						_T* packA = new _T[_B::MC * _B::KC];
+						for (size_t ic = i0 * _B::MC; ic < m && ic < i1 * _B::MC; ic += _B::MC) {
+							const size_t mc = m - ic < _B::MC ? m - ic : _B::MC;
+							_packA<_B::MR, TA>(mc, kc, TA ? a + pc * lda + ic : a + ic * lda + pc, lda, packA, alpha);
+							for (size_t jr = 0; jr < nc; jr += _B::NR)
+								for (size_t ir = 0; ir < mc; ir += _B::MR)
+									_gemmMicro<_B::MR, _B::NR>(kc, packA + ir * kc, packB + jr * kc,
+										c + (ic + ir) * ldc + jc + jr, ldc,
+										mc - ir < _B::MR ? mc - ir : _B::MR,
+										nc - jr < _B::NR ? nc - jr : _B::NR);
+						}
+						delete[] packA;
+					};
+					if (parallel) parallelFor(0, blocks, 1, rows);
+					else rows(0, blocks);
+				}
+			}
+			delete[] packB;
+		}
+		// Fixed-size overload with the tiling derived from the dimensions
+		template <size_t M, size_t N, size_t P, bool TA = false, bool TB = false, class _T>
+		inline void gemm(const _T* a, const _T* b, _T* c) noexcept {
+			gemm<_T, M, N, P, TA, TB>(M, N, P, a, TA ? M : N, b, TB ? N : P, c, P);
+		}
+		// z = x + y, or x - y if Sub, over h*h blocks with leading dimensions
+		template <bool Sub, class _T> inline void _blockAdd(size_t h, const _T* x, size_t ldx,
+			const _T* y, size_t ldy, _T* z, size_t ldz) noexcept {
+			for (size_t i = 0; i < h; ++i) for (size_t j = 0; j < h; ++j)
+				z[i * ldz + j] = Sub ? x[i * ldx + j] - y[i * ldy + j] : x[i * ldx + j] + y[i * ldy + j];
+		}
+		// C(n*n) = A * B by Strassen-Winograd recursion: 7 half-size products and 15 block
+		// additions per level, using the C quadrants and two h*h buffers as scratch.
+		// Below _MATHLAB_STRASSEN the product goes to gemm; an odd last row and column are
+		// peeled off and fixed up with gemm.
+		template <class _T> void strassen(size_t n, const _T* a, size_t lda, const _T* b,
+			size_t ldb, _T* c, size_t ldc) noexcept {
+			if (n < _MATHLAB_STRASSEN || n < 2) {
+				for (size_t i = 0; i < n; ++i) for (size_t j = 0; j < n; ++j) c[i * ldc + j] = 0;
+				gemm<_T>(n, n, n, a, lda, b, ldb, c, ldc);
+				return;
+			}
+			const size_t h = n / 2, m = h * 2;
+			const _T* a11 = a, * a12 = a + h, * a21 = a + h * lda, * a22 = a21 + h;
+			const _T* b11 = b, * b12 = b + h, * b21 = b + h * ldb, * b22 = b21 + h;
+			_T* c11 = c, * c12 = c + h, * c21 = c + h * ldc, * c22 = c21 + h;
+			_T* x = new _T[h * h], * y = new _T[h * h];
+			_blockAdd<true>(h, a11, lda, a21, lda, x, h);      //S3 = A11 - A21
+			_blockAdd<true>(h, b22, ldb, b12, ldb, y, h);      //T3 = B22 - B12
+			strassen(h, x, h, y, h, c21, ldc);                 //P7 = S3 * T3
+			_blockAdd<false>(h, a21, lda, a22, lda, x, h);     //S1 = A21 + A22
+			_blockAdd<true>(h, b12, ldb, b11, ldb, y, h);      //T1 = B12 - B11
+			strassen(h, x, h, y, h, c22, ldc);                 //P5 = S1 * T1
+			_blockAdd<true>(h, x, h, a11, lda, x, h);          //S2 = S1 - A11
+			_blockAdd<true>(h, b22, ldb, y, h, y, h);          //T2 = B22 - T1
+			strassen(h, x, h, y, h, c12, ldc);                 //P6 = S2 * T2
+			_blockAdd<true>(h, a12, lda, x, h, x, h);          //S4 = A12 - S2
+			_blockAdd<true>(h, y, h, b21, ldb, y, h);          //T4 = T2 - B21
+			strassen(h, x, h, b22, ldb, c11, ldc);             //P3 = S4 * B22
+			strassen(h, a11, lda, b11, ldb, x, h);             //P1 = A11 * B11
+			_blockAdd<false>(h, x, h, c12, ldc, c12, ldc);     //U2 = P1 + P6
+			_blockAdd<false>(h, c12, ldc, c21, ldc, c21, ldc); //U3 = U2 + P7
+			_blockAdd<false>(h, c12, ldc, c22, ldc, c12, ldc); //U4 = U2 + P5
+			_blockAdd<false>(h, c21, ldc, c22, ldc, c22, ldc); //U7 = U3 + P5 = C22
+			_blockAdd<false>(h, c12, ldc, c11, ldc, c12, ldc); //U5 = U4 + P3 = C12
+			strassen(h, a22, lda, y, h, c11, ldc);             //P4 = A22 * T4
+			_blockAdd<true>(h, c21, ldc, c11, ldc, c21, ldc);  //U6 = U3 - P4 = C21
+			strassen(h, a12, lda, b21, ldb, c11, ldc);         //P2 = A12 * B21
+			_blockAdd<false>(h, c11, ldc, x, h, c11, ldc);     //U1 = P1 + P2 = C11
+			delete[] x;
+			delete[] y;
+			if (m == n) return;
+			gemm<_T>(m, 1, m, a + m, lda, b + m * ldb, ldb, c, ldc); //Odd column of A times odd row of B
+			for (size_t i = 0; i < n; ++i) c[i * ldc + m] = 0;
+			for (size_t j = 0; j < m; ++j) c[m * ldc + j] = 0;
+			gemm<_T>(m, n, 1, a, lda, b + m, ldb, c + m, ldc);
+			gemm<_T>(1, n, n, a + m * lda, lda, b, ldb, c + m * ldc, ldc);
+		}
+		// 2 LU decomposition with partial pivoting
+		// Factor the m*n matrix a in place into P*A = L*U, L unit lower triangular.
+		// Row k was swapped with row piv[k] at step k.
+		// Columns are processed in panels of NB; the trailing submatrix is
+		// updated with one gemm per panel. Returns the sign of P, or 0 if singular.
+		template <class _T> constexpr int luFactor(size_t m, size_t n, _T* a, size_t lda,
+			size_t* piv) noexcept {
+			const size_t r = m < n ? m : n;
+			const size_t NB = ::std::is_constant_evaluated() || r < 128 ? r : 64;
+			int sign = 1;
+			bool singular = false;
+			for (size_t k0 = 0; k0 < r; k0 += NB) {
+				const size_t kb = r - k0 < NB ? r - k0 : NB, k1 = k0 + kb;
+				for (size_t k = k0; k < k1; ++k) { //Unblocked factorization of the panel
+					size_t p = k;
+					for (size_t i = k + 1; i < m; ++i)
+						if (abs(a[p * lda + k]) < abs(a[i * lda + k])) p = i;
+					piv[k] = p;
+					if (p != k) {
+						sign = -sign;
+						for (size_t j = 0; j < n; ++j) swap(a[p * lda + j], a[k * lda + j]);
+					}
+					const _T d = a[k * lda + k];
+					if (!d) {
+						singular = true;
+						continue;
+					}
+					for (size_t i = k + 1; i < m; ++i) {
+						_T* row = a + i * lda;
+						const _T l = row[k] /= d;
+						for (size_t j = k + 1; j < k1; ++j) row[j] -= l * a[k * lda + j];
+					}
+				}
+				if (k1 == n) continue;
+				const auto upper = [=](size_t j0, size_t j1) { //U12 = inv(L11) * A12, by columns
+					for (size_t k = k0; k < k1; ++k)
+						for (size_t i = k + 1; i < k1; ++i) {
+							const _T l = a[i * lda + k];
+							for (size_t j = j0; j < j1; ++j) a[i * lda + j] -= l * a[k * lda + j];
+						}
+				};
+				if (::std::is_constant_evaluated() || (n - k1) * kb * kb < _MATHLAB_PARALLEL_GRAIN) upper(k1, n);
+				else parallelFor(k1, n, 256, upper);
+				if (k1 == m) continue;
+				if (::std::is_constant_evaluated()) { //A22 -= L21 * U12
+					for (size_t i = k1; i < m; ++i) for (size_t k = k0; k < k1; ++k) {
+						const _T l = a[i * lda + k];
+						for (size_t j = k1; j < n; ++j) a[i * lda + j] -= l * a[k * lda + j];
+					}
+				} else gemm<_T>(m - k1, kb, n - k1, a + k1 * lda + k0, lda,
+					a + k0 * lda + k1, lda, a + k1 * lda + k1, lda, _T(-1));
+			}
+			return singular ? 0 : sign;
+		}
+		// Solve A*X = B in place for an n*n matrix factored by luFactor; B is n*nrhs
+		template <class _T, class _S> constexpr void luSolve(size_t n, size_t nrhs,
+			const _T* lu, size_t lda, const size_t* piv, _S* b, size_t ldb) noexcept {
+			for (size_t k = 0; k < n; ++k) if (piv[k] != k)
+				for (size_t j = 0; j < nrhs; ++j) swap(b[k * ldb + j], b[piv[k] * ldb + j]);
+			for (size_t i = 1; i < n; ++i) { //Forward substitution with unit L
+				_S* x = b + i * ldb;
+				for (size_t k = 0; k < i; ++k) {
+					const _T l = lu[i * lda + k];
+					if (l) for (size_t j = 0; j < nrhs; ++j) x[j] -= l * b[k * ldb + j];
+				}
+			}
+			for (size_t i = n; i--; ) { //Back substitution with U
+				_S* x = b + i * ldb;
+				for (size_t k = i + 1; k < n; ++k) {
+					const _T u = lu[i * lda + k];
+					if (u) for (size_t j = 0; j < nrhs; ++j) x[j] -= u * b[k * ldb + j];
+				}
+				const _T d = lu[i * lda + i];
+				for (size_t j = 0; j < nrhs; ++j) x[j] /= d;
+			}
+		}
+		// Reduce the m*n matrix a in place to row echelon form with partial pivoting.
+		// Pivots no larger than tol count as zero. Returns the rank.
+		template <class _T, class _U> constexpr size_t rowEchelon(size_t m, size_t n, _T* a,
+			size_t lda, const _U& tol) noexcept {
+			size_t t = 0;
+			for (size_t k = 0; k < n && t < m; ++k) {
+				size_t p = t;
+				for (size_t i = t + 1; i < m; ++i) if (abs(a[p * lda + k]) < abs(a[i * lda + k])) p = i;
+				if (!(tol < abs(a[p * lda + k]))) continue;
+				if (p != t) for (size_t j = k; j < n; ++j) swap(a[p * lda + j], a[t * lda + j]);
+				for (size_t i = t + 1; i < m; ++i) {
+					const _T l = a[i * lda + k] / a[t * lda + k];
+					if (l) for (size_t j = k; j < n; ++j) a[i * lda + j] -= l * a[t * lda + j];
+				}
+				++t;
+			}
+			return t;
+		}
+		// 3 Cholesky and LDL^H factorizations of Hermitian matrices
+		// Only the lower triangle of a is read and overwritten. Columns are processed in
+		// panels of NB as in luFactor, but the trailing update covers only the block rows
+		// on and below the diagonal, so the work is about half that of LU.
+		// A22 -= L21 * D1 * L21^H for the panel k0..k1, D1 the panel's diagonal if scaled
+		template <class _T> void _trailingHerk(size_t n, size_t k0, size_t k1, size_t NB,
+			_T* a, size_t lda, bool scaled) noexcept {
+			const size_t kb = k1 - k0, m = n - k1;
+			_T* w = new _T[kb * m];
+			for (size_t p = 0; p < kb; ++p) {
+				const _T d = scaled ? a[(k0 + p) * lda + k0 + p] : _T(1);
+				for (size_t j = 0; j < m; ++j) w[p * m + j] = d * conj(a[(k1 + j) * lda + k0 + p]);
+			}
+			for (size_t i0 = k1; i0 < n; i0 += NB) {
+				const size_t i1 = n - i0 < NB ? n : i0 + NB;
+				gemm<_T>(i1 - i0, kb, i1 - k1, a + i0 * lda + k0, lda, w, m,
+					a + i0 * lda + k1, lda, _T(-1));
+			}
+			delete[] w;
+		}
+		// Factor A = L*L^H in place. Returns false if A is not positive definite.
+		template <class _T> constexpr bool cholFactor(size_t n, _T* a, size_t lda) noexcept {
+			const size_t NB = ::std::is_constant_evaluated() || n < 128 ? n : 64;
+			for (size_t k0 = 0; k0 < n; k0 += NB) {
+				const size_t k1 = n - k0 < NB ? n : k0 + NB;
+				for (size_t k = k0; k < k1; ++k) { //Unblocked factorization of the panel
+					const auto d = real(a[k * lda + k]);
+					if (!(0 < d)) return false;
+					const _T s = sqrt(d);
+					a[k * lda + k] = s;
+					for (size_t i = k + 1; i < n; ++i) {
+						_T* row = a + i * lda;
+						const _T l = row[k] /= s;
+						for (size_t j = k + 1, e = i < k1 ? i + 1 : k1; j < e; ++j)
+							row[j] -= l * conj(a[j * lda + k]);
+					}
+				}
+				if (k1 < n) _trailingHerk(n, k0, k1, NB, a, lda, false);
+			}
+			return true;
+		}
+		// Factor A = L*D*L^H in place, L unit lower triangular and D real diagonal.
+		// Needs no square roots and accepts indefinite A as long as no pivot vanishes.
+		// Returns false on a zero pivot.
+		template <class _T> constexpr bool ldlFactor(size_t n, _T* a, size_t lda) noexcept {
+			const size_t NB = ::std::is_constant_evaluated() || n < 128 ? n : 64;
+			for (size_t k0 = 0; k0 < n; k0 += NB) {
+				const size_t k1 = n - k0 < NB ? n : k0 + NB;
+				for (size_t k = k0; k < k1; ++k) { //Unblocked factorization of the panel
+					const _T d = real(a[k * lda + k]);
+					a[k * lda + k] = d;
+					if (!real(d)) return false;
+					for (size_t i = k + 1; i < n; ++i) {
+						_T* row = a + i * lda;
+						const _T t = row[k];
+						row[k] /= d;
+						for (size_t j = k + 1, e = i < k1 ? i + 1 : k1; j < e; ++j)
+							row[j] -= t * conj(a[j * lda + k]);
+					}
+				}
+				if (k1 < n) _trailingHerk(n, k0, k1, NB, a, lda, true);
+			}
+			return true;
+		}
+		// Rank-revealing Cholesky P^T*A*P = L*L^H of a positive semidefinite A in place.
+		// Step k brings the largest remaining diagonal entry to (k, k), swapping index k
+		// with piv[k]. Stops once that entry is no larger than tol, zeroes the remaining
+		// columns and returns the number of steps taken, the numerical rank.
+		template <class _T, class _U> constexpr size_t cholPivoted(size_t n, _T* a, size_t lda,
+			size_t* piv, const _U& tol) noexcept {
+			for (size_t k = 0; k < n; ++k) {
+				size_t p = k;
+				for (size_t i = k + 1; i < n; ++i)
+					if (real(a[p * lda + p]) < real(a[i * lda + i])) p = i;
+				if (!(tol < real(a[p * lda + p]))) {
+					for (size_t i = k; i < n; ++i) {
+						piv[i] = i;
+						for (size_t j = k; j <= i; ++j) a[i * lda + j] = 0;
+					}
+					return k;
+				}
+				piv[k] = p;
+				if (p != k) { //Symmetric swap within the lower triangle
+					for (size_t j = 0; j < k; ++j) swap(a[k * lda + j], a[p * lda + j]);
+					swap(a[k * lda + k], a[p * lda + p]);
+					for (size_t i = k + 1; i < p; ++i) {
+						const _T t = a[i * lda + k];
+						a[i * lda + k] = conj(a[p * lda + i]);
+						a[p * lda + i] = conj(t);
+					}
+					a[p * lda + k] = conj(a[p * lda + k]);
+					for (size_t i = p + 1; i < n; ++i) swap(a[i * lda + k], a[i * lda + p]);
+				}
+				const _T s = sqrt(real(a[k * lda + k]));
+				a[k * lda + k] = s;
+				for (size_t i = k + 1; i < n; ++i) {
+					_T* row = a + i * lda;
+					const _T l = row[k] /= s;
+					for (size_t j = k + 1; j <= i; ++j) row[j] -= l * conj(a[j * lda + k]);
+				}
+			}
+			return n;
+		}
+		// Solve A*X = B in place for A = L*L^H factored by cholFactor; B is n*nrhs
+		template <class _T, class _S> constexpr void cholSolve(size_t n, size_t nrhs,
+			const _T* l, size_t lda, _S* b, size_t ldb) noexcept {
+			for (size_t i = 0; i < n; ++i) { //Forward substitution with L
+				_S* x = b + i * ldb;
+				for (size_t k = 0; k < i; ++k) {
+					const _T t = l[i * lda + k];
+					for (size_t j = 0; j < nrhs; ++j) x[j] -= t * b[k * ldb + j];
+				}
+				const _T d = l[i * lda + i];
+				for (size_t j = 0; j < nrhs; ++j) x[j] /= d;
+			}
+			for (size_t i = n; i--; ) { //Back substitution with L^H
+				_S* x = b + i * ldb;
+				for (size_t k = i + 1; k < n; ++k) {
+					const _T t = conj(l[k * lda + i]);
+					for (size_t j = 0; j < nrhs; ++j) x[j] -= t * b[k * ldb + j];
+				}
+				const _T d = l[i * lda + i];
+				for (size_t j = 0; j < nrhs; ++j) x[j] /= d;
+			}
+		}
+		// Solve A*X = B in place for A = L*D*L^H factored by ldlFactor; B is n*nrhs
+		template <class _T, class _S> constexpr void ldlSolve(size_t n, size_t nrhs,
+			const _T* ld, size_t lda, _S* b, size_t ldb) noexcept {
+			for (size_t i = 1; i < n; ++i) { //Forward substitution with unit L
+				_S* x = b + i * ldb;
+				for (size_t k = 0; k < i; ++k) {
+					const _T t = ld[i * lda + k];
+					for (size_t j = 0; j < nrhs; ++j) x[j] -= t * b[k * ldb + j];
+				}
+			}
+			for (size_t i = n; i--; ) { //Scale by D, then back substitution with L^H
+				_S* x = b + i * ldb;
+				const _T d = ld[i * lda + i];
+				for (size_t j = 0; j < nrhs; ++j) x[j] /= d;
+				for (size_t k = i + 1; k < n; ++k) {
+					const _T t = conj(ld[k * lda + i]);
+					for (size_t j = 0; j < nrhs; ++j) x[j] -= t * b[k * ldb + j];
+				}
+			}
+		}
+		// 4 QR decomposition by Householder reflections
+		// Turn the n entries of x at stride incx into a reflector H = I - tau*v*v^H with
+		// H^H*x = beta*e1: beta overwrites x[0] and v[1..n) the rest, v[0] = 1 implied.
+		// Returns tau, 0 when x already has that form.
+		template <class _T> constexpr _T _householder(size_t n, _T* x, size_t incx) noexcept {
+			typedef decltype(real(_T())) _R;
+			_R big = 0;
+			for (size_t i = 1; i < n; ++i) if (big < abs(x[i * incx])) big = abs(x[i * incx]);
+			if (!big && !imag(x[0])) return 0;
+			const _T alpha = x[0];
+			if (big < abs(alpha)) big = abs(alpha);
+			_R s = 0; //Scaled by the largest entry against overflow
+			for (size_t i = 0; i < n; ++i) s += norm(x[i * incx] / big);
+			const _R beta = 0 <= real(alpha) ? -big * _R(sqrt(s)) : big * _R(sqrt(s));
+			const _T scale = _T(1) / (alpha - beta);
+			for (size_t i = 1; i < n; ++i) x[i * incx] *= scale;
+			x[0] = beta;
+			return (beta - alpha) / beta;
+		}
+		// C = (I - V*T*V^H)^H * C, the adjoint of the block reflector H_0*H_1*...*H_kb-1
+		// of one panel applied with three gemm calls, or C = (I - V*T*V^H) * C unless
+		// adjoint. V is mv*kb unit lower trapezoidal, stored below the diagonal of v; T is
+		// the kb*kb upper triangular factor of the compact WY form, built from tau. c is mv*nc.
+		template <class _T> void _blockReflect(size_t mv, size_t nc, size_t kb, const _T* v,
+			size_t ldv, const _T* tau, _T* c, size_t ldc, bool adjoint = true) noexcept {
+			_T* vm = new _T[mv * kb], * vh = new _T[kb * mv], * t = new _T[kb * kb];
+			_T* w = new _T[kb * (nc < kb ? kb : nc)];
+			for (size_t i = 0; i < mv; ++i) for (size_t p = 0; p < kb; ++p) {
+				const _T x = i < p ? _T(0) : i == p ? _T(1) : v[i * ldv + p];
+				vm[i * kb + p] = x;
+				vh[p * mv + i] = conj(x);
+			}
+			for (size_t p = 0; p < kb; ++p) { //T[0:p][p] = -tau[p] * T[0:p][0:p] * V[:, 0:p]^H * v_p
+				for (size_t q = 0; q < p; ++q) {
+					_T z = 0;
+					for (size_t i = p; i < mv; ++i) z += vh[q * mv + i] * conj(vh[p * mv + i]);
+					w[q] = z;
+				}
+				for (size_t q = 0; q < p; ++q) {
+					_T z = 0;
+					for (size_t s = q; s < p; ++s) z += t[q * kb + s] * w[s];
+					t[q * kb + p] = -tau[p] * z;
+				}
+				t[p * kb + p] = tau[p];
+				for (size_t q = p + 1; q < kb; ++q) t[q * kb + p] = 0;
+			}
+			for (size_t i = 0; i < kb * nc; ++i) w[i] = 0;
+			gemm<_T>(kb, mv, nc, vh, mv, c, ldc, w, nc); //W = V^H * C
+			if (adjoint) for (size_t p = kb; p--; ) { //W = T^H * W, bottom-up in place
+				_T* row = w + p * nc;
+				const _T d = conj(t[p * kb + p]);
+				for (size_t j = 0; j < nc; ++j) row[j] *= d;
+				for (size_t q = 0; q < p; ++q) {
+					const _T u = conj(t[q * kb + p]);
+					for (size_t j = 0; j < nc; ++j) row[j] += u * w[q * nc + j];
+				}
+			}
+			else for (size_t p = 0; p < kb; ++p) { //W = T * W, top-down in place
+				_T* row = w + p * nc;
+				const _T d = t[p * kb + p];
+				for (size_t j = 0; j < nc; ++j) row[j] *= d;
+				for (size_t q = p + 1; q < kb; ++q) {
+					const _T u = t[p * kb + q];
+					for (size_t j = 0; j < nc; ++j) row[j] += u * w[q * nc + j];
+				}
+			}
+			gemm<_T>(mv, kb, nc, vm, kb, w, nc, c, ldc, _T(-1)); //C -= V * W
+			delete[] vm;
+			delete[] vh;
+			delete[] t;
+			delete[] w;
+		}
+		// Factor the m*n matrix a in place into A = Q*R, Q = H_0*H_1*...*H_r-1 with
+		// r = min(m, n). R is left on and above the diagonal, the reflector vectors below
+		// it and their factors in tau[0..r). Panels of NB columns are reduced one column
+		// at a time; the trailing columns then take the whole panel at once through
+		// _blockReflect.
+		template <class _T> constexpr void qrFactor(size_t m, size_t n, _T* a, size_t lda,
+			_T* tau) noexcept {
+			const size_t r = m < n ? m : n;
+			const size_t NB = ::std::is_constant_evaluated() || r < 64 ? r : 32;
+			_T* w = new _T[n];
+			for (size_t k0 = 0; k0 < r; k0 += NB) {
+				const size_t k1 = r - k0 < NB ? r : k0 + NB, e = k1 == r ? n : k1;
+				for (size_t k = k0; k < k1; ++k) { //Unblocked reduction of the panel
+					_T* const akk = a + k * lda + k;
+					const _T t = tau[k] = _householder(m - k, akk, lda);
+					if (!t || k + 1 == e) continue;
+					const _T beta = *akk;
+					*akk = 1;
+					for (size_t j = k + 1; j < e; ++j) w[j] = 0;
+					for (size_t i = k; i < m; ++i) { //w = v^H * A
+						const _T* row = a + i * lda;
+						const _T v = conj(row[k]);
+						for (size_t j = k + 1; j < e; ++j) w[j] += v * row[j];
+					}
+					for (size_t i = k; i < m; ++i) { //A -= conj(tau) * v * w
+						_T* row = a + i * lda;
+						const _T v = conj(t) * row[k];
+						for (size_t j = k + 1; j < e; ++j) row[j] -= v * w[j];
+					}
+					*akk = beta;
+				}
+				if (e < n) _blockReflect(m - k0, n - e, k1 - k0, a + k0 * lda + k0, lda, tau + k0,
+					a + k0 * lda + e, lda);
+			}
+			delete[] w;
+		}
+		// B = Q^H*B if adjoint, else B = Q*B, for the Q of the first k reflectors of an
+		// m-row qrFactor; B is m*nrhs. Large problems go through _blockReflect in panels of
+		// 64 reflectors, first to last for Q^H and last to first for Q.
+		template <class _T, class _S> constexpr void qrMultiply(size_t m, size_t k, const _T* qr,
+			size_t lda, const _T* tau, _S* b, size_t ldb, size_t nrhs, bool adjoint) noexcept {
+			if constexpr (::std::is_same_v<_T, _S>) if (!::std::is_constant_evaluated() && k >= 64 && nrhs >= 32) {
+				const size_t NB = 64;
+				for (size_t s = 0; s < k; s += NB) {
+					const size_t p = adjoint ? s : (k - 1 - s) / NB * NB, kb = k - p < NB ? k - p : NB;
+					_blockReflect(m - p, nrhs, kb, qr + p * lda + p, lda, tau + p, b + p * ldb, ldb, adjoint);
+				}
+				return;
+			}
+			_S* w = new _S[nrhs];
+			for (size_t s = 0; s < k; ++s) {
+				const size_t p = adjoint ? s : k - 1 - s;
+				const _T t = adjoint ? conj(tau[p]) : tau[p];
+				if (!t) continue;
+				for (size_t j = 0; j < nrhs; ++j) w[j] = b[p * ldb + j];
+				for (size_t i = p + 1; i < m; ++i) {
+					const _T v = conj(qr[i * lda + p]);
+					for (size_t j = 0; j < nrhs; ++j) w[j] += v * b[i * ldb + j];
+				}
+				for (size_t j = 0; j < nrhs; ++j) b[p * ldb + j] -= t * w[j];
+				for (size_t i = p + 1; i < m; ++i) {
+					const _T v = t * qr[i * lda + p];
+					for (size_t j = 0; j < nrhs; ++j) b[i * ldb + j] -= v * w[j];
+				}
+			}
+			delete[] w;
+		}
+		// Least-squares solution of A*X = B for an m*n A, m >= n, factored by qrFactor.
+		// B is m*nrhs; its first n rows hold X on return.
+		template <class _T, class _S> constexpr void qrSolve(size_t m, size_t n, const _T* qr,
+			size_t lda, const _T* tau, _S* b, size_t ldb, size_t nrhs) noexcept {
+			qrMultiply(m, n, qr, lda, tau, b, ldb, nrhs, true);
+			for (size_t i = n; i--; ) { //Back substitution with R
+				_S* x = b + i * ldb;
+				for (size_t k = i + 1; k < n; ++k) {
+					const _T u = qr[i * lda + k];
+					for (size_t j = 0; j < nrhs; ++j) x[j] -= u * b[k * ldb + j];
+				}
+				const _T d = qr[i * lda + i];
+				for (size_t j = 0; j < nrhs; ++j) x[j] /= d;
+			}
+		}
+		// 5 Element-wise operations
+		// _Simd<_T> wraps one vector register of _T; width 1 means scalar only
+		template <class _T> struct _Simd {
+			static constexpr size_t width = 1;
+			static constexpr bool hasMul = false, hasDiv = false;
+		};
+		template <class _V> inline _V _simdNone(_V u, _V) noexcept { return u; }
+#define _MATHLAB_SIMD_TYPE(_T_, _V_, _P_, _LOAD_, _STORE_, _SET_, _ADD_, _SUB_, _MUL_, _HASMUL_, _DIV_, _HASDIV_) \
+		template <> struct _Simd<_T_> { \
+			typedef _V_ type; \
+			static constexpr size_t width = sizeof(_V_) / sizeof(_T_); \
+			static constexpr bool hasMul = _HASMUL_, hasDiv = _HASDIV_; \
+			static type load(const _T_* p) noexcept { return _LOAD_((const _P_*)p); } \
+			static void store(_T_* p, type v) noexcept { _STORE_((_P_*)p, v); } \
+			static type set(_T_ t) noexcept { return _SET_(t); } \
+			static type add(type u, type v) noexcept { return _ADD_(u, v); } \
+			static type sub(type u, type v) noexcept { return _SUB_(u, v); } \
+			static type mul(type u, type v) noexcept { return _MUL_(u, v); } \
+			static type div(type u, type v) noexcept { return _DIV_(u, v); } \
+		}
+#if _MATHLAB_SIMD >= 512
+#ifdef __AVX512DQ__
+#define _MATHLAB_MULLO64 _mm512_mullo_epi64, true
+#else
+#define _MATHLAB_MULLO64 _simdNone<__m512i>, false
+#endif
+#define _MATHLAB_SIMD_INT(_T_, _E_, _SET_, ...) _MATHLAB_SIMD_TYPE(_T_, __m512i, void, \
+		_mm512_loadu_si512, _mm512_storeu_si512, _SET_, _mm512_add_##_E_, _mm512_sub_##_E_, \
+		__VA_ARGS__, _simdNone<__m512i>, false)
+		_MATHLAB_SIMD_TYPE(float, __m512, float, _mm512_loadu_ps, _mm512_storeu_ps, _mm512_set1_ps,
+			_mm512_add_ps, _mm512_sub_ps, _mm512_mul_ps, true, _mm512_div_ps, true);
+		_MATHLAB_SIMD_TYPE(double, __m512d, double, _mm512_loadu_pd, _mm512_storeu_pd, _mm512_set1_pd,
+			_mm512_add_pd, _mm512_sub_pd, _mm512_mul_pd, true, _mm512_div_pd, true);
+		_MATHLAB_SIMD_INT(int32_t, epi32, _mm512_set1_epi32, _mm512_mullo_epi32, true);
+		_MATHLAB_SIMD_INT(uint32_t, epi32, _mm512_set1_epi32, _mm512_mullo_epi32, true);
+		_MATHLAB_SIMD_INT(int64_t, epi64, _mm512_set1_epi64, _MATHLAB_MULLO64);
+		_MATHLAB_SIMD_INT(uint64_t, epi64, _mm512_set1_epi64, _MATHLAB_MULLO64);
+#elif _MATHLAB_SIMD >= 256
+#define _MATHLAB_SIMD_INT(_T_, _E_, _SET_, ...) _MATHLAB_SIMD_TYPE(_T_, __m256i, __m256i, \
+		_mm256_loadu_si256, _mm256_storeu_si256, _SET_, _mm256_add_##_E_, _mm256_sub_##_E_, \
+		__VA_ARGS__, _simdNone<__m256i>, false)
+		_MATHLAB_SIMD_TYPE(float, __m256, float, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps,
+			_mm256_add_ps, _mm256_sub_ps, _mm256_mul_ps, true, _mm256_div_ps, true);
+		_MATHLAB_SIMD_TYPE(double, __m256d, double, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_set1_pd,
+			_mm256_add_pd, _mm256_sub_pd, _mm256_mul_pd, true, _mm256_div_pd, true);
+		_MATHLAB_SIMD_INT(int32_t, epi32, _mm256_set1_epi32, _mm256_mullo_epi32, true);
+		_MATHLAB_SIMD_INT(uint32_t, epi32, _mm256_set1_epi32, _mm256_mullo_epi32, true);
+		_MATHLAB_SIMD_INT(int64_t, epi64, _mm256_set1_epi64x, _simdNone<__m256i>, false);
+		_MATHLAB_SIMD_INT(uint64_t, epi64, _mm256_set1_epi64x, _simdNone<__m256i>, false);
+#elif _MATHLAB_SIMD >= 128
+#ifdef __SSE4_1__
+#define _MATHLAB_MULLO32 _mm_mullo_epi32, true
+#else
+#define _MATHLAB_MULLO32 _simdNone<__m128i>, false
+#endif
+#define _MATHLAB_SIMD_INT(_T_, _E_, _SET_, ...) _MATHLAB_SIMD_TYPE(_T_, __m128i, __m128i, \
+		_mm_loadu_si128, _mm_storeu_si128, _SET_, _mm_add_##_E_, _mm_sub_##_E_, \
+		__VA_ARGS__, _simdNone<__m128i>, false)
+		_MATHLAB_SIMD_TYPE(float, __m128, float, _mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps,
+			_mm_add_ps, _mm_sub_ps, _mm_mul_ps, true, _mm_div_ps, true);
+		_MATHLAB_SIMD_TYPE(double, __m128d, double, _mm_loadu_pd, _mm_storeu_pd, _mm_set1_pd,
+			_mm_add_pd, _mm_sub_pd, _mm_mul_pd, true, _mm_div_pd, true);
+		_MATHLAB_SIMD_INT(int32_t, epi32, _mm_set1_epi32, _MATHLAB_MULLO32);
+		_MATHLAB_SIMD_INT(uint32_t, epi32, _mm_set1_epi32, _MATHLAB_MULLO32);
+		_MATHLAB_SIMD_INT(int64_t, epi64, _mm_set1_epi64x, _simdNone<__m128i>, false);
+		_MATHLAB_SIMD_INT(uint64_t, epi64, _mm_set1_epi64x, _simdNone<__m128i>, false);
+#endif
+#undef _MATHLAB_SIMD_TYPE
+#undef _MATHLAB_SIMD_INT
+#undef _MATHLAB_MULLO32
+#undef _MATHLAB_MULLO64
+		template <class _T> concept Vectorizable = _Simd<_T>::width > 1;
+		// Whether a compound operation of _T with a scalar _S can run in _T lanes
+		template <class _T, class _S> concept VectorizableWith = Vectorizable<_T> &&
+			(SameAs<_T, _S> || ::std::is_floating_point_v<_T> && ::std::is_integral_v<_S>);
+		// d[i] += s[i]
+		template <class _T> inline void add(_T* d, const _T* s, size_t n) noexcept {
+			size_t i = 0;
+			if constexpr (Vectorizable<_T>) {
+				typedef _Simd<_T> _V;
+				for (; i + _V::width <= n; i += _V::width)
+					_V::store(d + i, _V::add(_V::load(d + i), _V::load(s + i)));
+			}
+			for (; i < n; ++i) d[i] += s[i];
+		}
+		// d[i] -= s[i]
+		template <class _T> inline void sub(_T* d, const _T* s, size_t n) noexcept {
+			size_t i = 0;
+			if constexpr (Vectorizable<_T>) {
+				typedef _Simd<_T> _V;
+				for (; i + _V::width <= n; i += _V::width)
+					_V::store(d + i, _V::sub(_V::load(d + i), _V::load(s + i)));
+			}
+			for (; i < n; ++i) d[i] -= s[i];
+		}
+		// d[i] *= t
+		template <class _T> inline void mul(_T* d, _T t, size_t n) noexcept {
+			size_t i = 0;
+			if constexpr (_Simd<_T>::hasMul) {
+				typedef _Simd<_T> _V;
+				const typename _V::type v = _V::set(t);
+				for (; i + _V::width <= n; i += _V::width)
+					_V::store(d + i, _V::mul(_V::load(d + i), v));
+			}
+			for (; i < n; ++i) d[i] *= t;
+		}
+		// d[i] /= t
+		template <class _T> inline void div(_T* d, _T t, size_t n) noexcept {
+			size_t i = 0;
+			if constexpr (_Simd<_T>::hasDiv) {
+				typedef _Simd<_T> _V;
+				const typename _V::type v = _V::set(t);
+				for (; i + _V::width <= n; i += _V::width)
+					_V::store(d + i, _V::div(_V::load(d + i), v));
+			}
+			for (; i < n; ++i) d[i] /= t;
+		}
+		// 6 Transposition
+		// b(n*m) = a(m*n)^T, conjugated if Conj. The longer side is halved until a block
+		// fits in a few cache lines, so reads and strided writes stay in cache at every
+		// level without a tuned tile size.
+		template <bool Conj = false, class _T, class _S> constexpr void transpose(size_t m, size_t n,
+			const _T* a, size_t lda, _S* b, size_t ldb) noexcept {
+			if (m * n <= 256) {
+				for (size_t i = 0; i < m; ++i) for (size_t j = 0; j < n; ++j)
+					if constexpr (Conj) b[j * ldb + i] = conj(a[i * lda + j]);
+					else b[j * ldb + i] = a[i * lda + j];
+			} else if (m >= n) {
+				transpose<Conj>(m / 2, n, a, lda, b, ldb);
+				transpose<Conj>(m - m / 2, n, a + m / 2 * lda, lda, b + m / 2, ldb);
+			} else {
+				transpose<Conj>(m, n / 2, a, lda, b, ldb);
+				transpose<Conj>(m, n - n / 2, a + n / 2, lda, b + n / 2 * ldb, ldb);
+			}
+		}
+		// Exchange x(m*n) with y(n*m)^T, both at leading dimension ld
+		template <bool Conj, class _T> constexpr void _transposeSwap(size_t m, size_t n,
+			_T* x, _T* y, size_t ld) noexcept {
+			if (m * n <= 256) {
+				for (size_t i = 0; i < m; ++i) for (size_t j = 0; j < n; ++j) {
+					const _T t = x[i * ld + j];
+					if constexpr (Conj) x[i * ld + j] = conj(y[j * ld + i]), y[j * ld + i] = conj(t);
+					else x[i * ld + j] = y[j * ld + i], y[j * ld + i] = t;
+				}
+			} else if (m >= n) {
+				_transposeSwap<Conj>(m / 2, n, x, y, ld);
+				_transposeSwap<Conj>(m - m / 2, n, x + m / 2 * ld, y + m / 2, ld);
+			} else {
+				_transposeSwap<Conj>(m, n / 2, x, y, ld);
+				_transposeSwap<Conj>(m, n - n / 2, x + n / 2, y + n / 2 * ld, ld);
+			}
+		}
+		// a(n*n) = a^T in place: the diagonal blocks recurse and the off-diagonal pair is
+		// exchanged across the diagonal
+		template <bool Conj = false, class _T> constexpr void transposeSquare(size_t n, _T* a,
+			size_t lda) noexcept {
+			if (n <= 16) {
+				for (size_t i = 0; i < n; ++i) {
+					for (size_t j = 0; j < i; ++j)
+						if constexpr (Conj) {
+							const _T t = a[i * lda + j];
+							a[i * lda + j] = conj(a[j * lda + i]), a[j * lda + i] = conj(t);
+						} else swap(a[i * lda + j], a[j * lda + i]);
+					if constexpr (Conj) a[i * lda + i] = conj(a[i * lda + i]);
+				}
+				return;
+			}
+			const size_t h = n / 2;
+			transposeSquare<Conj>(h, a, lda);
+			transposeSquare<Conj>(n - h, a + h * lda + h, lda);
+			_transposeSwap<Conj>(h, n - h, a + h, a + h * lda, lda);
+		}
+		// 7 Hermitian eigenproblem
+		// y = A*x for the Hermitian m*m matrix a, reading only its lower triangle, in one
+		// pass over the rows
+		template <class _T> constexpr void _hemvLower(size_t m, const _T* a, size_t lda, const _T* x,
+			_T* y) noexcept {
+			for (size_t i = 0; i < m; ++i) y[i] = 0;
+			size_t i = 0;
+			for (; i + 2 <= m; i += 2) { //Two rows per sweep over y, four partial sums each
+				const _T* r0 = a + i * lda, * r1 = r0 + lda;
+				const _T x0 = x[i], x1 = x[i + 1];
+				_T s0[4] = { 0, 0, 0, 0 }, s1[4] = { 0, 0, 0, 0 };
+				size_t j = 0;
+				for (; j + 4 <= i; j += 4) for (size_t q = 0; q < 4; ++q) {
+					s0[q] += r0[j + q] * x[j + q], s1[q] += r1[j + q] * x[j + q];
+					y[j + q] += conj(r0[j + q]) * x0 + conj(r1[j + q]) * x1;
+				}
+				for (; j < i; ++j) s0[0] += r0[j] * x[j], s1[0] += r1[j] * x[j], y[j] += conj(r0[j]) * x0 + conj(r1[j]) * x1;
+				y[i] += (s0[0] + s0[1]) + (s0[2] + s0[3]) + real(r0[i]) * x0 + conj(r1[i]) * x1;
+				y[i + 1] += (s1[0] + s1[1]) + (s1[2] + s1[3]) + r1[i] * x0 + real(r1[i + 1]) * x1;
+			}
+			if (i < m) {
+				const _T* row = a + i * lda;
+				_T s = 0;
+				for (size_t j = 0; j < i; ++j) s += row[j] * x[j], y[j] += conj(row[j]) * x[i];
+				y[i] += s + real(row[i]) * x[i];
+			}
+		}
+		// Reduce the Hermitian n*n matrix a, of which only the lower triangle is read, in
+		// place to real tridiagonal form T = Q^H*A*Q: the diagonal into d[0..n), the
+		// subdiagonal into e[0..n-1). Q = H_0*H_1*...*H_n-2 is kept as a qrFactor of the
+		// (n-1)*(n-1) block under the diagonal would keep it, the factors in tau[0..n-1);
+		// the strict upper triangle is left undefined. Panels of NB columns are reduced
+		// against the untouched trailing matrix, applying the pending update V*W^H + W*V^H
+		// of the panel column by column as LAPACK's latrd does; the trailing matrix then
+		// takes that update at once through gemm, so half the work runs at gemm speed.
+		template <class _T, class _R> constexpr void hermitianTridiagonal(size_t n, _T* a, size_t lda,
+			_R* d, _R* e, _T* tau) noexcept {
+			if (!n) return;
+			const size_t NB = ::std::is_constant_evaluated() || n < 128 ? 0 : 32;
+			_T* x = new _T[n], * y = new _T[n];
+			size_t k0 = 0;
+			if (NB) {
+				_T* w = new _T[n * NB], * vh = new _T[NB * n], * wh = new _T[NB * n];
+				for (; n - k0 > 2 * NB; k0 += NB) {
+					const size_t m = n - k0;
+					_T* const b = a + k0 * lda + k0;
+					for (size_t i = 0; i < NB; ++i) {
+						_T* const bi = b + i * lda;
+						for (size_t r = i; r < m; ++r) { //Bring column i up to date
+							const _T* br = b + r * lda, * wr = w + r * NB;
+							_T t = 0;
+							for (size_t p = 0; p < i; ++p) t += br[p] * conj(w[i * NB + p]) + wr[p] * conj(bi[p]);
+							b[r * lda + i] -= t;
+						}
+						d[k0 + i] = real(bi[i]);
+						_T* const v = bi + lda + i;
+						const size_t mv = m - i - 1;
+						const _T t = tau[k0 + i] = _householder(mv, v, lda);
+						e[k0 + i] = real(*v);
+						*v = 1;
+						for (size_t r = 0; r < mv; ++r) x[r] = v[r * lda];
+						_hemvLower(mv, v + 1, lda, x, y);
+						for (size_t p = 0; p < i; ++p) { //y -= V*(W^H*x) + W*(V^H*x)
+							_T s = 0, u = 0;
+							for (size_t r = 0; r < mv; ++r)
+								s += conj(w[(i + 1 + r) * NB + p]) * x[r], u += conj(b[(i + 1 + r) * lda + p]) * x[r];
+							for (size_t r = 0; r < mv; ++r)
+								y[r] -= b[(i + 1 + r) * lda + p] * s + w[(i + 1 + r) * NB + p] * u;
+						}
+						_T s = 0;
+						for (size_t r = 0; r < mv; ++r) y[r] *= t, s += conj(y[r]) * x[r];
+						const _T alpha = -t * s / 2;
+						for (size_t r = 0; r <= i; ++r) w[r * NB + i] = 0;
+						for (size_t r = 0; r < mv; ++r) w[(i + 1 + r) * NB + i] = y[r] + alpha * x[r];
+					}
+					const size_t mt = m - NB;
+					_T* const c = b + NB * lda + NB;
+					for (size_t r = 0; r < mt; ++r) for (size_t p = 0; p < NB; ++p)
+						vh[p * mt + r] = conj(b[(NB + r) * lda + p]), wh[p * mt + r] = conj(w[(NB + r) * NB + p]);
+					for (size_t r0 = 0; r0 < mt; r0 += 4 * NB) { //A22 -= V*W^H + W*V^H, lower block rows only
+						const size_t r1 = mt - r0 < 4 * NB ? mt : r0 + 4 * NB;
+						gemm<_T>(r1 - r0, NB, r1, b + (NB + r0) * lda, lda, wh, mt, c + r0 * lda, lda, _T(-1));
+						gemm<_T>(r1 - r0, NB, r1, w + (NB + r0) * NB, NB, vh, mt, c + r0 * lda, lda, _T(-1));
+					}
+					for (size_t r = 0; r < mt; ++r) c[r * lda + r] = real(c[r * lda + r]);
+					for (size_t i = 0; i < NB; ++i) b[(i + 1) * lda + i] = e[k0 + i];
+				}
+				delete[] w;
+				delete[] vh;
+				delete[] wh;
+			}
+			for (size_t k = k0; k + 1 < n; ++k) { //Unblocked: A22 -= v*w^H + w*v^H per column
+				_T* const v = a + (k + 1) * lda + k;
+				const size_t mv = n - k - 1;
+				d[k] = real(a[k * lda + k]);
+				const _T t = tau[k] = _householder(mv, v, lda);
+				e[k] = real(*v);
+				if (!t) continue;
+				*v = 1;
+				for (size_t r = 0; r < mv; ++r) x[r] = v[r * lda];
+				_hemvLower(mv, v + 1, lda, x, y);
+				_T s = 0;
+				for (size_t r = 0; r < mv; ++r) y[r] *= t, s += conj(y[r]) * x[r];
+				const _T alpha = -t * s / 2;
+				for (size_t r = 0; r < mv; ++r) y[r] += alpha * x[r];
+				for (size_t r = 0; r < mv; ++r) {
+					_T* row = v + r * lda + 1;
+					const _T xr = x[r], yr = y[r];
+					for (size_t j = 0; j <= r; ++j) row[j] -= xr * conj(y[j]) + yr * conj(x[j]);
+					row[r] = real(row[r]);
+				}
+				*v = e[k];
+			}
+			d[n - 1] = real(a[(n - 1) * lda + n - 1]);
+			delete[] x;
+			delete[] y;
+		}
+		// Eigenvalues of the symmetric tridiagonal matrix with diagonal d and subdiagonal
+		// e by implicit QL with Wilkinson shifts, into d in ascending order. The rotations
+		// are accumulated into the columns of the n*n z unless it is null.
+		template <class _R> constexpr void _tridiagonalQL(size_t n, _R* d, const _R* e0, _R* z,
+			size_t ldz) noexcept {
+			if (!n) return;
+			_R* e = new _R[n];
+			for (size_t i = 0; i + 1 < n; ++i) e[i] = e0[i];
+			e[n - 1] = 0;
+			const _R eps = Limits<_R>::epsilon();
+			for (size_t l = 0; l < n; ++l) for (size_t iter = 0; iter < 60; ++iter) {
+				size_t m = l;
+				while (m + 1 < n && abs(e[m]) > eps * (abs(d[m]) + abs(d[m + 1]))) ++m;
+				if (m == l) break;
+				_R g = (d[l + 1] - d[l]) / (2 * e[l]), r = hypot(g, _R(1));
+				g = d[m] - d[l] + e[l] / (g < 0 ? g - r : g + r);
+				_R s = 1, c = 1, p = 0;
+				bool underflow = false;
+				for (size_t i = m; i-- > l; ) {
+					_R f = s * e[i];
+					const _R b = c * e[i];
+					e[i + 1] = r = hypot(f, g);
+					if (!r) {
+						d[i + 1] -= p, e[m] = 0, underflow = true;
+						break;
+					}
+					s = f / r, c = g / r, g = d[i + 1] - p;
+					r = (d[i] - g) * s + 2 * c * b;
+					d[i + 1] = g + (p = s * r);
+					g = c * r - b;
+					if (z) for (size_t k = 0; k < n; ++k) {
+						_R* zk = z + k * ldz;
+						f = zk[i + 1], zk[i + 1] = s * zk[i] + c * f, zk[i] = c * zk[i] - s * f;
+					}
+				}
+				if (!underflow) d[l] -= p, e[l] = g, e[m] = 0;
+			}
+			delete[] e;
+			for (size_t i = 0; i + 1 < n; ++i) {
+				size_t k = i;
+				for (size_t j = i + 1; j < n; ++j) if (d[j] < d[k]) k = j;
+				if (k == i) continue;
+				swap(d[i], d[k]);
+				if (z) for (size_t r = 0; r < n; ++r) swap(z[r * ldz + i], z[r * ldz + k]);
+			}
+		}
+		// Root i of the secular equation 1 + rho * sum z_j^2 / (d_j - x) = 0, d ascending and
+		// rho > 0: in (d_i, d_i+1), or in (d_k-1, d_k-1 + rho*zz) for the last, zz = |z|^2.
+		// It is returned as d_o + tau for the nearer pole o, so that every d_j - x is formed
+		// as (d_j - d_o) - tau without cancellation. Newton steps, bisection when one leaves
+		// the bracket.
+		template <class _R> constexpr _R _secularRoot(size_t k, const _R* d, const _R* z, _R rho,
+			size_t i, _R zz, size_t& o) noexcept {
+			const _R eps = Limits<_R>::epsilon();
+			const auto f = [&](_R t, _R& df) {
+				_R s = 1;
+				df = 0;
+				for (size_t j = 0; j < k; ++j) {
+					const _R q = z[j] / ((d[j] - d[o]) - t);
+					s += rho * z[j] * q, df += rho * q * q;
+				}
+				return s;
+			};
+			_R lo = 0, hi = rho * zz, df;
+			o = i;
+			if (i + 1 < k) {
+				const _R g = (d[i + 1] - d[i]) / 2;
+				if (f(g, df) >= 0) hi = g;
+				else o = i + 1, lo = -g, hi = 0;
+			}
+			_R t = (lo + hi) / 2;
+			for (size_t it = 0; it < 200; ++it) {
+				const _R v = f(t, df);
+				if (!v) break;
+				(v < 0 ? lo : hi) = t;
+				_R u = t - v / df;
+				if (!(lo < u && u < hi)) u = (lo + hi) / 2;
+				const bool done = abs(u - t) <= 2 * eps * abs(u) || hi - lo <= 2 * eps * (abs(lo) + abs(hi));
+				t = u;
+				if (done) break;
+			}
+			return t;
+		}
+		// Merge step of divide and conquer: z holds blockdiag(Q1, Q2) for the halves of
+		// sizes m and n - m, whose eigenvalues are ascending in d[0..m) and d[m..n), and
+		// the problem is D + rho*u*u^H with u the last row of Q1 beside the first of Q2,
+		// negated if neg, over sqrt(2). Deflates tiny components of u and, through a Givens
+		// rotation, nearly equal eigenvalues (LAPACK's laed2); solves the secular equation
+		// for the rest and takes u from the computed roots (Gu and Eisenstat), so that the
+		// eigenvectors come out orthogonal however close the roots are.
+		template <class _R> void _tridiagonalMerge(size_t n, size_t m, _R* d, _R* z, size_t ldz,
+			_R rho, bool neg) noexcept {
+			const _R eps = Limits<_R>::epsilon(), h = _R(1) / _R(sqrt(_R(2)));
+			size_t* perm = new size_t[n], * kept = new size_t[n], * defl = new size_t[n], * org = new size_t[n];
+			unsigned char* half = new unsigned char[n]; //1 for a column of Q1, 2 of Q2, 3 if rotated into both
+			_R* ds = new _R[n], * zs = new _R[n], * q = new _R[n * n], * tau = new _R[n];
+			_R dmax = 0, zmax = 0;
+			for (size_t i = 0, j = m, k = 0; k < n; ++k) {
+				const size_t p = perm[k] = j == n || (i < m && d[i] <= d[j]) ? i++ : j++;
+				half[k] = p < m ? 1 : 2;
+				ds[k] = d[p], zs[k] = p < m ? h * z[(m - 1) * ldz + p] : (neg ? -h : h) * z[m * ldz + p];
+				if (dmax < abs(ds[k])) dmax = abs(ds[k]);
+				if (zmax < abs(zs[k])) zmax = abs(zs[k]);
+			}
+			for (size_t r = 0; r < n; ++r) for (size_t k = 0; k < n; ++k) q[r * n + k] = z[r * ldz + perm[k]];
+			const _R tol = 8 * eps * (dmax < rho * zmax ? rho * zmax : dmax);
+			size_t nk = 0, nd = 0, pj = n;
+			for (size_t j = 0; j < n; ++j) {
+				if (rho * abs(zs[j]) <= tol) {
+					defl[nd++] = j;
+					continue;
+				}
+				if (pj < n) {
+					const _R r = hypot(zs[j], zs[pj]), c = zs[j] / r, s = -zs[pj] / r;
+					if (abs((ds[j] - ds[pj]) * c * s) <= tol) {
+						zs[j] = r, zs[pj] = 0, half[j] = half[pj] = half[j] | half[pj];
+						for (size_t i = 0; i < n; ++i) {
+							_R* qi = q + i * n;
+							const _R x = qi[pj], y = qi[j];
+							qi[pj] = c * x + s * y, qi[j] = c * y - s * x;
+						}
+						const _R t = ds[pj] * c * c + ds[j] * s * s;
+						ds[j] = ds[pj] * s * s + ds[j] * c * c, ds[pj] = t;
+						defl[nd++] = pj;
+					} else kept[nk++] = pj;
+				}
+				pj = j;
+			}
+			if (pj < n) kept[nk++] = pj;
+			_R* dk = new _R[nk], * zk = new _R[nk], * u = new _R[nk * nk], * w = new _R[n * nk];
+			_R zz = 0;
+			for (size_t i = 0; i < nk; ++i) dk[i] = ds[kept[i]], zk[i] = zs[kept[i]], zz += zk[i] * zk[i];
+			for (size_t i = 0; i < nk; ++i) tau[i] = _secularRoot(nk, dk, zk, rho, i, zz, org[i]);
+			for (size_t i = 0; i < nk; ++i) { //|u_i|^2 = prod_j (x_j - d_i) / (rho * prod_j!=i (d_j - d_i))
+				_R p = (dk[org[nk - 1]] - dk[i] + tau[nk - 1]) / rho;
+				for (size_t j = 0; j < i; ++j) p *= (dk[org[j]] - dk[i] + tau[j]) / (dk[j] - dk[i]);
+				for (size_t j = i; j + 1 < nk; ++j) p *= (dk[org[j]] - dk[i] + tau[j]) / (dk[j + 1] - dk[i]);
+				zs[i] = zk[i] < 0 ? -_R(sqrt(abs(p))) : _R(sqrt(abs(p)));
+			}
+			for (size_t i = 0; i < nk; ++i) { //Eigenvector i of D + rho*u*u^H is (D - x_i)^-1 * u
+				_R s = 0;
+				for (size_t j = 0; j < nk; ++j) {
+					const _R t = zs[j] / ((dk[j] - dk[org[i]]) - tau[i]);
+					u[j * nk + i] = t, s += t * t;
+				}
+				s = _R(1) / _R(sqrt(s));
+				for (size_t j = 0; j < nk; ++j) u[j * nk + i] *= s;
+			}
+			_R* x = new _R[n * nk], * v = new _R[nk * nk];
+			for (size_t i = 0; i < n * nk; ++i) x[i] = 0;
+			for (unsigned char b = 1; b <= 2; ++b) { //X = Q*U by halves, skipping the zero blocks of Q
+				const size_t r0 = b == 1 ? 0 : m, r1 = b == 1 ? m : n;
+				size_t c = 0;
+				for (size_t j = 0; j < nk; ++j) if (half[kept[j]] & b) {
+					for (size_t r = r0; r < r1; ++r) w[(r - r0) * nk + c] = q[r * n + kept[j]];
+					for (size_t i = 0; i < nk; ++i) v[c * nk + i] = u[j * nk + i];
+					++c;
+				}
+				gemm<_R>(r1 - r0, c, nk, w, nk, v, nk, x + r0 * nk, nk);
+			}
+			for (size_t i = 1; i < nd; ++i) //Deflated values stay nearly sorted
+				for (size_t j = i; j && ds[defl[j]] < ds[defl[j - 1]]; --j) swap(defl[j], defl[j - 1]);
+			for (size_t a = 0, b = 0, k = 0; k < n; ++k)
+				if (b == nd || (a < nk && dk[org[a]] + tau[a] <= ds[defl[b]])) {
+					d[k] = dk[org[a]] + tau[a];
+					for (size_t r = 0; r < n; ++r) z[r * ldz + k] = x[r * nk + a];
+					++a;
+				} else {
+					d[k] = ds[defl[b]];
+					for (size_t r = 0; r < n; ++r) z[r * ldz + k] = q[r * n + defl[b]];
+					++b;
+				}
+			delete[] perm;
+			delete[] kept;
+			delete[] defl;
+			delete[] org;
+			delete[] half;
+			delete[] ds;
+			delete[] zs;
+			delete[] q;
+			delete[] tau;
+			delete[] dk;
+			delete[] zk;
+			delete[] u;
+			delete[] w;
+			delete[] x;
+			delete[] v;
+		}
+		// Cuppen's divide and conquer: T = blockdiag(T1, T2) + rho*v*v^T tearing at the
+		// middle subdiagonal entry, the halves solved recursively down to QL size
+		template <class _R> void _tridiagonalDC(size_t n, _R* d, const _R* e, _R* z, size_t ldz) noexcept {
+			if (n <= 25) {
+				for (size_t i = 0; i < n; ++i) for (size_t j = 0; j < n; ++j) z[i * ldz + j] = i == j;
+				_tridiagonalQL(n, d, e, z, ldz);
+				return;
+			}
+			const size_t m = n / 2;
+			const _R beta = e[m - 1], rho = abs(beta);
+			d[m - 1] -= rho, d[m] -= rho;
+			_tridiagonalDC(m, d, e, z, ldz);
+			_tridiagonalDC(n - m, d + m, e + m, z + m * ldz + m, ldz);
+			for (size_t i = 0; i < m; ++i) for (size_t j = m; j < n; ++j) z[i * ldz + j] = z[j * ldz + i] = 0;
+			_tridiagonalMerge(n, m, d, z, ldz, 2 * rho, beta < 0);
+		}
+		// Eigenvalues of the symmetric tridiagonal matrix with diagonal d and subdiagonal e
+		// into d, ascending. With z, the orthonormal eigenvectors go into the columns of
+		// the n*n z, by divide and conquer above 25 rows, else by QL.
+		template <class _R> constexpr void tridiagonalEigen(size_t n, _R* d, const _R* e, _R* z,
+			size_t ldz) noexcept {
+			if (z && n > 25 && !::std::is_constant_evaluated()) return _tridiagonalDC(n, d, e, z, ldz);
+			if (z) for (size_t i = 0; i < n; ++i) for (size_t j = 0; j < n; ++j) z[i * ldz + j] = i == j;
+			_tridiagonalQL(n, d, e, z, ldz);
+		}
+		// Eigenvalues of the Hermitian n*n matrix a into w[0..n), ascending. Only the lower
+		// triangle of a is read, and a is destroyed. With v, the orthonormal eigenvectors go
+		// into the columns of the n*n v: those of T, taken back through Q by qrMultiply.
+		template <class _T, class _R> constexpr void hermitianEigen(size_t n, _T* a, size_t lda, _R* w,
+			_T* v, size_t ldv) noexcept {
+			if (!n) return;
+			_R* e = new _R[n];
+			_T* tau = new _T[n];
+			hermitianTridiagonal(n, a, lda, w, e, tau);
+			if (v) {
+				_R* z = new _R[n * n];
+				tridiagonalEigen(n, w, e, z, n);
+				for (size_t i = 0; i < n; ++i) for (size_t j = 0; j < n; ++j) v[i * ldv + j] = z[i * n + j];
+				delete[] z;
+				qrMultiply(n - 1, n - 1, a + lda, lda, tau, v + ldv, ldv, n, false);
+			} else tridiagonalEigen(n, w, e, static_cast<_R*>(nullptr), 0);
+			delete[] e;
+			delete[] tau;
+		}
+		// 8 Nonsymmetric eigenproblem
+		// Scale rows and columns of the n*n matrix a by powers of 2 until their norms are
+		// comparable (Parlett and Reinsch). The similarity leaves the eigenvalues exact and
+		// makes them better conditioned for badly scaled a.
+		template <class _R> constexpr void _balance(size_t n, _R* a, size_t lda) noexcept {
+			for (bool done = false; !done; ) {
+				done = true;
+				for (size_t i = 0; i < n; ++i) {
+					_R c = 0, r = 0;
+					for (size_t j = 0; j < n; ++j) if (j != i) c += abs(a[j * lda + i]), r += abs(a[i * lda + j]);
+					if (!c || !r) continue;
+					const _R s = c + r;
+					_R f = 1, g = r / 2;
+					while (c < g) f *= 2, c *= 4;
+					for (g = r * 2; c > g; ) f /= 2, c /= 4;
+					if ((c + r) / f < _R(0.95) * s) {
+						done = false;
+						for (size_t j = 0; j < n; ++j) a[i * lda + j] /= f, a[j * lda + i] *= f;
+					}
+				}
+			}
+		}
+		// Reduce the n*n matrix a in place to upper Hessenberg form H = Q^H*A*Q, Q kept
+		// under the subdiagonal as in hermitianTridiagonal, the factors in tau[0..n-1)
+		template <class _T> constexpr void hessenberg(size_t n, _T* a, size_t lda, _T* tau) noexcept {
+			_T* x = new _T[n], * w = new _T[n];
+			for (size_t k = 0; k + 1 < n; ++k) {
+				_T* const v = a + (k + 1) * lda + k;
+				const size_t mv = n - k - 1;
+				const _T t = tau[k] = k + 2 < n ? _householder(mv, v, lda) : _T(0);
+				if (!t) continue;
+				x[0] = 1;
+				for (size_t i = 1; i < mv; ++i) x[i] = v[i * lda];
+				for (size_t j = k + 1; j < n; ++j) w[j] = 0;
+				for (size_t i = 0; i < mv; ++i) { //A = H^H*A: w = v^H*A, A -= conj(tau)*v*w
+					const _T* row = a + (k + 1 + i) * lda;
+					const _T u = conj(x[i]);
+					for (size_t j = k + 1; j < n; ++j) w[j] += u * row[j];
+				}
+				for (size_t i = 0; i < mv; ++i) {
+					_T* row = a + (k + 1 + i) * lda;
+					const _T u = conj(t) * x[i];
+					for (size_t j = k + 1; j < n; ++j) row[j] -= u * w[j];
+				}
+				for (size_t i = 0; i < n; ++i) { //A = A*H, row by row
+					_T* row = a + i * lda + k + 1;
+					_T s = 0;
+					for (size_t j = 0; j < mv; ++j) s += row[j] * x[j];
+					s *= t;
+					for (size_t j = 0; j < mv; ++j) row[j] -= s * conj(x[j]);
+				}
+			}
+			delete[] x;
+			delete[] w;
+		}
+		// Standardize the real 2*2 block [a b; c d] in place by the rotation [cs -sn; sn cs]:
+		// c = 0 when its eigenvalues are real, else a = d and b*c < 0 (LAPACK's lanv2)
+		template <class _R> constexpr void _schur2(_R& a, _R& b, _R& c, _R& d, _R& cs, _R& sn) noexcept {
+			cs = 1, sn = 0;
+			if (!c) return;
+			if (!b) {
+				cs = 0, sn = 1, b = -c, c = 0;
+				return swap(a, d);
+			}
+			if (a == d && (b < 0) != (c < 0)) return;
+			const _R temp = a - d, p = temp / 2, ab = abs(b), ac = abs(c);
+			const _R bcmax = ab < ac ? ac : ab, bcmis = (ab < ac ? ab : ac) * ((b < 0) != (c < 0) ? -1 : 1);
+			const _R scale = abs(p) < bcmax ? bcmax : abs(p), z = p / scale * p + bcmax / scale * bcmis;
+			if (z >= 4 * Limits<_R>::epsilon()) { //Real eigenvalues
+				const _R y = p + (p < 0 ? -1 : 1) * _R(sqrt(scale)) * _R(sqrt(z)), tau = hypot(c, y);
+				a = d + y, d -= bcmax / y * bcmis;
+				cs = y / tau, sn = c / tau, b -= c, c = 0;
+				return;
+			}
+			const _R sigma = b + c, tau = hypot(sigma, temp);
+			cs = sqrt((1 + abs(sigma) / tau) / 2), sn = -(p / (tau * cs)) * (sigma < 0 ? -1 : 1);
+			const _R aa = a * cs + b * sn, bb = b * cs - a * sn, cc = c * cs + d * sn, dd = d * cs - c * sn;
+			b = bb * cs + dd * sn, c = cc * cs - aa * sn;
+			a = d = (aa * cs + cc * sn + dd * cs - bb * sn) / 2;
+			if (!c) return;
+			if (!b) {
+				const _R t = cs;
+				b = -c, c = 0, cs = -sn, sn = t;
+			} else if ((b < 0) == (c < 0)) { //Real after all: split
+				const _R sab = sqrt(abs(b)), sac = sqrt(abs(c)), q = c < 0 ? -sab * sac : sab * sac;
+				const _R t = _R(1) / _R(sqrt(abs(b + c))), cs1 = sab * t, sn1 = sac * t, u = cs * cs1 - sn * sn1;
+				a += q, d -= q, b -= c, c = 0;
+				sn = cs * sn1 + sn * cs1, cs = u;
+			}
+		}
+		// Eigenvalues wr + i*wi of the n*n upper Hessenberg h by Francis double-shift QR,
+		// deflating with the conservative test of Ahues and Tisseur and with exceptional
+		// shifts every 10 stalled iterations, after LAPACK's lahqr. Entries under the
+		// subdiagonal must be zero. With z, h is reduced all the way to real Schur form
+		// and the transformations are accumulated into z, which holds Z^T so that they run
+		// along its rows; without, only the active window is updated. Returns false if some eigenvalue does not converge in
+		// 30*max(n, 10) iterations.
+		template <class _R> constexpr bool hessenbergQR(size_t n, _R* h, size_t ldh, _R* wr, _R* wi,
+			_R* z, size_t ldz) noexcept {
+			const ptrdiff_t N = n, itmax = 30 * (N < 10 ? 10 : N);
+			const _R ulp = Limits<_R>::epsilon(), smlnum = Limits<_R>::min() * (_R(n) / ulp);
+			const auto H = [=](ptrdiff_t r, ptrdiff_t c) -> _R& { return h[r * ldh + c]; };
+			const auto rotate = [](_R& x, _R& y, _R cs, _R sn) {
+				const _R t = cs * x + sn * y;
+				y = cs * y - sn * x, x = t;
+			};
+			ptrdiff_t kdefl = 0;
+			for (ptrdiff_t i = N - 1; i >= 0; ) {
+				ptrdiff_t l = 0, its = 0;
+				for (; its <= itmax; ++its) {
+					ptrdiff_t k = i;
+					for (; k > l; --k) { //Look for a negligible subdiagonal entry
+						const _R hk = abs(H(k, k - 1));
+						if (hk <= smlnum) break;
+						_R tst = abs(H(k - 1, k - 1)) + abs(H(k, k));
+						if (!tst) {
+							if (k - 2 >= l) tst += abs(H(k - 1, k - 2));
+							if (k + 1 <= i) tst += abs(H(k + 1, k));
+						}
+						if (hk <= ulp * tst) {
+							const _R hu = abs(H(k - 1, k)), ab = hk < hu ? hu : hk, ba = hk < hu ? hk : hu;
+							const _R hd = abs(H(k, k)), hm = abs(H(k - 1, k - 1) - H(k, k));
+							const _R aa = hd < hm ? hm : hd, bb = hd < hm ? hd : hm, s = aa + ab, e = ulp * (bb * (aa / s));
+							if (ba * (ab / s) <= (e < smlnum ? smlnum : e)) break;
+						}
+					}
+					l = k;
+					if (l > 0) H(l, l - 1) = 0;
+					if (l >= i - 1) break;
+					++kdefl;
+					const ptrdiff_t i1 = z ? 0 : l, i2 = z ? N - 1 : i;
+					_R h11, h12, h21, h22, rt1r, rt1i, rt2r, rt2i;
+					if (kdefl % 20 == 0) { //Exceptional shifts, from the bottom then from the top
+						const _R s = abs(H(i, i - 1)) + abs(H(i - 1, i - 2));
+						h11 = s * _R(0.75) + H(i, i), h12 = s * _R(-0.4375), h21 = s, h22 = h11;
+					} else if (kdefl % 10 == 0) {
+						const _R s = abs(H(l + 1, l)) + abs(H(l + 2, l + 1));
+						h11 = s * _R(0.75) + H(l, l), h12 = s * _R(-0.4375), h21 = s, h22 = h11;
+					} else h11 = H(i - 1, i - 1), h21 = H(i, i - 1), h12 = H(i - 1, i), h22 = H(i, i);
+					const _R s = abs(h11) + abs(h12) + abs(h21) + abs(h22);
+					if (!s) rt1r = rt1i = rt2r = rt2i = 0;
+					else { //The two eigenvalues of the trailing 2*2 block, or twice the nearer real one
+						h11 /= s, h12 /= s, h21 /= s, h22 /= s;
+						const _R tr = (h11 + h22) / 2, det = (h11 - tr) * (h22 - tr) - h12 * h21, rtdisc = det ? _R(sqrt(abs(det))) : _R(0);
+						if (det >= 0) rt1r = rt2r = tr * s, rt1i = rtdisc * s, rt2i = -rt1i;
+						else {
+							rt1r = tr + rtdisc, rt2r = tr - rtdisc;
+							rt1r = rt2r = (abs(rt1r - h22) <= abs(rt2r - h22) ? rt1r : rt2r) * s;
+							rt1i = rt2i = 0;
+						}
+					}
+					ptrdiff_t m = i - 2;
+					_R v[3];
+					for (;; --m) { //Start the bulge where two consecutive subdiagonals are small
+						const _R hs = abs(H(m, m) - rt2r) + abs(rt2i) + abs(H(m + 1, m)), h21s = H(m + 1, m) / hs;
+						v[0] = h21s * H(m, m + 1) + (H(m, m) - rt1r) * ((H(m, m) - rt2r) / hs) - rt1i * (rt2i / hs);
+						v[1] = h21s * (H(m, m) + H(m + 1, m + 1) - rt1r - rt2r);
+						v[2] = h21s * H(m + 2, m + 1);
+						const _R vs = abs(v[0]) + abs(v[1]) + abs(v[2]);
+						v[0] /= vs, v[1] /= vs, v[2] /= vs;
+						if (m == l) break;
+						const _R h00 = abs(H(m, m - 1)) * (abs(v[1]) + abs(v[2]));
+						const _R h01 = abs(v[0]) * (abs(H(m - 1, m - 1)) + abs(H(m, m)) + abs(H(m + 1, m + 1)));
+						if (h00 <= ulp * h01) break;
+					}
+					for (ptrdiff_t k = m; k < i; ++k) { //Chase the bulge down
+						const ptrdiff_t nr = i - k + 1 < 3 ? i - k + 1 : 3;
+						if (k > m) for (ptrdiff_t q = 0; q < nr; ++q) v[q] = H(k + q, k - 1);
+						const _R t1 = _householder(size_t(nr), v, 1), v2 = v[1], t2 = t1 * v2;
+						if (k > m) {
+							H(k, k - 1) = v[0], H(k + 1, k - 1) = 0;
+							if (k < i - 1) H(k + 2, k - 1) = 0;
+						} else if (m > l) H(k, k - 1) *= 1 - t1;
+						const _R v3 = nr == 3 ? v[2] : _R(0), t3 = t1 * v3;
+						for (ptrdiff_t j = k; j <= i2; ++j) {
+							const _R u = H(k, j) + v2 * H(k + 1, j) + (nr == 3 ? v3 * H(k + 2, j) : _R(0));
+							H(k, j) -= u * t1, H(k + 1, j) -= u * t2;
+							if (nr == 3) H(k + 2, j) -= u * t3;
+						}
+						for (ptrdiff_t j = i1, e = k + 3 < i ? k + 3 : i; j <= e; ++j) {
+							_R* r = h + j * ldh + k;
+							const _R u = r[0] + v2 * r[1] + (nr == 3 ? v3 * r[2] : _R(0));
+							r[0] -= u * t1, r[1] -= u * t2;
+							if (nr == 3) r[2] -= u * t3;
+						}
+						if (z) for (ptrdiff_t j = 0; j < N; ++j) {
+							_R* r = z + k * ldz + j;
+							const _R u = r[0] + v2 * r[ldz] + (nr == 3 ? v3 * r[2 * ldz] : _R(0));
+							r[0] -= u * t1, r[ldz] -= u * t2;
+							if (nr == 3) r[2 * ldz] -= u * t3;
+						}
+					}
+				}
+				if (its > itmax) return false;
+				if (l == i) wr[i] = H(i, i), wi[i] = 0;
+				else { //A 2*2 block: standardize it and carry its rotation through
+					_R cs, sn;
+					_schur2(H(i - 1, i - 1), H(i - 1, i), H(i, i - 1), H(i, i), cs, sn);
+					wr[i - 1] = H(i - 1, i - 1), wr[i] = H(i, i);
+					wi[i - 1] = wi[i] = 0;
+					if (H(i, i - 1)) wi[i - 1] = _R(sqrt(abs(H(i - 1, i)))) * _R(sqrt(abs(H(i, i - 1)))), wi[i] = -wi[i - 1];
+					if (z) {
+						for (ptrdiff_t j = i + 1; j < N; ++j) rotate(H(i - 1, j), H(i, j), cs, sn);
+						for (ptrdiff_t j = 0; j < i - 1; ++j) rotate(H(j, i - 1), H(j, i), cs, sn);
+						for (ptrdiff_t j = 0; j < N; ++j) rotate(z[(i - 1) * ldz + j], z[i * ldz + j], cs, sn);
+					}
+				}
+				kdefl = 0;
+				i = l - 1;
+			}
+			return true;
+		}
+		// Eigenvalues wr + i*wi of the real n*n matrix a, which is destroyed. With z, a
+		// becomes the real Schur form T and z the orthogonal Z with A = Z*T*Z^T; without,
+		// a is balanced first. Returns false if QR does not converge.
+		template <class _R> constexpr bool realSchur(size_t n, _R* a, size_t lda, _R* wr, _R* wi,
+			_R* z, size_t ldz) noexcept {
+			if (!n) return true;
+			if (!z) _balance(n, a, lda);
+			_R* tau = new _R[n];
+			hessenberg(n, a, lda, tau);
+			if (z) {
+				for (size_t i = 0; i < n; ++i) for (size_t j = 0; j < n; ++j) z[i * ldz + j] = i == j;
+				qrMultiply(n - 1, n - 1, a + lda, lda, tau, z + ldz, ldz, n, false);
+				transposeSquare(n, z, ldz);
+			}
+			delete[] tau;
+			for (size_t i = 2; i < n; ++i) for (size_t j = 0; j + 1 < i; ++j) a[i * lda + j] = 0;
+			const bool converged = hessenbergQR(n, a, lda, wr, wi, z, ldz);
+			if (z) transposeSquare(n, z, ldz);
+			return converged;
+		}
+		// 9 Singular value decomposition
+		// qrFactor with column pivoting: step k first swaps the remaining column of largest
+		// norm into place, recording it in piv[k]. Column norms are downdated, and
+		// recomputed once cancellation has eaten half their digits (LAPACK's geqpf).
+		template <class _T> constexpr void qrPivoted(size_t m, size_t n, _T* a, size_t lda, _T* tau,
+			size_t* piv) noexcept {
+			typedef decltype(real(_T())) _R;
+			const size_t r = m < n ? m : n;
+			const _R tol = sqrt(Limits<_R>::epsilon());
+			_R* vn = new _R[2 * n];
+			_T* w = new _T[n];
+			const auto norm = [=](size_t k, size_t j) {
+				_R t = 0;
+				for (size_t i = k; i < m; ++i) t += real(a[i * lda + j] * conj(a[i * lda + j]));
+				return t ? _R(sqrt(t)) : _R(0);
+			};
+			for (size_t j = 0; j < n; ++j) vn[j] = vn[n + j] = norm(0, j);
+			for (size_t k = 0; k < r; ++k) {
+				size_t p = k;
+				for (size_t j = k + 1; j < n; ++j) if (vn[p] < vn[j]) p = j;
+				piv[k] = p;
+				if (p != k) {
+					for (size_t i = 0; i < m; ++i) swap(a[i * lda + k], a[i * lda + p]);
+					swap(vn[k], vn[p]), swap(vn[n + k], vn[n + p]);
+				}
+				_T* const akk = a + k * lda + k;
+				const _T t = tau[k] = _householder(m - k, akk, lda);
+				if (t && k + 1 < n) {
+					const _T beta = *akk;
+					*akk = 1;
+					for (size_t j = k + 1; j < n; ++j) w[j] = 0;
+					for (size_t i = k; i < m; ++i) { //w = v^H * A
+						const _T* row = a + i * lda;
+						const _T v = conj(row[k]);
+						for (size_t j = k + 1; j < n; ++j) w[j] += v * row[j];
+					}
+					for (size_t i = k; i < m; ++i) { //A -= conj(tau) * v * w
+						_T* row = a + i * lda;
+						const _T v = conj(t) * row[k];
+						for (size_t j = k + 1; j < n; ++j) row[j] -= v * w[j];
+					}
+					*akk = beta;
+				}
+				for (size_t j = k + 1; j < n; ++j) if (vn[j]) {
+					_R q = abs(a[k * lda + j]) / vn[j];
+					q = q < 1 ? 1 - q * q : _R(0);
+					if (q * (vn[j] / vn[n + j]) * (vn[j] / vn[n + j]) <= tol) vn[j] = vn[n + j] = norm(k + 1, j);
+					else vn[j] *= _R(sqrt(q));
+				}
+			}
+			delete[] vn;
+			delete[] w;
+		}
+		// Orthogonalize the k rows of g, each of length l, by one-sided Jacobi rotations in
+		// cyclic sweeps, applying every rotation to the rows of w (k*k) as well if given.
+		// On return s holds the row norms in descending order, with the rows of g sorted
+		// to match and normalized, and each exactly zero row replaced by a unit vector
+		// orthogonal to the rows before it. Returns false if 60 sweeps do not converge.
+		template <class _T, class _R> constexpr bool _jacobiRows(size_t k, size_t l, _T* g, size_t ldg,
+			_T* w, size_t ldw, _R* s) noexcept {
+			const _R tol = Limits<_R>::epsilon() * _R(sqrt(_R(l)));
+			const auto dot = [=](size_t i, size_t j) { //Four partial sums hide the add latency
+				const _T* x = g + i * ldg, * y = g + j * ldg;
+				_T d[4] = { 0, 0, 0, 0 };
+				size_t q = 0;
+				for (; q + 4 <= l; q += 4) for (size_t h = 0; h < 4; ++h) d[h] += x[q + h] * conj(y[q + h]);
+				for (; q < l; ++q) d[0] += x[q] * conj(y[q]);
+				return (d[0] + d[1]) + (d[2] + d[3]);
+			};
+			const auto rotate = [](size_t n, _T* x, _T* y, _R cs, _R sn, _T e) {
+				for (size_t q = 0; q < n; ++q) {
+					const _T t = x[q], u = e * y[q];
+					x[q] = cs * t - sn * u, y[q] = sn * t + cs * u;
+				}
+			};
+			const auto sort = [=]() { //Selection sort by descending s
+				for (size_t i = 0; i < k; ++i) {
+					size_t p = i;
+					for (size_t j = i + 1; j < k; ++j) if (s[p] < s[j]) p = j;
+					if (p == i) continue;
+					swap(s[i], s[p]);
+					for (size_t q = 0; q < l; ++q) swap(g[i * ldg + q], g[p * ldg + q]);
+					if (w) for (size_t q = 0; q < k; ++q) swap(w[i * ldw + q], w[p * ldw + q]);
+				}
+			};
+			bool converged = false;
+			for (size_t sweep = 0; sweep < 60 && !converged; ++sweep) {
+				converged = true;
+				for (size_t i = 0; i < k; ++i) s[i] = real(dot(i, i));
+				sort(); //Largest rows first, which saves sweeps (de Rijk)
+				for (size_t i = 0; i + 1 < k; ++i) for (size_t j = i + 1; j < k; ++j) {
+					const _R a = s[i], b = s[j];
+					if (!a || !b) continue;
+					const _T c = dot(i, j);
+					const _R ac = abs(c);
+					if (ac <= tol * _R(sqrt(a)) * _R(sqrt(b))) continue;
+					converged = false;
+					//Rotate x and e*y, e the phase of c, by the smaller angle that makes them orthogonal
+					const _R zeta = (b - a) / (2 * ac), t = (zeta < 0 ? -1 : 1) / (abs(zeta) + _R(hypot(_R(1), zeta)));
+					const _R cs = 1 / _R(sqrt(1 + t * t)), sn = cs * t;
+					const _T e = c / ac;
+					rotate(l, g + i * ldg, g + j * ldg, cs, sn, e);
+					if (w) rotate(k, w + i * ldw, w + j * ldw, cs, sn, e);
+					s[i] = a - t * ac, s[j] = b + t * ac;
+				}
+			}
+			for (size_t i = 0; i < k; ++i) {
+				const _R a = real(dot(i, i));
+				s[i] = a ? _R(sqrt(a)) : _R(0);
+			}
+			sort();
+			for (size_t i = 0; i < k; ++i) {
+				_T* x = g + i * ldg;
+				if (s[i]) {
+					for (size_t q = 0; q < l; ++q) x[q] /= s[i];
+					continue;
+				}
+				//Some unit vector keeps at least the average (l - i)/l of its square norm
+				//once projected off the i orthonormal rows before it
+				for (size_t e = 0; e < l; ++e) {
+					for (size_t q = 0; q < l; ++q) x[q] = q == e;
+					for (size_t pass = 0; pass < 2; ++pass) for (size_t j = 0; j < i; ++j) {
+						const _T d = dot(i, j);
+						for (size_t q = 0; q < l; ++q) x[q] -= d * g[j * ldg + q];
+					}
+					const _R a = real(dot(i, i));
+					if (2 * a * l < l - i) continue;
+					for (size_t q = 0; q < l; ++q) x[q] /= _R(sqrt(a));
+					break;
+				}
+			}
+			return converged;
+		}
+		// Thin singular value decomposition A = U*diag(s)*V^H of the m*n matrix a, which is
+		// destroyed. With r = min(m, n), s gets the r singular values in descending order
+		// and u (m*r) and v (n*r), if given, the singular vectors as columns. A wide a goes
+		// through A^H. A tall one is reduced to R by column-pivoted QR first, and
+		// _jacobiRows works on the rows of R, which converges in far fewer sweeps than the
+		// columns of A (Drmac and Veselic) and finds even tiny singular values to high
+		// relative accuracy. Returns false if Jacobi does not converge.
+		template <class _T, class _R> constexpr bool svd(size_t m, size_t n, _T* a, size_t lda, _R* s,
+			_T* u, size_t ldu, _T* v, size_t ldv) noexcept {
+			if (!m || !n) return true;
+			if (m < n) {
+				_T* b = new _T[n * m];
+				transpose<true>(m, n, a, lda, b, m);
+				const bool converged = svd(n, m, b, m, s, v, ldv, u, ldu);
+				delete[] b;
+				return converged;
+			}
+			_T* tau = new _T[n], * tau2 = new _T[n], * r = new _T[n * n], * g = new _T[n * n];
+			_T* w = v ? new _T[n * n] : nullptr;
+			size_t* piv = new size_t[n];
+			qrPivoted(m, n, a, lda, tau, piv);
+			for (size_t i = 0; i < n; ++i) for (size_t j = 0; j < n; ++j) r[i * n + j] = j > i ? _T(0) : conj(a[j * lda + i]);
+			qrFactor(n, n, r, n, tau2);
+			for (size_t i = 0; i < n; ++i) for (size_t j = 0; j < n; ++j) {
+				g[i * n + j] = j < i ? _T(0) : r[i * n + j];
+				if (w) w[i * n + j] = i == j;
+			}
+			//A*P = Q*R and R^H = Q2*R2. With R2 = W^H*diag(s)*G, G the normalized rows,
+			//A = (Q*G^H)*diag(s)*(P*Q2*W^H)^H
+			const bool converged = _jacobiRows(n, n, g, n, w, n, s);
+			if (v) {
+				transpose<true>(n, n, w, n, v, ldv);
+				qrMultiply(n, n, r, n, tau2, v, ldv, n, false);
+				for (size_t k = n; k--; ) if (piv[k] != k)
+					for (size_t j = 0; j < n; ++j) swap(v[k * ldv + j], v[piv[k] * ldv + j]);
+			}
+			if (u) {
+				for (size_t i = 0; i < m; ++i) for (size_t j = 0; j < n; ++j)
+					u[i * ldu + j] = i < n ? conj(g[j * n + i]) : _T(0);
+				qrMultiply(m, n, a, lda, tau, u, ldu, n, false);
+			}
+			delete[] tau;
+			delete[] tau2;
+			delete[] r;
+			delete[] g;
+			delete[] w;
+			delete[] piv;
+			return converged;
+		}
+		// Singular values no larger than this count as zero unless a tolerance is given:
+		// max(m, n)*eps*s[0], as in LAPACK's and MATLAB's rank
+		template <class _R> constexpr _R svdTolerance(size_t m, size_t n, const _R* s) noexcept {
+			return m && n ? _R(m < n ? n : m) * Limits<_R>::epsilon() * s[0] : _R(0);
+		}
+		// Pseudo-inverse p(n*m) = V*diag(1/s)*U^H of the m*n matrix with thin SVD u, s, v,
+		// over the singular values above tol
+		template <class _T, class _R> constexpr void svdPinv(size_t m, size_t n, const _R* s,
+			const _T* u, size_t ldu, const _T* v, size_t ldv, _R tol, _T* p, size_t ldp) noexcept {
+			const size_t r = m < n ? m : n;
+			_T* uh = new _T[r * m];
+			transpose<true>(m, r, u, ldu, uh, m);
+			for (size_t i = 0; i < n; ++i) {
+				_T* row = p + i * ldp;
+				for (size_t j = 0; j < m; ++j) row[j] = 0;
+				for (size_t q = 0; q < r && tol < s[q]; ++q) {
+					const _T c = v[i * ldv + q] / s[q], * x = uh + q * m;
+					for (size_t j = 0; j < m; ++j) row[j] += c * x[j];
+				}
+			}
+			delete[] uh;
+		}
+		// 10 Closed forms for matrices up to 4*4
+		// Unrolled and branch-free, n fixed at compile time; _T may be any type with
+		// the arithmetic operators, a lane register included. The 4*4 forms share the
+		// six 2*2 minors of the top row pair and the six of the bottom one.
+		template <size_t N, class _T> constexpr _T determinant(const _T* a) noexcept {
+			static_assert(N >= 1 && N <= 4);
+			if constexpr (N == 1) return a[0];
+			else if constexpr (N == 2) return a[0] * a[3] - a[1] * a[2];
+			else if constexpr (N == 3)
+				return a[0] * (a[4] * a[8] - a[5] * a[7]) - a[1] * (a[3] * a[8] - a[5] * a[6])
+					+ a[2] * (a[3] * a[7] - a[4] * a[6]);
+			else {
+				const _T s0 = a[0] * a[5] - a[4] * a[1], s1 = a[0] * a[6] - a[4] * a[2], s2 = a[0] * a[7] - a[4] * a[3],
+					s3 = a[1] * a[6] - a[5] * a[2], s4 = a[1] * a[7] - a[5] * a[3], s5 = a[2] * a[7] - a[6] * a[3],
+					c0 = a[8] * a[13] - a[12] * a[9], c1 = a[8] * a[14] - a[12] * a[10], c2 = a[8] * a[15] - a[12] * a[11],
+					c3 = a[9] * a[14] - a[13] * a[10], c4 = a[9] * a[15] - a[13] * a[11], c5 = a[10] * a[15] - a[14] * a[11];
+				return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+			}
+		}
+		// b(n*n) = adj(a), returning det(a)
+		template <size_t N, class _T> constexpr _T adjugate(const _T* a, _T* b) noexcept {
+			static_assert(N >= 1 && N <= 4);
+			if constexpr (N == 1) {
+				b[0] = _T(1);
+				return a[0];
+			} else if constexpr (N == 2) {
+				b[0] = a[3], b[1] = -a[1], b[2] = -a[2], b[3] = a[0];
+				return a[0] * a[3] - a[1] * a[2];
+			} else if constexpr (N == 3) {
+				b[0] = a[4] * a[8] - a[5] * a[7], b[1] = a[2] * a[7] - a[1] * a[8], b[2] = a[1] * a[5] - a[2] * a[4];
+				b[3] = a[5] * a[6] - a[3] * a[8], b[4] = a[0] * a[8] - a[2] * a[6], b[5] = a[2] * a[3] - a[0] * a[5];
+				b[6] = a[3] * a[7] - a[4] * a[6], b[7] = a[1] * a[6] - a[0] * a[7], b[8] = a[0] * a[4] - a[1] * a[3];
+				return a[0] * b[0] + a[1] * b[3] + a[2] * b[6];
+			} else {
+				const _T s0 = a[0] * a[5] - a[4] * a[1], s1 = a[0] * a[6] - a[4] * a[2], s2 = a[0] * a[7] - a[4] * a[3],
+					s3 = a[1] * a[6] - a[5] * a[2], s4 = a[1] * a[7] - a[5] * a[3], s5 = a[2] * a[7] - a[6] * a[3],
+					c0 = a[8] * a[13] - a[12] * a[9], c1 = a[8] * a[14] - a[12] * a[10], c2 = a[8] * a[15] - a[12] * a[11],
+					c3 = a[9] * a[14] - a[13] * a[10], c4 = a[9] * a[15] - a[13] * a[11], c5 = a[10] * a[15] - a[14] * a[11];
+				b[0] = a[5] * c5 - a[6] * c4 + a[7] * c3, b[1] = a[2] * c4 - a[1] * c5 - a[3] * c3;
+				b[2] = a[13] * s5 - a[14] * s4 + a[15] * s3, b[3] = a[10] * s4 - a[9] * s5 - a[11] * s3;
+				b[4] = a[6] * c2 - a[4] * c5 - a[7] * c1, b[5] = a[0] * c5 - a[2] * c2 + a[3] * c1;
+				b[6] = a[14] * s2 - a[12] * s5 - a[15] * s1, b[7] = a[8] * s5 - a[10] * s2 + a[11] * s1;
+				b[8] = a[4] * c4 - a[5] * c2 + a[7] * c0, b[9] = a[1] * c2 - a[0] * c4 - a[3] * c0;
+				b[10] = a[12] * s4 - a[13] * s2 + a[15] * s0, b[11] = a[9] * s2 - a[8] * s4 - a[11] * s0;
+				b[12] = a[5] * c1 - a[4] * c3 - a[6] * c0, b[13] = a[0] * c3 - a[1] * c1 + a[2] * c0;
+				b[14] = a[13] * s1 - a[12] * s3 - a[14] * s0, b[15] = a[8] * s3 - a[9] * s1 + a[10] * s0;
+				return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+			}
+		}
+		// One 4*4 row in a register, for the types with a 4-lane register and shuffles:
+		// shuffle<x, y, z, w>(u, v) is (u[x], u[y], v[z], v[w])
+		template <class _T> struct _Quad {
+			static constexpr bool enabled = false;
+		};
+#if _MATHLAB_SIMD >= 128
+		template <> struct _Quad<float> {
+			typedef __m128 type;
+			static constexpr bool enabled = true;
+			static type load(const float* p) noexcept { return _mm_loadu_ps(p); }
+			static void store(float* p, type v) noexcept { _mm_storeu_ps(p, v); }
+			static type setr(float x, float y, float z, float w) noexcept { return _mm_setr_ps(x, y, z, w); }
+			static type add(type u, type v) noexcept { return _mm_add_ps(u, v); }
+			static type sub(type u, type v) noexcept { return _mm_sub_ps(u, v); }
+			static type mul(type u, type v) noexcept { return _mm_mul_ps(u, v); }
+			static type div(type u, type v) noexcept { return _mm_div_ps(u, v); }
+			template <int X, int Y, int Z, int W> static type shuffle(type u, type v) noexcept {
+				return _mm_shuffle_ps(u, v, X | Y << 2 | Z << 4 | W << 6);
+			}
+		};
+#endif
+#if _MATHLAB_SIMD >= 256 && defined(__AVX2__)
+		template <> struct _Quad<double> {
+			typedef __m256d type;
+			static constexpr bool enabled = true;
+			static type load(const double* p) noexcept { return _mm256_loadu_pd(p); }
+			static void store(double* p, type v) noexcept { _mm256_storeu_pd(p, v); }
+			static type setr(double x, double y, double z, double w) noexcept { return _mm256_setr_pd(x, y, z, w); }
+			static type add(type u, type v) noexcept { return _mm256_add_pd(u, v); }
+			static type sub(type u, type v) noexcept { return _mm256_sub_pd(u, v); }
+			static type mul(type u, type v) noexcept { return _mm256_mul_pd(u, v); }
+			static type div(type u, type v) noexcept { return _mm256_div_pd(u, v); }
+			template <int X, int Y, int Z, int W> static type shuffle(type u, type v) noexcept {
+				return _mm256_blend_pd(_mm256_permute4x64_pd(u, X | Y << 2 | X << 4 | Y << 6),
+					_mm256_permute4x64_pd(v, Z | W << 2 | Z << 4 | W << 6), 0xC);
+			}
+		};
+#endif
+		// Products of 2*2 blocks held row-major in one register: A*B, adj(A)*B, A*adj(B)
+		template <class _Q, class _V> inline _V _mul2(_V a, _V b) noexcept {
+			return _Q::add(_Q::mul(a, _Q::template shuffle<0, 3, 0, 3>(b, b)),
+				_Q::mul(_Q::template shuffle<1, 0, 3, 2>(a, a), _Q::template shuffle<2, 1, 2, 1>(b, b)));
+		}
+		template <class _Q, class _V> inline _V _adjMul2(_V a, _V b) noexcept {
+			return _Q::sub(_Q::mul(_Q::template shuffle<3, 3, 0, 0>(a, a), b),
+				_Q::mul(_Q::template shuffle<1, 1, 2, 2>(a, a), _Q::template shuffle<2, 3, 0, 1>(b, b)));
+		}
+		template <class _Q, class _V> inline _V _mulAdj2(_V a, _V b) noexcept {
+			return _Q::sub(_Q::mul(a, _Q::template shuffle<3, 0, 3, 0>(b, b)),
+				_Q::mul(_Q::template shuffle<1, 0, 3, 2>(a, a), _Q::template shuffle<2, 1, 2, 1>(b, b)));
+		}
+		// b(4*4) = a^-1 by blocks: with a = [A B; C D], the adjugate is assembled from
+		// |D|A - B*adj(D)*C and its three siblings, which share adj(A)*B and adj(D)*C,
+		// and |a| = |A||D| + |B||C| - tr(adj(A)*B*adj(D)*C). One register holds a 2*2
+		// block where _Quad<_T> exists; other types take the scalar adjugate.
+		template <class _T> inline void inverse4(const _T* a, _T* b) noexcept {
+			if constexpr (_Quad<_T>::enabled) {
+				typedef _Quad<_T> _Q;
+				typedef typename _Q::type _V;
+				const _V r0 = _Q::load(a), r1 = _Q::load(a + 4), r2 = _Q::load(a + 8), r3 = _Q::load(a + 12),
+					A = _Q::template shuffle<0, 1, 0, 1>(r0, r1), B = _Q::template shuffle<2, 3, 2, 3>(r0, r1),
+					C = _Q::template shuffle<0, 1, 0, 1>(r2, r3), D = _Q::template shuffle<2, 3, 2, 3>(r2, r3),
+					//(|A|, |B|, |C|, |D|)
+					d = _Q::sub(_Q::mul(_Q::template shuffle<0, 2, 0, 2>(r0, r2), _Q::template shuffle<1, 3, 1, 3>(r1, r3)),
+						_Q::mul(_Q::template shuffle<1, 3, 1, 3>(r0, r2), _Q::template shuffle<0, 2, 0, 2>(r1, r3))),
+					dA = _Q::template shuffle<0, 0, 0, 0>(d, d), dB = _Q::template shuffle<1, 1, 1, 1>(d, d),
+					dC = _Q::template shuffle<2, 2, 2, 2>(d, d), dD = _Q::template shuffle<3, 3, 3, 3>(d, d),
+					DC = _adjMul2<_Q>(D, C), AB = _adjMul2<_Q>(A, B),
+					X = _Q::sub(_Q::mul(dD, A), _mul2<_Q>(B, DC)), W = _Q::sub(_Q::mul(dA, D), _mul2<_Q>(C, AB)),
+					Y = _Q::sub(_Q::mul(dB, C), _mulAdj2<_Q>(D, AB)), Z = _Q::sub(_Q::mul(dC, B), _mulAdj2<_Q>(A, DC));
+				_V tr = _Q::mul(AB, _Q::template shuffle<0, 2, 1, 3>(DC, DC));
+				tr = _Q::add(tr, _Q::template shuffle<1, 0, 3, 2>(tr, tr));
+				tr = _Q::add(tr, _Q::template shuffle<2, 3, 0, 1>(tr, tr));
+				const _V det = _Q::sub(_Q::add(_Q::mul(dA, dD), _Q::mul(dB, dC)), tr),
+					r = _Q::div(_Q::setr(1, -1, -1, 1), det);
+				//adj of each block, placed transposed, and the rows interleaved in one shuffle
+				const _V x = _Q::mul(X, r), y = _Q::mul(Y, r), z = _Q::mul(Z, r), w = _Q::mul(W, r);
+				_Q::store(b, _Q::template shuffle<3, 1, 3, 1>(x, y));
+				_Q::store(b + 4, _Q::template shuffle<2, 0, 2, 0>(x, y));
+				_Q::store(b + 8, _Q::template shuffle<3, 1, 3, 1>(z, w));
+				_Q::store(b + 12, _Q::template shuffle<2, 0, 2, 0>(z, w));
+			} else {
+				const _T r = _T(1) / adjugate<4>(a, b);
+				for (size_t i = 0; i < 16; ++i) b[i] *= r;
+			}
+		}
+		// 11 Convolution
+		// z(nx+ny-1) = x(nx) * y(ny), the coefficient product of two polynomials stored
+		// constant term first. Schoolbook for short factors, Karatsuba in the middle range
+		// and for types without a transform; past an operation-count crossover, a complex
+		// FFT for floating types (rounding error relative to the largest output term) and
+		// NTTs modulo enough primes to make the result exact for built-in integers.
+		template <class _T> constexpr void _convolveDirect(const _T* x, size_t nx,
+			const _T* y, size_t ny, _T* z) {
+			for (size_t i = 0; i < nx + ny - 1; ++i) z[i] = _T(0);
+			for (size_t i = 0; i < nx; ++i) for (size_t j = 0; j < ny; ++j) z[i + j] += x[i] * y[j];
+		}
+		// z(2n-1) = x(n) * y(n) with three half-size products per level; w holds 4n+192
+		// elements of scratch
+		template <class _T> constexpr void _karatsuba(const _T* x, const _T* y, size_t n, _T* z, _T* w) {
+			if (n <= _MATHLAB_KARATSUBA) return _convolveDirect(x, n, y, n, z);
+			const size_t h = n / 2, k = n - h;
+			_karatsuba(x, y, h, z, w);                 //x0 * y0
+			z[2 * h - 1] = _T(0);
+			_karatsuba(x + h, y + h, k, z + 2 * h, w); //x1 * y1
+			_T* const sx = w, * const sy = w + k, * const m = w + 2 * k;
+			for (size_t i = 0; i < h; ++i) sx[i] = x[i] + x[h + i], sy[i] = y[i] + y[h + i];
+			if (k > h) sx[h] = x[n - 1], sy[h] = y[n - 1];
+			_karatsuba(sx, sy, k, m, m + 2 * k - 1);   //(x0 + x1) * (y0 + y1)
+			for (size_t i = 0; i < 2 * h - 1; ++i) m[i] -= z[i];
+			for (size_t i = 0; i < 2 * k - 1; ++i) m[i] -= z[2 * h + i];
+			for (size_t i = 0; i < 2 * k - 1; ++i) z[h + i] += m[i];
+		}
+		// Unbalanced factors go through Karatsuba in blocks of the shorter length
+		template <class _T> constexpr void _convolveKaratsuba(const _T* x, size_t nx,
+			const _T* y, size_t ny, _T* z) {
+			if (nx > ny) return _convolveKaratsuba(y, ny, x, nx, z);
+			if (nx <= _MATHLAB_KARATSUBA) return _convolveDirect(x, nx, y, ny, z);
+			_T* const w = new _T[6 * nx + 192], * const t = w + 4 * nx + 192;
+			for (size_t i = 0; i < nx + ny - 1; ++i) z[i] = _T(0);
+			size_t j = 0;
+			for (; j + nx <= ny; j += nx) {
+				_karatsuba(x, y + j, nx, t, w);
+				for (size_t i = 0; i < 2 * nx - 1; ++i) z[j + i] += t[i];
+			}
+			if (j < ny) {
+				_convolveKaratsuba(y + j, ny - j, x, nx, t);
+				for (size_t i = 0; i < nx + ny - j - 1; ++i) z[j + i] += t[i];
+			}
+			delete[] w;
+		}
+		// Runs f(i, j) over the n/2 butterflies of a radix-2 stage of span h: points i and
+		// i + h with twiddle j. Transforms of 2^17 points and more split stages across the pool.
+		template <class _F> inline void _butterflies(size_t n, size_t h, const _F& f) {
+			const auto run = [&](size_t t0, size_t t1) {
+				while (t0 < t1) {
+					const size_t j = t0 & (h - 1), i = 2 * t0 - j, l = t1 - t0 < h - j ? t1 - t0 : h - j;
+					for (size_t k = 0; k < l; ++k) f(i + k, j + k);
+					t0 += l;
+				}
+			};
+			if (n < 131072) run(0, n / 2);
+			else parallelFor(0, n / 2, 16384, run);
+		}
+		// In-place FFT of n = 2^k points split into real and imaginary parts, with the
+		// twiddles of span h at c[h + j] + i*s[h + j] = exp(pi*i*j/h), j < h, so that every
+		// stage reads them contiguously. Forward is decimation in frequency,
+		// natural order in and bit-reversed out with the exp(-...) kernel; Inverse undoes it
+		// by decimation in time without the 1/n factor. Pointwise products need no reordering.
+		template <bool Inverse, class _T> void _fft(size_t n, _T* re, _T* im, const _T* c, const _T* s) {
+			if (!Inverse) for (size_t h = n / 2; h; h /= 2)
+				_butterflies(n, h, [=](size_t i, size_t j) {
+					const _T ur = re[i], ui = im[i], vr = re[i + h], vi = im[i + h],
+						dr = ur - vr, di = ui - vi, wr = c[h + j], wi = s[h + j];
+					re[i] = ur + vr, im[i] = ui + vi;
+					re[i + h] = dr * wr + di * wi, im[i + h] = di * wr - dr * wi;
+				});
+			else for (size_t h = 1; h < n; h *= 2)
+				_butterflies(n, h, [=](size_t i, size_t j) {
+					const _T wr = c[h + j], wi = s[h + j], xr = re[i + h], xi = im[i + h],
+						vr = xr * wr - xi * wi, vi = xr * wi + xi * wr, ur = re[i], ui = im[i];
+					re[i] = ur + vr, im[i] = ui + vi;
+					re[i + h] = ur - vr, im[i + h] = ui - vi;
+				});
+		}
+		// The twiddles of _fft: for span n/2, sin and cos are taken on a coarse and a fine
+		// grid up to n/8 and combined by one rotation, the rest follows by symmetry; shorter
+		// spans take every other entry of the next one
+		template <class _T> void _twiddles(size_t n, _T* c, _T* s) {
+			const size_t e = n / 8, m = n / 2;
+			size_t b = 1;
+			while (b * b < e) b *= 2;
+			const size_t a = e / b + 1;
+			_T* const w = new _T[2 * (a + b)], * const cf = w, * const sf = w + b, * const cc = w + 2 * b, * const sc = cc + a;
+			const _T t = _T(2 * M_PI) / _T(n);
+			for (size_t j = 0; j < b; ++j) cf[j] = _T(cos(t * _T(j))), sf[j] = _T(sin(t * _T(j)));
+			for (size_t j = 0; j < a; ++j) cc[j] = _T(cos(t * _T(j * b))), sc[j] = _T(sin(t * _T(j * b)));
+			for (size_t j = 0; j <= e && j < m; ++j) {
+				const _T x = cc[j / b], y = sc[j / b], u = cf[j % b], v = sf[j % b];
+				c[m + j] = x * u - y * v, s[m + j] = y * u + x * v;
+			}
+			for (size_t j = e + 1; j <= m / 2 && j < m; ++j) c[m + j] = s[m + m / 2 - j], s[m + j] = c[m + m / 2 - j];
+			for (size_t j = m / 2 + 1; j < m; ++j) c[m + j] = -c[n - j], s[m + j] = s[n - j];
+			for (size_t h = m; h > 1; h /= 2) for (size_t j = 0; j < h / 2; ++j)
+				c[h / 2 + j] = c[h + 2 * j], s[h / 2 + j] = s[h + 2 * j];
+			delete[] w;
+		}
+		// Real factors share one transform as x + i*y; in bit-reversed order the entries of
+		// frequencies k and n - k sit mirrored inside each block [b, 2b)
+		template <class _T> void _convolveFFT(const _T* x, size_t nx, const _T* y, size_t ny, _T* z, size_t n) {
+			_T* const re = new _T[4 * n], * const im = re + n, * const c = im + n, * const s = c + n;
+			for (size_t i = 0; i < n; ++i) re[i] = i < nx ? x[i] : _T(0), im[i] = i < ny ? y[i] : _T(0);
+			_twiddles(n, c, s);
+			_fft<false>(n, re, im, c, s);
+			const _T f = _T(0.25) / _T(n);
+			re[0] *= im[0] * _T(4) * f, im[0] = 0;
+			if (n > 1) re[1] *= im[1] * _T(4) * f, im[1] = 0;
+			for (size_t b = 2; b < n; b *= 2) for (size_t p = b, q = 2 * b - 1; p < q; ++p, --q) {
+				//X = (Z[k] + conj(Z[n-k])) / 2, Y = (Z[k] - conj(Z[n-k])) / 2i, X*Y at k and its conjugate at n-k
+				const _T xr = re[p] + re[q], xi = im[p] - im[q], yr = im[p] + im[q], yi = re[q] - re[p],
+					pr = (xr * yr - xi * yi) * f, pi = (xr * yi + xi * yr) * f;
+				re[p] = pr, im[p] = pi, re[q] = pr, im[q] = -pi;
+			}
+			_fft<true>(n, re, im, c, s);
+			for (size_t i = 0; i < nx + ny - 1; ++i) z[i] = re[i];
+			delete[] re;
+		}
+		// Arithmetic modulo an odd p < 2^31 on Montgomery residues x * 2^32 mod p
+		struct _Montgomery {
+			uint32_t p, q, r2; //q = -1/p mod 2^32, r2 = 2^64 mod p
+			constexpr explicit _Montgomery(uint32_t p) noexcept : p(p), q(p), r2(uint32_t((~0ull % p + 1) % p)) {
+				for (size_t i = 0; i < 4; ++i) q *= 2 - p * q;
+				q = 0 - q;
+			}
+			constexpr uint32_t reduce(uint64_t t) const noexcept {
+				const uint32_t u = uint32_t((t + uint64_t(uint32_t(t) * q) * p) >> 32);
+				return u >= p ? u - p : u;
+			}
+			constexpr uint32_t mul(uint32_t a, uint32_t b) const noexcept { return reduce(uint64_t(a) * b); }
+			constexpr uint32_t add(uint32_t a, uint32_t b) const noexcept { return a + b >= p ? a + b - p : a + b; }
+			constexpr uint32_t sub(uint32_t a, uint32_t b) const noexcept { return a >= b ? a - b : a + p - b; }
+			constexpr uint32_t in(uint32_t a) const noexcept { return mul(a, r2); }
+			constexpr uint32_t pow(uint32_t a, uint64_t e) const noexcept {
+				uint32_t r = in(1);
+				for (; e; e >>= 1, a = mul(a, a)) if (e & 1) r = mul(r, a);
+				return r;
+			}
+		};
+		// Primes p = c*2^k + 1 with k >= 25, largest first, and a primitive root of each
+		inline constexpr uint32_t _nttPrimes[6][2] = { { 2113929217, 5 }, { 2013265921, 31 },
+			{ 1811939329, 13 }, { 1711276033, 29 }, { 1107296257, 10 }, { 469762049, 3 } };
+		// x(n) = x * y mod p, both transformed in place and x transformed back; values are
+		// Montgomery residues and n = 2^k divides p - 1
+		inline void _nttConvolve(const _Montgomery& m, uint32_t g, size_t n, uint32_t* x, uint32_t* y) {
+			uint32_t* const w = new uint32_t[2 * n], * const v = w + n;
+			const uint32_t r = m.pow(m.in(g), (m.p - 1) / n), one = m.in(1);
+			if (n > 1) w[n / 2] = v[n / 2] = one;
+			for (size_t j = 1; j < n / 2; ++j) w[n / 2 + j] = m.mul(w[n / 2 + j - 1], r);
+			for (size_t j = 1; j < n / 2; ++j) v[n / 2 + j] = m.sub(0, w[n - j]); //r^-j = -r^(n/2-j)
+			for (size_t h = n / 2; h > 1; h /= 2) for (size_t j = 0; j < h / 2; ++j)
+				w[h / 2 + j] = w[h + 2 * j], v[h / 2 + j] = v[h + 2 * j];
+			for (uint32_t* a : { x, y }) for (size_t h = n / 2; h; h /= 2)
+				_butterflies(n, h, [=](size_t i, size_t j) {
+					const uint32_t u = a[i], t = a[i + h];
+					a[i] = m.add(u, t), a[i + h] = m.mul(m.sub(u, t), w[h + j]);
+				});
+			//The 1/n of the inverse rides on the pointwise product
+			const uint32_t f = m.in(uint32_t(m.p - (m.p - 1) / n));
+			for (size_t i = 0; i < n; ++i) x[i] = m.mul(m.mul(x[i], y[i]), f);
+			for (size_t h = 1; h < n; h *= 2)
+				_butterflies(n, h, [=](size_t i, size_t j) {
+					const uint32_t u = x[i], t = m.mul(x[i + h], v[h + j]);
+					x[i] = m.add(u, t), x[i + h] = m.sub(u, t);
+				});
+			delete[] w;
+		}
+		// Residues modulo k primes, one transform pair per prime on the pool, then Garner's
+		// mixed-radix digits rebuild each coefficient mod 2^64; for signed types, digits above
+		// those of (P - 1) / 2 mean a negative value
+		template <class _T> void _convolveNTT(const _T* x, size_t nx, const _T* y, size_t ny,
+			_T* z, size_t n, size_t k) {
+			uint32_t* const r = new uint32_t[2 * k * n];
+			parallelFor(0, k, 1, [&](size_t i0, size_t i1) {
+				for (size_t i = i0; i < i1; ++i) {
+					const _Montgomery m(_nttPrimes[i][0]);
+					uint32_t* const a = r + 2 * i * n, * const b = a + n;
+					for (size_t j = 0; j < n; ++j) for (size_t l = 0; l < 2; ++l) {
+						const size_t nl = l ? ny : nx;
+						if (j >= nl) {
+							(l ? b : a)[j] = 0;
+							continue;
+						}
+						const _T t = (l ? y : x)[j];
+						const bool neg = t < _T(0);
+						const uint32_t u = uint32_t((neg ? 0 - uint64_t(t) : uint64_t(t)) % m.p);
+						(l ? b : a)[j] = m.in(neg && u ? m.p - u : u);
+					}
+					_nttConvolve(m, _nttPrimes[i][1], n, a, b);
+					for (size_t j = 0; j < nx + ny - 1; ++j) a[j] = m.reduce(a[j]);
+				}
+			});
+			uint64_t inv[6][6], mod = 1;
+			for (size_t i = 0; i < k; ++i) {
+				const _Montgomery m(_nttPrimes[i][0]);
+				for (size_t j = 0; j < i; ++j)
+					inv[i][j] = m.reduce(m.pow(m.in(_nttPrimes[j][0] % m.p), m.p - 2));
+				mod *= _nttPrimes[i][0];
+			}
+			parallelFor(0, nx + ny - 1, 65536, [&](size_t j0, size_t j1) {
+				for (size_t j = j0; j < j1; ++j) {
+					uint64_t d[6], v = 0, scale = 1;
+					int sign = 0;
+					for (size_t i = 0; i < k; ++i) {
+						const uint64_t p = _nttPrimes[i][0];
+						uint64_t t = r[2 * i * n + j];
+						for (size_t l = 0; l < i; ++l) t = (t + p - d[l] % p) * inv[i][l] % p;
+						d[i] = t, v += t * scale, scale *= p;
+					}
+					for (size_t i = k; ::std::is_signed_v<_T> && i-- && !sign;)
+						sign = d[i] < _nttPrimes[i][0] / 2 ? -1 : d[i] > _nttPrimes[i][0] / 2;
+					z[j] = _T(sign > 0 ? v - mod : v);
+				}
+			});
+			delete[] r;
+		}
+		template <class _T> constexpr void convolve(const _T* x, size_t nx, const _T* y, size_t ny, _T* z) {
+			const size_t lo = nx < ny ? nx : ny, hi = nx < ny ? ny : nx, l = nx + ny - 1;
+			if (::std::is_constant_evaluated() || lo <= _MATHLAB_KARATSUBA) return _convolveDirect(x, nx, y, ny, z);
+			//Multiplications of Karatsuba against butterfly work times the transform count
+			double kara = double((hi + lo - 1) / lo) * _MATHLAB_KARATSUBA * _MATHLAB_KARATSUBA;
+			for (size_t s = lo; s > _MATHLAB_KARATSUBA; s -= s / 2) kara *= 3;
+			size_t n = 1, lg = 0;
+			while (n < l) n *= 2, ++lg;
+			if constexpr (::std::is_floating_point_v<_T>) {
+				if (kara > 12. * double(n * lg)) return _convolveFFT(x, nx, y, ny, z, n);
+			} else if constexpr (::std::is_integral_v<_T> && !::std::is_same_v<_T, bool> && sizeof(_T) <= 8) {
+				//Primes until their product exceeds twice the largest possible |z[i]|
+				const auto width = [](const _T* a, size_t m) {
+					uint64_t t = 0;
+					for (size_t i = 0; i < m; ++i) t |= a[i] < _T(0) ? 0 - uint64_t(a[i]) : uint64_t(a[i]);
+					size_t b = 0;
+					for (; t; t >>= 1) ++b;
+					return b;
+				};
+				size_t bits = width(x, nx) + width(y, ny) + 2, k = 0;
+				for (size_t t = lo; t; t >>= 1) ++bits;
+				for (double b = 0; b < double(bits); ++k) b += 30. - double(k == 5);
+				if (n <= 33554432 && kara > 18. * double(k * n * lg)) return _convolveNTT(x, nx, y, ny, z, n, k);
+			}
+			_convolveKaratsuba(x, nx, y, ny, z);
+		}
+	}
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,323 @@
+#pragma once
+#ifndef _MATHLAB_KRYLOV_
+#define _MATHLAB_KRYLOV_ 1
+#include <time.h>
+#include "sparse.hpp"
+namespace Mathlab {
+	// 0 Operators and instrumentation
+	//A x for anything with a DynamicVector product (DynamicMatrix, SparseMatrix), or for a
+	//callable taking x when A is only available matrix-free
+	template <class _T, class _A> inline DynamicVector<_T> _applyOperator(const _A& a, const DynamicVector<_T>& x) {
+		if constexpr (requires { a(x); }) return DynamicVector<_T>(a(x));
+		else return DynamicVector<_T>(a * x);
+	}
+	inline double _wallSeconds() noexcept {
+		timespec t;
+		timespec_get(&t, TIME_UTC);
+		return t.tv_sec + t.tv_nsec * 1e-9;
+	}
+	struct KrylovOptions {
+		double tolerance = 1e-10; //Converged once |b - A x| <= tolerance * |b|
+		size_t maxIterations = 0; //0 for the dimension of the system
+		size_t restart = 30; //Size of the GMRES basis between restarts
+	};
+	//Outcome of a solve. residual is the true relative residual |b - A x| / |b| of x,
+	//seconds the wall time spent
+	template <class _T> struct KrylovResult {
+		DynamicVector<_T> x;
+		size_t iterations;
+		double residual, seconds;
+		bool converged;
+	};
+	struct _NoCallback {
+		constexpr void operator()(size_t, double, double) const noexcept {}
+	};
+	//Callback recording the residual and elapsed time of every iteration
+	class KrylovHistory {
+		DynamicVector<double> _res, _sec;
+		size_t _size = 0;
+	public:
+		void operator()(size_t, double residual, double seconds) {
+			if (_size == _res.size()) {
+				DynamicVector<double> r(_size ? 2 * _size : 64), s(r.size());
+				for (size_t k = 0; k < _size; ++k) r[k] = _res[k], s[k] = _sec[k];
+				_res = static_cast<DynamicVector<double>&&>(r), _sec = static_cast<DynamicVector<double>&&>(s);
+			}
+			_res[_size] = residual, _sec[_size++] = seconds;
+		}
+		size_t size() const noexcept { return _size; }
+		const double* residuals() const noexcept { return _res.data(); }
+		const double* seconds() const noexcept { return _sec.data(); }
+	};
+	//Calls cb(k, residual, seconds) after iteration k; true if it asks to stop, which a
+	//callback does by returning false
+	template <class _C> inline bool _report(_C& cb, size_t k, double residual, double t0) {
+		if constexpr (requires { !cb(k, residual, t0); })
+			return !cb(k, residual, _wallSeconds() - t0);
+		else return cb(k, residual, _wallSeconds() - t0), false;
+	}
+	template <class _T, class _A> inline DynamicVector<_T> _residual(const _A& a, const DynamicVector<_T>& b,
+		const DynamicVector<_T>& x) {
+		DynamicVector<_T> r = _applyOperator(a, x);
+		for (size_t i = 0; i < r.size(); ++i) r[i] = b[i] - r[i];
+		return r;
+	}
+	template <class _T, class _A> inline KrylovResult<_T> _finish(const _A& a, const DynamicVector<_T>& b,
+		DynamicVector<_T>& x, size_t k, double tol, double t0) {
+		const double nb = double(abs(b)), res = nb ? double(abs(_residual(a, b, x))) / nb : 0;
+		return { static_cast<DynamicVector<_T>&&>(x), k, res, _wallSeconds() - t0, res <= tol };
+	}
+	// 1 Preconditioners
+	//Each returns z with M z = r for an approximation M of A
+	struct IdentityPreconditioner {
+		template <class _T> constexpr DynamicVector<_T> operator()(const DynamicVector<_T>& r) const {
+			return r;
+		}
+	};
+	//Diagonal scaling
+	template <class _T = double> class JacobiPreconditioner {
+		DynamicVector<_T> _inv;
+	public:
+		template <class _A> explicit constexpr JacobiPreconditioner(const _A& a) : _inv(a.rows()) {
+			if (a.rows() != a.columns()) throw Error(EDOM, "Not a square matrix");
+			for (size_t i = 0; i < a.rows(); ++i) {
+				const _T d = a[{i, i}];
+				if (d == _T(0)) throw Error(EDOM, "Zero diagonal entry");
+				_inv[i] = _T(1) / d;
+			}
+		}
+		constexpr DynamicVector<_T> operator()(const DynamicVector<_T>& r) const {
+			DynamicVector<_T> z(r.size());
+			for (size_t i = 0; i < r.size(); ++i) z[i] = _inv[i] * r[i];
+			return z;
+		}
+	};
+	template <class _A> JacobiPreconditioner(const _A&) -> JacobiPreconditioner<typename _A::ValueType>;
+	//ILU(0): L (unit diagonal) and U share the sparsity pattern of A, stored together in
+	//CSR; each row i eliminates its entries left of the diagonal in ascending order,
+	//dropping fill outside the pattern
+	template <class _T = double> class IncompleteLU {
+		SparseMatrix<_T> _lu;
+		DynamicVector<size_t> _diag;
+	public:
+		template <class _S, SparseFormat F> explicit IncompleteLU(const SparseMatrix<_S, F>& a)
+			: _lu(a), _diag(a.rows()) {
+			if (a.rows() != a.columns()) throw Error(EDOM, "Not a square matrix");
+			const size_t n = a.rows(), * ptr = _lu.pointers(), * idx = _lu.indices();
+			_T* val = _lu.values();
+			DynamicVector<size_t> pos(n, size_t(-1));
+			for (size_t i = 0; i < n; ++i) {
+				for (size_t p = ptr[i]; p < ptr[i + 1]; ++p) pos[idx[p]] = p;
+				size_t p = ptr[i];
+				for (; p < ptr[i + 1] && idx[p] < i; ++p) {
+					const size_t k = idx[p];
+					val[p] /= val[_diag[k]];
+					for (size_t q = _diag[k] + 1; q < ptr[k + 1]; ++q)
+						if (pos[idx[q]] != size_t(-1)) val[pos[idx[q]]] -= val[p] * val[q];
+				}
+				if (p == ptr[i + 1] || idx[p] != i || val[p] == _T(0)) throw Error(EDOM, "Zero pivot");
+				_diag[i] = p;
+				for (size_t q = ptr[i]; q < ptr[i + 1]; ++q) pos[idx[q]] = size_t(-1);
+			}
+		}
+		template <class _S, bool C> explicit IncompleteLU(const DynamicMatrix<_S, C>& a)
+			: IncompleteLU(SparseMatrix<_S>(a)) {}
+		constexpr const SparseMatrix<_T>& packed() const noexcept { return _lu; }
+		constexpr DynamicVector<_T> operator()(const DynamicVector<_T>& r) const {
+			const size_t n = r.size(), * ptr = _lu.pointers(), * idx = _lu.indices();
+			const _T* val = _lu.values();
+			DynamicVector<_T> z(r);
+			for (size_t i = 0; i < n; ++i)
+				for (size_t p = ptr[i]; p < _diag[i]; ++p) z[i] -= val[p] * z[idx[p]];
+			for (size_t i = n; i-- > 0;) {
+				for (size_t p = _diag[i] + 1; p < ptr[i + 1]; ++p) z[i] -= val[p] * z[idx[p]];
+				z[i] /= val[_diag[i]];
+			}
+			return z;
+		}
+	};
+	template <class _S, SparseFormat F> IncompleteLU(const SparseMatrix<_S, F>&) -> IncompleteLU<_S>;
+	template <class _S, bool C> IncompleteLU(const DynamicMatrix<_S, C>&) -> IncompleteLU<_S>;
+	//IC(0) for Hermitian positive definite A: L L^H with L in the pattern of the lower
+	//triangle of A, stored in CSR with the diagonal last in each row
+	template <class _T = double> class IncompleteCholesky {
+		SparseMatrix<_T> _l;
+	public:
+		template <class _S, SparseFormat F> explicit IncompleteCholesky(const SparseMatrix<_S, F>& a) {
+			if (a.rows() != a.columns()) throw Error(EDOM, "Not a square matrix");
+			const SparseMatrix<_S> s(a);
+			const size_t n = a.rows(), * sp = s.pointers(), * si = s.indices();
+			DynamicVector<size_t> ptr(n + 1);
+			for (size_t i = 0; i < n; ++i) {
+				ptr[i + 1] = ptr[i];
+				for (size_t p = sp[i]; p < sp[i + 1] && si[p] <= i; ++p) ++ptr[i + 1];
+			}
+			DynamicVector<size_t> idx(ptr[n]);
+			DynamicVector<_T> val(ptr[n]);
+			for (size_t i = 0; i < n; ++i) {
+				for (size_t p = sp[i], q = ptr[i]; q < ptr[i + 1]; ++p, ++q) idx[q] = si[p], val[q] = s.values()[p];
+				if (ptr[i + 1] == ptr[i] || idx[ptr[i + 1] - 1] != i) throw Error(EDOM, "Not positive definite");
+				for (size_t p = ptr[i]; p < ptr[i + 1]; ++p) {
+					//L(i, k) -= sum over j < k of L(i, j) conj(L(k, j)), merging rows i and k
+					const size_t k = idx[p];
+					_T t = val[p];
+					for (size_t u = ptr[i], v = ptr[k]; u < p && v < ptr[k + 1] - 1;) {
+						if (idx[u] < idx[v]) ++u;
+						else if (idx[v] < idx[u]) ++v;
+						else t -= val[u++] * conj(val[v++]);
+					}
+					//The Hermitian pivot is real up to rounding in its imaginary part
+					if (k < i) val[p] = t / val[ptr[k + 1] - 1];
+					else if (real(t) > 0) val[p] = sqrt(real(t));
+					else throw Error(EDOM, "Not positive definite");
+				}
+			}
+			_l = SparseMatrix<_T>(n, n, static_cast<DynamicVector<size_t>&&>(ptr),
+				static_cast<DynamicVector<size_t>&&>(idx), static_cast<DynamicVector<_T>&&>(val));
+		}
+		template <class _S, bool C> explicit IncompleteCholesky(const DynamicMatrix<_S, C>& a)
+			: IncompleteCholesky(SparseMatrix<_S>(a)) {}
+		constexpr const SparseMatrix<_T>& lower() const noexcept { return _l; }
+		constexpr DynamicVector<_T> operator()(const DynamicVector<_T>& r) const {
+			const size_t n = r.size(), * ptr = _l.pointers(), * idx = _l.indices();
+			const _T* val = _l.values();
+			DynamicVector<_T> y(r);
+			for (size_t i = 0; i < n; ++i) {
+				for (size_t p = ptr[i]; p < ptr[i + 1] - 1; ++p) y[i] -= val[p] * y[idx[p]];
+				y[i] /= val[ptr[i + 1] - 1];
+			}
+			for (size_t i = n; i-- > 0;) { //L^H by columns: row i of L is column i of L^H
+				y[i] /= conj(val[ptr[i + 1] - 1]);
+				for (size_t p = ptr[i]; p < ptr[i + 1] - 1; ++p) y[idx[p]] -= conj(val[p]) * y[i];
+			}
+			return y;
+		}
+	};
+	template <class _S, SparseFormat F> IncompleteCholesky(const SparseMatrix<_S, F>&) -> IncompleteCholesky<_S>;
+	template <class _S, bool C> IncompleteCholesky(const DynamicMatrix<_S, C>&) -> IncompleteCholesky<_S>;
+	// 2 Solvers
+	//Each solves A x = b from x = 0 using only products with A and the preconditioner m,
+	//calling cb(k, residual, seconds) after every iteration k (see _report).
+	//Conjugate gradients, for Hermitian positive definite A and m
+	template <class _A, class _T, class _P = IdentityPreconditioner, class _C = _NoCallback>
+	KrylovResult<_T> cg(const _A& a, const DynamicVector<_T>& b, const _P& m = _P(),
+		const KrylovOptions& o = KrylovOptions(), _C&& cb = _C()) {
+		const double t0 = _wallSeconds(), nb = double(abs(b));
+		const size_t n = b.size(), kmax = o.maxIterations ? o.maxIterations : n;
+		DynamicVector<_T> x(n), r(b), z = m(r), p(z);
+		_T rz = z * r;
+		size_t k = 0;
+		if (nb) while (k < kmax) {
+			const DynamicVector<_T> q = _applyOperator(a, p);
+			const _T alpha = rz / (q * p);
+			_axpy(x, p, alpha), _axpy(r, q, -alpha);
+			const double res = double(abs(r)) / nb;
+			if (_report(cb, ++k, res, t0) || res <= o.tolerance) break;
+			z = m(r);
+			const _T rzNew = z * r, beta = rzNew / rz;
+			for (size_t i = 0; i < n; ++i) p[i] = z[i] + beta * p[i];
+			rz = rzNew;
+		}
+		return _finish(a, b, x, k, o.tolerance, t0);
+	}
+	//BiCGSTAB with right preconditioning, for general A; an iteration costs two products
+	template <class _A, class _T, class _P = IdentityPreconditioner, class _C = _NoCallback>
+	KrylovResult<_T> bicgstab(const _A& a, const DynamicVector<_T>& b, const _P& m = _P(),
+		const KrylovOptions& o = KrylovOptions(), _C&& cb = _C()) {
+		const double t0 = _wallSeconds(), nb = double(abs(b));
+		const size_t n = b.size(), kmax = o.maxIterations ? o.maxIterations : n;
+		DynamicVector<_T> x(n), r(b), rh(b), p(n), v(n);
+		_T rho = 1, alpha = 1, omega = 1;
+		size_t k = 0;
+		if (nb) while (k < kmax) {
+			const _T rhoNew = r * rh;
+			if (rhoNew == _T(0)) break; //Breakdown: r is orthogonal to the shadow residual
+			const _T beta = rhoNew / rho * (alpha / omega);
+			for (size_t i = 0; i < n; ++i) p[i] = r[i] + beta * (p[i] - omega * v[i]);
+			const DynamicVector<_T> ph = m(p);
+			v = _applyOperator(a, ph);
+			alpha = rhoNew / (v * rh);
+			_axpy(r, v, -alpha), _axpy(x, ph, alpha);
+			double res = double(abs(r)) / nb;
+			if (res > o.tolerance) {
+				const DynamicVector<_T> sh = m(r), t = _applyOperator(a, sh);
+				omega = (r * t) / (t * t);
+				_axpy(x, sh, omega), _axpy(r, t, -omega);
+				res = double(abs(r)) / nb;
+			}
+			rho = rhoNew;
+			if (res <= o.tolerance) {
+				//The recurred r drifts from b - A x after a large intermediate residual: confirm,
+				//and otherwise restart from the true residual
+				r = _residual(a, b, x), res = double(abs(r)) / nb;
+				if (res > o.tolerance) rh = r, p = v = DynamicVector<_T>(n), rho = alpha = omega = 1;
+			}
+			if (_report(cb, ++k, res, t0) || res <= o.tolerance || omega == _T(0)) break;
+		}
+		return _finish(a, b, x, k, o.tolerance, t0);
+	}
+	//GMRES(restart) with right preconditioning: Arnoldi by modified Gram-Schmidt, with the
+	//least-squares problem kept triangular by Givens rotations so that the residual of
+	//every iteration is known without forming x
+	template <class _A, class _T, class _P = IdentityPreconditioner, class _C = _NoCallback>
+	KrylovResult<_T> gmres(const _A& a, const DynamicVector<_T>& b, const _P& m = _P(),
+		const KrylovOptions& o = KrylovOptions(), _C&& cb = _C()) {
+		const double t0 = _wallSeconds(), nb = double(abs(b));
+		const size_t n = b.size(), kmax = o.maxIterations ? o.maxIterations : n;
+		const size_t rs = o.restart < 1 ? 1 : o.restart > n ? n : o.restart;
+		DynamicVector<_T> x(n), cs(rs), sn(rs), g(rs + 1), y(rs);
+		DynamicMatrix<_T> v(rs + 1, n), h(rs + 1, rs);
+		size_t k = 0;
+		bool done = !nb;
+		while (!done && k < kmax) {
+			const DynamicVector<_T> r = _residual(a, b, x);
+			const auto beta = abs(r);
+			if (double(beta) <= o.tolerance * nb) break;
+			for (size_t i = 0; i < n; ++i) v[0][i] = r[i] / beta;
+			for (size_t i = 1; i <= rs; ++i) g[i] = 0;
+			g[0] = beta;
+			size_t j = 0;
+			while (j < rs && k < kmax) {
+				DynamicVector<_T> w(n);
+				for (size_t i = 0; i < n; ++i) w[i] = v[j][i];
+				w = _applyOperator(a, m(w));
+				for (size_t i = 0; i <= j; ++i) {
+					_T t = 0;
+					for (size_t l = 0; l < n; ++l) t += w[l] * conj(v[i][l]);
+					h[i][j] = t;
+					for (size_t l = 0; l < n; ++l) w[l] -= t * v[i][l];
+				}
+				const auto hn = abs(w);
+				h[j + 1][j] = hn;
+				if (hn) for (size_t l = 0; l < n; ++l) v[j + 1][l] = w[l] / hn;
+				//Rotation i maps (h_i, h_i+1) to (conj(c) h_i + conj(s) h_i+1, c h_i+1 - s h_i), which
+				//is unitary for complex c and s with |c|^2 + |s|^2 = 1
+				for (size_t i = 0; i < j; ++i) {
+					const _T t = conj(cs[i]) * h[i][j] + conj(sn[i]) * h[i + 1][j];
+					h[i + 1][j] = cs[i] * h[i + 1][j] - sn[i] * h[i][j];
+					h[i][j] = t;
+				}
+				const auto d = hypot(abs(h[j][j]), abs(h[j + 1][j]));
+				cs[j] = h[j][j] / d, sn[j] = h[j + 1][j] / d;
+				h[j][j] = d, h[j + 1][j] = 0;
+				g[j + 1] = -sn[j] * g[j], g[j] = conj(cs[j]) * g[j];
+				const double res = double(abs(g[j + 1])) / nb;
+				++j;
+				if (_report(cb, ++k, res, t0) || res <= o.tolerance || !hn) {
+					done = true;
+					break;
+				}
+			}
+			for (size_t i = j; i-- > 0;) { //Back substitution with the rotated H, then x += M^-1 V y
+				_T t = g[i];
+				for (size_t l = i + 1; l < j; ++l) t -= h[i][l] * y[l];
+				y[i] = t / h[i][i];
+			}
+			DynamicVector<_T> u(n);
+			for (size_t i = 0; i < j; ++i) for (size_t l = 0; l < n; ++l) u[l] += y[i] * v[i][l];
+			x += m(u);
+		}
+		return _finish(a, b, x, k, o.tolerance, t0);
+	}
+}
+#endif
\ No newline at end of file
@@ -1,5 +1,5 @@
 #pragma once
-#include "matrix.hpp"
+#include "sparse.hpp"
 #ifndef _MATHLAB_LINPROG_
 #define _MATHLAB_LINPROG_ 1
 namespace Mathlab {
@@ -57,21 +57,1370 @@ namespace Mathlab {
 		for (i = 0; i < M; ++i) if (xm[i] < N) x[xm[i]] = bb[i];
 		return x;
 	}
-	template <RealArithmetic _T, RealArithmetic _U, RealArithmetic _V, size_t M, size_t N> constexpr Vector<CommonType<_T, _U, _V>, N>
-	integerProgram(const Matrix<_T, M, N>& a, const Vector<_U, M>& b, const Vector<_V, N>& c) noexcept {
-		//Part 1: Find solution in N-real space
-		typedef CommonType<_T, _U, _V, long double> _A;
-		Vector<_A, N> x = linearProgram(a, b, c);
-		size_t i = 0, j = 0, jj = -1, xm[M + N] = {0};
-		for (; j < N; ++j) if (x[j] != trunc(x[j])) break;
-		if (j == N) return x; else floor(x[jj = j]);
-		Matrix<_A, M + N, M + N> aa(a);
-		Vector<_A, M + N> bb(b), cc(c);
-		for (i = 0; i < M; ++i) aa[{i, xm[i] = N + i}] = 1;
-		for (j = 0; j < N; ++j) {//gather upper bound of each decision variable
-			Vector<_A, N> v = {0};
-			v[j] = 1; aa[{M + j, xm[M + j] = j}] = 1, bb[M + j] = linearProgram(a, b, v)[j];
+	// Maximize y=sum(c*x) assuming sum(a*x)<=b, x>=0 and x integer by branch and bound
+	// Return value: optimum x's as a Vector<X, N>, NaNs if there is none
+	template <RealArithmetic _T, RealArithmetic _U, RealArithmetic _V, size_t M, size_t N> Vector<Promoted<_T, _U, _V>, N>
+	integerProgram(const Matrix<_T, M, N>& a, const Vector<_U, M>& b, const Vector<_V, N>& c) {
+		typedef Promoted<_T, _U, _V> _A;
+		const DynamicVector<_A> x = integerProgram(DynamicMatrix<_A>(a), DynamicVector<_A>(b), DynamicVector<_A>(c));
+		Vector<_A, N> y;
+		for (size_t j = 0; j < N; ++j) y[j] = x[j];
+		return y;
+	}
+	// Revised simplex method for runtime-sized problems
+	enum class SimplexStatus { Optimal, Infeasible, Unbounded, IterationLimit };
+	struct SimplexOptions {
+		double feasibilityTolerance = 1e-9; //Largest bound violation left on a basic variable
+		double optimalityTolerance = 1e-9; //Largest reduced cost of the wrong sign
+		double pivotTolerance = 1e-7; //Smallest pivot the ratio tests accept
+		size_t maxIterations = 0; //0 for 20 * (rows + columns) + 10000
+		size_t refactor = 100; //Basis updates between two factorizations
+		bool steepestEdge = true; //Dual steepest-edge and primal Devex pricing, else Dantzig's rule
+	};
+	//Maximizes c*x over A*x - r = 0, lo <= (x, r) <= hi. Each row i has a logical variable
+	//r_i, so the row constraint lo_i <= a_i*x <= hi_i is a bound on r_i, and all n + m
+	//variables are boxed, possibly by infinities. The basis B is m columns of [A -I].
+	//Its logical columns are signed unit vectors, so only the bump, the structural basic
+	//columns restricted to the rows no basic logical covers, is factored, into triangular
+	//singletons around a sparse LU of what is left; each pivot then appends one
+	//product-form eta until the next factorization. A basis that is not primal feasible is
+	//made dual feasible by moving nonbasic variables to the bound their reduced costs ask
+	//for, inside an artificial box of half-width 1e7 where that bound is infinite, and
+	//goes to dual simplex; the primal method then lifts the boxes. The basis survives
+	//solve(), so a problem re-solved after changing bounds restarts from the last
+	//optimal basis.
+	template <RealArithmetic _T = double> class RevisedSimplex {
+		enum : unsigned char { _BASIC, _LOWER, _UPPER, _FREE };
+		static constexpr size_t _NONE = size_t(-1);
+		static constexpr _T _BOX = 1e7;
+		size_t _m, _n;
+		SparseMatrix<_T, SparseFormat::CSC> _a;
+		SparseMatrix<_T, SparseFormat::CSR> _ar;
+		SimplexOptions _opt;
+		//Per variable, structural ones first: cost of the equivalent minimization, bounds,
+		//value, reduced cost, Devex weight, state, and whether it rests on an artificial box
+		DynamicVector<_T> _cost, _lo, _up, _x, _d, _devex;
+		DynamicVector<unsigned char> _state, _box;
+		//Per basis position: basic variable and dual steepest-edge weight |e_p^T B^-1|^2
+		DynamicVector<size_t> _head;
+		DynamicVector<_T> _dse;
+		//Factorization as of the last refactor. _cover holds the basis position of the
+		//logical covering each row, or _NONE; the structural basics restricted to the other
+		//rows make the k*k bump. Peeling off row singletons gives a lower triangle solved
+		//first and peeling column singletons an upper triangle solved last; their pivots,
+		//as row, variable, basis position and value, lie in ftran order at [0, _lower) and
+		//[_upper, _k). The nucleus left between them has its rows and columns listed in
+		//_nuc*, columns by ascending count, and is factored column by column into sparse
+		//L and U: step c pivots column c on local row _nucPivot[c], L column c holds the
+		//multipliers of the rows still unpivoted then, U column c the entries above _uDiag[c]
+		DynamicVector<size_t> _cover, _triRow, _triVar, _triPos, _nucRow, _nucVar, _nucPos, _nucPivot;
+		DynamicVector<_T> _triVal, _uDiag;
+		size_t _k, _lower, _upper, _nk;
+		DynamicVector<size_t> _lStart, _lIdx, _uStart, _uIdx;
+		DynamicVector<_T> _lVal, _uVal;
+		//Workspace of the factorization: bump column of each variable, active entries left
+		//in each bump row and column, singletons waiting, and per local row of the nucleus
+		//its count, the step that pivoted it and the last column that touched it
+		DynamicVector<size_t> _varBump, _rowCount, _colCount, _stack, _nucCount, _rowStep, _mark;
+		//Eta file: pivot position and value of update e, its other entries at _ei/_ev
+		//from _es[e] to _es[e + 1]
+		DynamicVector<size_t> _ep, _es, _ei;
+		DynamicVector<_T> _epv, _ev;
+		size_t _etas;
+		//Scratch: a column in rows, its ftran in positions, a btran row in rows, a pivot
+		//row over all variables, and three more of length m
+		DynamicVector<_T> _col, _alpha, _rho, _row, _t, _u, _z;
+		SimplexStatus _status;
+		size_t _iter;
+		bool _factored, _valued;
+		void _grow(DynamicVector<size_t>& i, DynamicVector<_T>& v, size_t need) {
+			if (need <= v.size()) return;
+			const size_t cap = need < 2 * v.size() ? 2 * v.size() : need + 16;
+			DynamicVector<size_t> j(cap);
+			DynamicVector<_T> w(cap);
+			for (size_t k = 0; k < v.size(); ++k) j[k] = i[k], w[k] = v[k];
+			i = static_cast<DynamicVector<size_t>&&>(j), v = static_cast<DynamicVector<_T>&&>(w);
+		}
+		template <class _V> static void _extend(DynamicVector<_V>& v, size_t n, _V fill) {
+			DynamicVector<_V> w(n, fill);
+			for (size_t k = 0; k < v.size() && k < n; ++k) w[k] = v[k];
+			v = static_cast<DynamicVector<_V>&&>(w);
+		}
+		//Sizes the scratch and factorization arrays that go with the row count
+		void _workspace() {
+			_cover = _triRow = _triVar = _triPos = _nucRow = _nucVar = _nucPos = _nucPivot = DynamicVector<size_t>(_m);
+			_rowCount = _colCount = _stack = _nucCount = _rowStep = _mark = DynamicVector<size_t>(_m);
+			_lStart = _uStart = DynamicVector<size_t>(_m + 1);
+			_triVal = _uDiag = _col = _alpha = _rho = _t = _u = _z = DynamicVector<_T>(_m);
+			_row = DynamicVector<_T>(_n + _m);
+		}
+		bool _movable(size_t j) const noexcept { return _lo[j] < _up[j]; }
+		//Puts nonbasic x_j on the bound its state names, or on the nearest finite one
+		void _place(size_t j) {
+			const _T inf = infinity<_T>(), x = _x[j];
+			_box[j] = 0;
+			if (_state[j] == _FREE && _lo[j] < x && x < _up[j]) return;
+			if (_state[j] == _LOWER && _lo[j] > -inf || _state[j] != _UPPER && x <= _lo[j]) _x[j] = _lo[j], _state[j] = _LOWER;
+			else if (_state[j] == _UPPER && _up[j] < inf || _up[j] <= x) _x[j] = _up[j], _state[j] = _UPPER;
+			else if (_lo[j] > -inf) _x[j] = _lo[j], _state[j] = _LOWER;
+			else if (_up[j] < inf) _x[j] = _up[j], _state[j] = _UPPER;
+			else _state[j] = _FREE;
+			if (_x[j] != x) _valued = false;
+		}
+		//Column j of [A -I] into _col
+		void _column(size_t j) {
+			for (size_t i = 0; i < _m; ++i) _col[i] = 0;
+			if (j >= _n) _col[j - _n] = -1;
+			else for (size_t p = _a.pointers()[j]; p < _a.pointers()[j + 1]; ++p)
+				_col[_a.indices()[p]] = _a.values()[p];
+		}
+		void _eliminate(_T* s, size_t j, _T t) const noexcept {
+			const size_t* ptr = _a.pointers(), * idx = _a.indices();
+			const _T* val = _a.values();
+			for (size_t p = ptr[j]; p < ptr[j + 1]; ++p) s[idx[p]] -= val[p] * t;
+		}
+		_T _dot(const _T* y, size_t j) const noexcept {
+			const size_t* ptr = _a.pointers(), * idx = _a.indices();
+			const _T* val = _a.values();
+			_T t = 0;
+			for (size_t p = ptr[j]; p < ptr[j + 1]; ++p) t += val[p] * y[idx[p]];
+			return t;
+		}
+		//w = B^-1 v, v indexed by rows and w by basis positions. Solved columns are taken
+		//out of the whole of v, so a row covered by a logical ends up with v_i - a_i*x_bump,
+		//the negated value of its logical
+		void _ftran(const _T* v, _T* w) {
+			_T* s = _u.data(), * t = _t.data();
+			for (size_t i = 0; i < _m; ++i) s[i] = v[i];
+			const auto pivot = [&](size_t k) {
+				const _T x = s[_triRow[k]] / _triVal[k];
+				w[_triPos[k]] = x;
+				if (x) _eliminate(s, _triVar[k], x);
+			};
+			for (size_t k = 0; k < _lower; ++k) pivot(k);
+			if (_nk) { //L forward over local rows, then U backward over steps
+				_T* z = _z.data();
+				for (size_t r = 0; r < _nk; ++r) t[r] = s[_nucRow[r]];
+				for (size_t c = 0; c < _nk; ++c) if (const _T x = z[c] = t[_nucPivot[c]])
+					for (size_t p = _lStart[c]; p < _lStart[c + 1]; ++p) t[_lIdx[p]] -= _lVal[p] * x;
+				for (size_t c = _nk; c--; ) if (const _T x = z[c] /= _uDiag[c]) {
+					for (size_t p = _uStart[c]; p < _uStart[c + 1]; ++p) z[_uIdx[p]] -= _uVal[p] * x;
+					_eliminate(s, _nucVar[c], x);
+				}
+				for (size_t c = 0; c < _nk; ++c) w[_nucPos[c]] = z[c];
+			}
+			for (size_t k = _upper; k < _k; ++k) pivot(k);
+			for (size_t i = 0; i < _m; ++i) if (_cover[i] != _NONE) w[_cover[i]] = -s[i];
+			for (size_t e = 0; e < _etas; ++e) {
+				const size_t r = _ep[e];
+				const _T x = w[r] /= _epv[e];
+				if (x) for (size_t p = _es[e]; p < _es[e + 1]; ++p) w[_ei[p]] -= _ev[p] * x;
+			}
+		}
+		//y = B^-T d, d indexed by basis positions and y by rows; the rows still unsolved
+		//hold 0 and drop out of the products with the columns
+		void _btran(const _T* d, _T* y) {
+			_T* u = _u.data(), * t = _t.data();
+			for (size_t p = 0; p < _m; ++p) u[p] = d[p];
+			for (size_t e = _etas; e--; ) {
+				_T x = u[_ep[e]];
+				for (size_t p = _es[e]; p < _es[e + 1]; ++p) x -= _ev[p] * u[_ei[p]];
+				u[_ep[e]] = x / _epv[e];
+			}
+			for (size_t i = 0; i < _m; ++i) y[i] = _cover[i] != _NONE ? -u[_cover[i]] : 0;
+			const auto pivot = [&](size_t k) {
+				y[_triRow[k]] = (u[_triPos[k]] - _dot(y, _triVar[k])) / _triVal[k];
+			};
+			for (size_t k = _k; k-- > _upper; ) pivot(k);
+			if (_nk) { //U^T forward over steps, then L^T backward into the rows
+				for (size_t c = 0; c < _nk; ++c) {
+					_T x = u[_nucPos[c]] - _dot(y, _nucVar[c]);
+					for (size_t p = _uStart[c]; p < _uStart[c + 1]; ++p) x -= _uVal[p] * t[_uIdx[p]];
+					t[c] = x / _uDiag[c];
+				}
+				for (size_t c = _nk; c--; ) {
+					_T x = t[c];
+					for (size_t p = _lStart[c]; p < _lStart[c + 1]; ++p) x -= _lVal[p] * y[_nucRow[_lIdx[p]]];
+					y[_nucRow[_nucPivot[c]]] = x;
+				}
+			}
+			for (size_t k = _lower; k--; ) pivot(k);
+		}
+		//Factors the bump of the basis and empties the eta file; false if the nucleus is
+		//singular
+		bool _factor() {
+			const size_t* ptr = _a.pointers(), * idx = _a.indices(), * rptr = _ar.pointers(), * ridx = _ar.indices();
+			const _T* val = _a.values(), * rval = _ar.values();
+			size_t k = 0, top = 0;
+			_etas = 0;
+			for (size_t i = 0; i < _m; ++i) _cover[i] = _NONE, _rowCount[i] = 0;
+			for (size_t p = 0; p < _m; ++p)
+				if (_head[p] >= _n) _cover[_head[p] - _n] = p;
+				else _nucVar[k] = _head[p], _nucPos[k] = p, _varBump[_head[p]] = k++;
+			for (size_t q = 0; q < k; ++q) {
+				_colCount[q] = 0;
+				for (size_t p = ptr[_nucVar[q]]; p < ptr[_nucVar[q] + 1]; ++p)
+					if (_cover[idx[p]] == _NONE) ++_colCount[q], ++_rowCount[idx[p]];
+			}
+			_k = k, _lower = 0, _upper = k;
+			//A pivot leaves its row and column with count _NONE
+			for (size_t q = 0; q < k; ++q) if (_colCount[q] == 1) _stack[top++] = q;
+			while (top) {
+				const size_t q = _stack[--top], j = _nucVar[q];
+				if (_colCount[q] != 1) continue;
+				size_t p = ptr[j];
+				while (_cover[idx[p]] != _NONE || _rowCount[idx[p]] == _NONE) ++p;
+				const size_t i = idx[p];
+				--_upper, _triRow[_upper] = i, _triVar[_upper] = j, _triPos[_upper] = _nucPos[q], _triVal[_upper] = val[p];
+				_colCount[q] = _rowCount[i] = _NONE;
+				for (size_t r = rptr[i]; r < rptr[i + 1]; ++r) {
+					const size_t c = _varBump[ridx[r]];
+					if (c != _NONE && _colCount[c] != _NONE && --_colCount[c] == 1) _stack[top++] = c;
+				}
+			}
+			for (size_t i = 0; i < _m; ++i) if (_cover[i] == _NONE && _rowCount[i] == 1) _stack[top++] = i;
+			while (top) {
+				const size_t i = _stack[--top];
+				if (_rowCount[i] != 1) continue;
+				size_t r = rptr[i];
+				while (_varBump[ridx[r]] == _NONE || _colCount[_varBump[ridx[r]]] == _NONE) ++r;
+				const size_t j = ridx[r], q = _varBump[j];
+				_triRow[_lower] = i, _triVar[_lower] = j, _triPos[_lower] = _nucPos[q], _triVal[_lower++] = rval[r];
+				_colCount[q] = _rowCount[i] = _NONE;
+				for (size_t p = ptr[j]; p < ptr[j + 1]; ++p) {
+					const size_t h = idx[p];
+					if (_cover[h] == _NONE && _rowCount[h] != _NONE && --_rowCount[h] == 1) _stack[top++] = h;
+				}
+			}
+			for (size_t p = 0; p < _m; ++p) if (_head[p] < _n) _varBump[_head[p]] = _NONE;
+			_nk = 0;
+			for (size_t q = 0; q < k; ++q) //Sort keys count * m + q
+				if (_colCount[q] != _NONE) _stack[_nk++] = _colCount[q] * _m + q;
+			_sortIndices(_stack.data(), _nk);
+			for (size_t c = 0; c < _nk; ++c) _nucPivot[c] = _nucVar[_stack[c] % _m], _nucCount[c] = _nucPos[_stack[c] % _m];
+			for (size_t c = 0; c < _nk; ++c) _nucVar[c] = _nucPivot[c], _nucPos[c] = _nucCount[c];
+			for (size_t i = 0, r = 0; i < _m; ++i) if (_cover[i] == _NONE && _rowCount[i] != _NONE)
+				_nucRow[r] = i, _nucCount[r] = _rowCount[i], _rowStep[r] = _NONE, _rowCount[i] = r++;
+			//Left-looking: column c is reduced by the L columns of the earlier steps that
+			//pivoted on one of its rows, taken in step order from a heap, then pivots on the
+			//sparsest row within a tenth of its largest entry. The rows it touches are listed,
+			//so the work follows the nonzeros
+			_T* x = _t.data();
+			size_t* const heap = _stack.data(), * const list = _colCount.data(), * const mark = _mark.data();
+			bool regular = true;
+			for (size_t r = 0; r < _nk; ++r) x[r] = 0, mark[r] = _NONE;
+			_lStart[0] = _uStart[0] = 0;
+			for (size_t c = 0, ln = 0, un = 0; c < _nk; ++c) {
+				size_t len = 0, hn = 0;
+				const auto touch = [&](size_t h) {
+					if (mark[h] == c) return;
+					mark[h] = c, list[len++] = h;
+					if (const size_t s = _rowStep[h]; s != _NONE) {
+						size_t k = hn++;
+						for (; k && heap[(k - 1) / 2] > s; k = (k - 1) / 2) heap[k] = heap[(k - 1) / 2];
+						heap[k] = s;
+					}
+				};
+				_T scale = 0;
+				for (size_t p = ptr[_nucVar[c]]; p < ptr[_nucVar[c] + 1]; ++p)
+					if (_cover[idx[p]] == _NONE && _rowCount[idx[p]] != _NONE)
+						touch(_rowCount[idx[p]]), x[_rowCount[idx[p]]] = val[p], scale = max(scale, abs(val[p]));
+				while (hn) {
+					const size_t s = heap[0], last = heap[--hn];
+					size_t k = 0;
+					for (size_t h; (h = 2 * k + 1) < hn; k = h) {
+						if (h + 1 < hn && heap[h + 1] < heap[h]) ++h;
+						if (last <= heap[h]) break;
+						heap[k] = heap[h];
+					}
+					if (hn) heap[k] = last;
+					const size_t r = _nucPivot[s];
+					if (!x[r]) continue;
+					const _T z = x[r];
+					x[r] = 0;
+					_grow(_uIdx, _uVal, un + 1);
+					_uIdx[un] = s, _uVal[un++] = z;
+					for (size_t p = _lStart[s]; p < _lStart[s + 1]; ++p) touch(_lIdx[p]), x[_lIdx[p]] -= _lVal[p] * z;
+				}
+				_T big = 0;
+				size_t r = _NONE;
+				for (size_t e = 0; e < len; ++e) if (_rowStep[list[e]] == _NONE) big = max(big, abs(x[list[e]]));
+				if (big > scale * 1e-11) for (size_t e = 0; e < len; ++e) {
+					const size_t h = list[e];
+					if (_rowStep[h] == _NONE && abs(x[h]) >= big / 10 && (r == _NONE
+						|| _nucCount[h] < _nucCount[r] || _nucCount[h] == _nucCount[r] && h < r)) r = h;
+				}
+				_nucPivot[c] = r;
+				if (r == _NONE) regular = false;
+				else {
+					_rowStep[r] = c, _uDiag[c] = x[r];
+					for (size_t e = 0; e < len; ++e) if (const size_t h = list[e]; _rowStep[h] == _NONE && x[h]) {
+						_grow(_lIdx, _lVal, ln + 1);
+						_lIdx[ln] = h, _lVal[ln++] = x[h] / _uDiag[c];
+					}
+				}
+				for (size_t e = 0; e < len; ++e) x[list[e]] = 0;
+				_lStart[c + 1] = ln, _uStart[c + 1] = un;
+			}
+			return regular;
+		}
+		//Factors the basis. Each column of the nucleus left without a pivot is traded for
+		//the logical of a row left without one, and the structural stays where it is as a
+		//nonbasic variable
+		void _refactor() {
+			if (!_factor()) {
+				for (size_t c = 0, r = 0; c < _nk; ++c) if (_nucPivot[c] == _NONE) {
+					while (_rowStep[r] != _NONE) ++r;
+					const size_t p = _nucPos[c], l = _n + _nucRow[r++];
+					_state[_head[p]] = _FREE, _head[p] = l, _state[l] = _BASIC, _box[l] = 0, _dse[p] = 1;
+				}
+				_factor();
+			}
+			_factored = true;
+		}
+		//Basic values B^-1 * (-N x_N) and reduced costs c - [A -I]^T B^-T c_B
+		void _evaluate() {
+			const size_t* ptr = _a.pointers(), * idx = _a.indices();
+			const _T* val = _a.values();
+			for (size_t i = 0; i < _m; ++i) _col[i] = 0;
+			for (size_t j = 0; j < _n + _m; ++j) if (_state[j] != _BASIC && _x[j]) {
+				if (j >= _n) _col[j - _n] += _x[j];
+				else for (size_t p = ptr[j]; p < ptr[j + 1]; ++p) _col[idx[p]] -= val[p] * _x[j];
+			}
+			_ftran(_col.data(), _alpha.data());
+			for (size_t p = 0; p < _m; ++p) _x[_head[p]] = _alpha[p], _alpha[p] = _cost[_head[p]];
+			_btran(_alpha.data(), _rho.data());
+			_parallelOuter(_n, ptr, [&](size_t j0, size_t j1) {
+				for (size_t j = j0; j < j1; ++j) {
+					_T d = _cost[j];
+					for (size_t p = ptr[j]; p < ptr[j + 1]; ++p) d -= val[p] * _rho[idx[p]];
+					_d[j] = _state[j] == _BASIC ? 0 : d;
+				}
+			});
+			for (size_t i = 0; i < _m; ++i) _d[_n + i] = _state[_n + i] == _BASIC ? 0 : _cost[_n + i] + _rho[i];
+			_valued = true;
 		}
+		void _refresh() {
+			_refactor();
+			_evaluate();
+		}
+		//Row r of B^-1 [A -I] into _row, and e_r^T B^-1 into _rho; overwrites _col
+		void _pivotRow(size_t r) {
+			for (size_t p = 0; p < _m; ++p) _col[p] = p == r;
+			_btran(_col.data(), _rho.data());
+			size_t nz = 0;
+			for (size_t i = 0; i < _m; ++i) nz += _rho[i] != 0;
+			if (nz * 10 < _m) { //Few rows: sweep them in the row-major copy
+				for (size_t j = 0; j < _n; ++j) _row[j] = 0;
+				const size_t* ptr = _ar.pointers(), * idx = _ar.indices();
+				const _T* val = _ar.values();
+				for (size_t i = 0; i < _m; ++i) if (const _T y = _rho[i])
+					for (size_t p = ptr[i]; p < ptr[i + 1]; ++p) _row[idx[p]] += val[p] * y;
+			} else {
+				const size_t* ptr = _a.pointers(), * idx = _a.indices();
+				const _T* val = _a.values();
+				_parallelOuter(_n, ptr, [&](size_t j0, size_t j1) {
+					for (size_t j = j0; j < j1; ++j) {
+						_T t = 0;
+						for (size_t p = ptr[j]; p < ptr[j + 1]; ++p) t += val[p] * _rho[idx[p]];
+						_row[j] = t;
+					}
+				});
+			}
+			for (size_t i = 0; i < _m; ++i) _row[_n + i] = -_rho[i];
+		}
+		//Makes q basic at position r, _alpha holding B^-1 a_q, and appends the eta
+		void _replace(size_t r, size_t q) {
+			_state[q] = _BASIC, _box[q] = 0, _head[r] = q;
+			size_t nz = _es[_etas];
+			for (size_t p = 0; p < _m; ++p) if (p != r && _alpha[p]) {
+				_grow(_ei, _ev, nz + 1);
+				_ei[nz] = p, _ev[nz++] = _alpha[p];
+			}
+			_ep[_etas] = r, _epv[_etas] = _alpha[r], _es[++_etas] = nz;
+			if (_etas >= _opt.refactor) _refresh();
+		}
+		bool _eligible(size_t j) const noexcept {
+			const _T tolD = _opt.optimalityTolerance, tolP = _opt.feasibilityTolerance;
+			return _state[j] != _BASIC && (_d[j] < -tolD && _x[j] < _up[j] - tolP || tolD < _d[j] && _lo[j] + tolP < _x[j]);
+		}
+		_T _infeasibility(size_t j) const noexcept {
+			const _T tolP = _opt.feasibilityTolerance;
+			return _x[j] < _lo[j] - tolP ? _x[j] - _lo[j] : _up[j] + tolP < _x[j] ? _x[j] - _up[j] : _T(0);
+		}
+		//One primal iteration from a primal feasible basis: 1 if optimal, 2 if unbounded
+		int _primalStep() {
+			const _T tolP = _opt.feasibilityTolerance, piv = _opt.pivotTolerance, inf = infinity<_T>();
+			size_t q = _NONE;
+			_T best = 0;
+			for (size_t j = 0; j < _n + _m; ++j) if (_eligible(j)) {
+				const _T s = _d[j] * _d[j] / (_opt.steepestEdge ? _devex[j] : _T(1));
+				if (best < s) best = s, q = j;
+			}
+			if (q == _NONE) return 1;
+			const _T dir = _d[q] < 0 ? 1 : -1, range = dir > 0 ? _up[q] - _x[q] : _x[q] - _lo[q];
+			_column(q);
+			_ftran(_col.data(), _alpha.data());
+			_T tmax = inf; //Harris: bounds relaxed by the tolerance, then the largest pivot
+			for (size_t p = 0; p < _m; ++p) {
+				const size_t i = _head[p];
+				const _T a = _alpha[p] * dir;
+				if (piv < a && _lo[i] > -inf) tmax = min(tmax, (_x[i] - _lo[i] + tolP) / a);
+				else if (a < -piv && _up[i] < inf) tmax = min(tmax, (_x[i] - _up[i] - tolP) / a);
+			}
+			if (tmax == inf && range == inf) return 2;
+			size_t r = _NONE;
+			_T theta = range, big = 0;
+			if (tmax < range) for (size_t p = 0; p < _m; ++p) {
+				const size_t i = _head[p];
+				const _T a = _alpha[p] * dir;
+				_T t = inf;
+				if (piv < a && _lo[i] > -inf) t = (_x[i] - _lo[i]) / a;
+				else if (a < -piv && _up[i] < inf) t = (_x[i] - _up[i]) / a;
+				if (t <= tmax && big < abs(a)) big = abs(a), r = p, theta = t < 0 ? _T(0) : t;
+			}
+			for (size_t p = 0; p < _m; ++p) if (_alpha[p]) _x[_head[p]] -= theta * dir * _alpha[p];
+			_x[q] += theta * dir;
+			if (r == _NONE) { //Bound flip
+				_x[q] = dir > 0 ? _up[q] : _lo[q], _state[q] = dir > 0 ? _UPPER : _LOWER, _box[q] = 0;
+				return 0;
+			}
+			const size_t l = _head[r];
+			const bool lower = _alpha[r] * dir > 0;
+			_x[l] = lower ? _lo[l] : _up[l], _state[l] = lower ? _LOWER : _UPPER;
+			_pivotRow(r);
+			const _T arq = _alpha[r], td = _d[q] / arq, wq = _devex[q];
+			_T top = 0;
+			for (size_t j = 0; j < _n + _m; ++j) if (_state[j] != _BASIC && _row[j]) {
+				_d[j] -= td * _row[j];
+				const _T w = _row[j] / arq * (_row[j] / arq) * wq;
+				if (_devex[j] < w) _devex[j] = w, top = max(top, w);
+			}
+			_d[l] = -td, _d[q] = 0, _devex[l] = max(wq / (arq * arq), _T(1));
+			//Weights that grow without bound would drown every reduced cost: new reference
+			//framework
+			if (!(top < 1e12 && _devex[l] < 1e12)) for (_T& w : _devex) w = 1;
+			_replace(r, q);
+			return 0;
+		}
+		//One dual iteration from a dual feasible basis: 1 if optimal, 2 if infeasible, 3
+		//if the pivot disagrees with the factorization, which then needs refreshing
+		int _dualStep() {
+			const _T tolD = _opt.optimalityTolerance, piv = _opt.pivotTolerance, inf = infinity<_T>();
+			size_t r = _NONE;
+			_T best = 0, delta = 0;
+			for (size_t p = 0; p < _m; ++p) if (const _T e = _infeasibility(_head[p])) {
+				const _T s = e * e / (_opt.steepestEdge ? _dse[p] : _T(1));
+				if (best < s) best = s, r = p, delta = e;
+			}
+			if (r == _NONE) return 1;
+			const _T sigma = delta < 0 ? 1 : -1;
+			_pivotRow(r);
+			if (_opt.steepestEdge) {
+				_T w = 0;
+				for (size_t i = 0; i < _m; ++i) w += _rho[i] * _rho[i];
+				_dse[r] = w;
+			}
+			_T tmax = inf; //Harris again, over the reduced costs
+			for (size_t j = 0; j < _n + _m; ++j) if (_state[j] != _BASIC && _movable(j)) {
+				const _T a = -sigma * _row[j];
+				if (piv < a && _state[j] != _UPPER) tmax = min(tmax, (_d[j] + tolD) / a);
+				else if (a < -piv && _state[j] != _LOWER) tmax = min(tmax, (_d[j] - tolD) / a);
+			}
+			if (tmax == inf) return 2;
+			size_t q = _NONE;
+			_T big = 0;
+			for (size_t j = 0; j < _n + _m; ++j) if (_state[j] != _BASIC && _movable(j)) {
+				const _T a = -sigma * _row[j];
+				if ((piv < a && _state[j] != _UPPER || a < -piv && _state[j] != _LOWER)
+					&& _d[j] / a <= tmax && big < abs(a)) big = abs(a), q = j;
+			}
+			_column(q);
+			_ftran(_col.data(), _alpha.data());
+			const _T arq = _alpha[r];
+			if (abs(arq - _row[q]) > 1e-6 * (1 + abs(arq))) return 3;
+			_T td = _d[q] / (-sigma * _row[q]);
+			if (td < 0) td = 0;
+			const _T tp = delta / arq;
+			for (size_t p = 0; p < _m; ++p) if (_alpha[p]) _x[_head[p]] -= tp * _alpha[p];
+			_x[q] += tp;
+			const size_t l = _head[r];
+			_x[l] = sigma > 0 ? _lo[l] : _up[l], _state[l] = sigma > 0 ? _LOWER : _UPPER;
+			for (size_t j = 0; j < _n + _m; ++j) if (_state[j] != _BASIC && _row[j]) _d[j] += td * sigma * _row[j];
+			_d[l] = sigma * td, _d[q] = 0;
+			if (_opt.steepestEdge) { //Update of Forrest and Goldfarb through tau = B^-1 rho
+				_ftran(_rho.data(), _col.data());
+				const _T wr = _dse[r];
+				for (size_t p = 0; p < _m; ++p) if (p != r && _alpha[p]) {
+					const _T g = _alpha[p] / arq, w = _dse[p] - 2 * g * _col[p] + g * g * wr;
+					_dse[p] = w < 1e-4 ? _T(1e-4) : w;
+				}
+				_dse[r] = max(wr / (arq * arq), _T(1e-4));
+			}
+			_replace(r, q);
+			return 0;
+		}
+		//Moves nonbasic variables to the bounds their reduced costs ask for, boxing the
+		//infinite ones
+		void _dualize() {
+			const _T tolD = _opt.optimalityTolerance, inf = infinity<_T>();
+			bool moved = false;
+			for (size_t j = 0; j < _n + _m; ++j) if (_state[j] != _BASIC) {
+				const _T x = _x[j];
+				if (!_movable(j)) _x[j] = _lo[j], _state[j] = _LOWER;
+				else if (tolD < _d[j] && (_state[j] != _LOWER || x != _lo[j]))
+					_state[j] = _LOWER, _box[j] = _lo[j] == -inf, _x[j] = _box[j] ? min(x, _up[j]) - _BOX : _lo[j];
+				else if (_d[j] < -tolD && (_state[j] != _UPPER || x != _up[j]))
+					_state[j] = _UPPER, _box[j] = _up[j] == inf, _x[j] = _box[j] ? max(x, _lo[j]) + _BOX : _up[j];
+				moved |= _x[j] != x;
+			}
+			if (moved) _evaluate();
+		}
+		bool _optimal() const noexcept {
+			for (size_t p = 0; p < _m; ++p) if (_infeasibility(_head[p])) return false;
+			for (size_t j = 0; j < _n + _m; ++j) if (_eligible(j)) return false;
+			return true;
+		}
+	public:
+		typedef _T ValueType;
+		//Maximize c*x subject to A*x <= b and x >= 0, as linearProgram does; setBounds and
+		//setRowBounds change the constraints
+		RevisedSimplex(SparseMatrix<_T, SparseFormat::CSC> a, const DynamicVector<_T>& b,
+			const DynamicVector<_T>& c, const SimplexOptions& options = {})
+			: _m(a.rows()), _n(a.columns()), _a(static_cast<SparseMatrix<_T, SparseFormat::CSC>&&>(a)), _ar(_a),
+			_opt(options), _cost(_n + _m), _lo(_n + _m), _up(_n + _m), _x(_n + _m), _d(_n + _m), _devex(_n + _m),
+			_state(_n + _m), _box(_n + _m), _head(_m), _dse(_m), _k(0), _lower(0), _upper(0), _nk(0), _varBump(_n),
+			_ep(_opt.refactor + 1), _es(_opt.refactor + 2), _epv(_opt.refactor + 1), _etas(0),
+			_status(SimplexStatus::IterationLimit), _iter(0), _factored(false), _valued(false) {
+			if (b.size() != _m || c.size() != _n) throw Error(EDOM, "Dimension mismatch");
+			if (!_opt.refactor) throw Error(EDOM, "Zero refactorization interval");
+			_workspace();
+			const _T inf = infinity<_T>();
+			for (size_t j = 0; j < _n; ++j) _cost[j] = -c[j], _up[j] = inf, _state[j] = _LOWER;
+			for (size_t i = 0; i < _m; ++i)
+				_lo[_n + i] = -inf, _up[_n + i] = b[i], _head[i] = _n + i, _state[_n + i] = _BASIC;
+			for (_T& w : _devex) w = 1;
+			for (_T& w : _dse) w = 1;
+			for (size_t& q : _varBump) q = _NONE;
+		}
+		template <class _A> RevisedSimplex(const _A& a, const DynamicVector<_T>& b, const DynamicVector<_T>& c,
+			const SimplexOptions& options = {}) : RevisedSimplex(SparseMatrix<_T, SparseFormat::CSC>(a), b, c, options) {}
+		size_t rows() const noexcept { return _m; }
+		size_t columns() const noexcept { return _n; }
+		//lo <= x_j <= hi, either end possibly infinite
+		void setBounds(size_t j, _T lo, _T hi) {
+			if (j >= _n + _m) throw Error(ERANGE, "Out of range");
+			if (hi < lo) throw Error(EDOM, "Empty bounds");
+			_lo[j] = lo, _up[j] = hi;
+			if (_state[j] != _BASIC) _place(j);
+		}
+		//lo <= a_i*x <= hi
+		void setRowBounds(size_t i, _T lo, _T hi) {
+			if (i >= _m) throw Error(ERANGE, "Out of range");
+			setBounds(_n + i, lo, hi);
+		}
+		_T lowerBound(size_t j) const noexcept { return _lo[j]; }
+		_T upperBound(size_t j) const noexcept { return _up[j]; }
+		//Snapshot of a basis for setBasis
+		struct Basis {
+			DynamicVector<size_t> head;
+			DynamicVector<unsigned char> state;
+		};
+		Basis basis() const { return { _head, _state }; }
+		//Restarts from a basis of this problem taken with as many rows; nonbasic variables
+		//go to the bounds their states name
+		void setBasis(const Basis& b) {
+			if (b.head.size() != _m || b.state.size() != _n + _m) throw Error(EDOM, "Dimension mismatch");
+			_head = b.head, _state = b.state;
+			for (size_t j = 0; j < _n + _m; ++j) if (_state[j] != _BASIC) _place(j);
+			for (_T& w : _dse) w = 1;
+			_factored = _valued = false;
+		}
+		//Starts from the basis a nearly optimal point suggests, such as the structurals x and
+		//shadow prices y an interior-point method ends with: the m variables farthest from
+		//their bounds relative to their reduced costs turn basic and the others go to their
+		//nearest bounds. A singular choice is repaired at the next factorization, and solve()
+		//then needs few pivots to reach a vertex
+		void crossover(const DynamicVector<_T>& x, const DynamicVector<_T>& y) {
+			if (x.size() != _n || y.size() != _m) throw Error(EDOM, "Dimension mismatch");
+			const size_t N = _n + _m;
+			Basis b{ DynamicVector<size_t>(_m), DynamicVector<unsigned char>(N) };
+			DynamicVector<size_t> key(N);
+			for (size_t j = 0; j < N; ++j) {
+				_T v = 0, d = 0;
+				if (j < _n) {
+					v = x[j], d = -_cost[j];
+					for (size_t p = _a.pointers()[j]; p < _a.pointers()[j + 1]; ++p) d -= y[_a.indices()[p]] * _a.values()[p];
+				} else {
+					for (size_t p = _ar.pointers()[j - _n]; p < _ar.pointers()[j - _n + 1]; ++p)
+						v += _ar.values()[p] * x[_ar.indices()[p]];
+					d = y[j - _n];
+				}
+				const _T gap = min(v - _lo[j], _up[j] - v);
+				const _T score = !(gap > 0) ? _T(0) : isfinite(gap) ? gap / (gap + abs(d)) : _T(1);
+				key[j] = size_t((1 - score) * 1048576) * N + j;
+				_x[j] = v, b.state[j] = v - _lo[j] <= _up[j] - v ? _LOWER : _UPPER;
+			}
+			_sortIndices(key.data(), N);
+			for (size_t p = 0; p < _m; ++p) b.head[p] = key[p] % N, b.state[key[p] % N] = _BASIC;
+			setBasis(b);
+		}
+		//Appends the rows of r as lo <= r*x <= hi. Their logicals enter the basis, so the
+		//next solve goes on from the current basis by the dual method
+		void addRows(const SparseMatrix<_T, SparseFormat::CSR>& r, const DynamicVector<_T>& lo, const DynamicVector<_T>& hi) {
+			const size_t k = r.rows(), m = _m + k, nnz = _ar.nonZeros();
+			if (r.columns() != _n || lo.size() != k || hi.size() != k) throw Error(EDOM, "Dimension mismatch");
+			DynamicVector<size_t> ptr(m + 1), idx(nnz + r.nonZeros());
+			DynamicVector<_T> val(nnz + r.nonZeros());
+			for (size_t i = 0; i <= _m; ++i) ptr[i] = _ar.pointers()[i];
+			for (size_t i = 1; i <= k; ++i) ptr[_m + i] = nnz + r.pointers()[i];
+			for (size_t p = 0; p < nnz; ++p) idx[p] = _ar.indices()[p], val[p] = _ar.values()[p];
+			for (size_t p = 0; p < r.nonZeros(); ++p) idx[nnz + p] = r.indices()[p], val[nnz + p] = r.values()[p];
+			_ar = SparseMatrix<_T, SparseFormat::CSR>(m, _n, static_cast<DynamicVector<size_t>&&>(ptr),
+				static_cast<DynamicVector<size_t>&&>(idx), static_cast<DynamicVector<_T>&&>(val));
+			_a = SparseMatrix<_T, SparseFormat::CSC>(_ar);
+			_extend(_cost, _n + m, _T(0)), _extend(_lo, _n + m, _T(0)), _extend(_up, _n + m, _T(0));
+			_extend(_x, _n + m, _T(0)), _extend(_d, _n + m, _T(0)), _extend(_devex, _n + m, _T(1));
+			_extend(_state, _n + m, (unsigned char)_BASIC), _extend(_box, _n + m, (unsigned char)0);
+			_extend(_head, m, _NONE), _extend(_dse, m, _T(1));
+			for (size_t i = _m; i < m; ++i) {
+				_T t = 0;
+				for (size_t p = _ar.pointers()[i]; p < _ar.pointers()[i + 1]; ++p) t += _ar.values()[p] * _x[_ar.indices()[p]];
+				_lo[_n + i] = lo[i - _m], _up[_n + i] = hi[i - _m], _x[_n + i] = t, _head[i] = _n + i;
+			}
+			_m = m, _factored = _valued = false;
+			_workspace();
+		}
+		//Gomory mixed-integer cut pi*x >= pi0 over the structurals from the row of basic
+		//x_j in the last optimal basis, where integer flags the integer structurals, and the
+		//nonbasic ones among them sit on integer bounds. False when the row gives no cut
+		//or only one too badly scaled to trust
+		bool gomoryCut(size_t j, const DynamicVector<unsigned char>& integer, DynamicVector<_T>& pi, _T& pi0) {
+			if (j >= _n + _m || _state[j] != _BASIC || integer.size() != _n) return false;
+			const _T f0 = _x[j] - floor(_x[j]);
+			if (f0 < 0.01 || f0 > 0.99) return false;
+			if (!_factored) _refactor();
+			size_t r = 0;
+			while (_head[r] != j) ++r;
+			_pivotRow(r);
+			//x_j + sum g_k t_k = x_j now, t_k >= 0 the distance of x_k from its bound
+			pi = DynamicVector<_T>(_n), pi0 = 1;
+			for (size_t k = 0; k < _n + _m; ++k) {
+				if (_state[k] == _BASIC || abs(_row[k]) < 1e-11) continue;
+				if (_state[k] == _FREE || !_movable(k)) {
+					if (_state[k] == _FREE) return false;
+					continue;
+				}
+				const _T s = _state[k] == _LOWER ? 1 : -1, g = s * _row[k], b = _state[k] == _LOWER ? _lo[k] : _up[k];
+				_T c;
+				if (k < _n && integer[k]) {
+					const _T f = g - floor(g);
+					c = f <= f0 ? f / f0 : (1 - f) / (1 - f0);
+				} else c = g > 0 ? g / f0 : -g / (1 - f0);
+				if (!c) continue;
+				pi0 += s * c * b;
+				if (k < _n) pi[k] += s * c;
+				else for (size_t p = _ar.pointers()[k - _n]; p < _ar.pointers()[k - _n + 1]; ++p)
+					pi[_ar.indices()[p]] += s * c * _ar.values()[p];
+			}
+			_T big = 0, small = infinity<_T>();
+			for (_T& t : pi) if (abs(t) < 1e-12) t = 0;
+			for (const _T& t : pi) if (t) big = max(big, abs(t)), small = min(small, abs(t));
+			if (!big || big > small * 1e8 || !isfinite(pi0)) return false;
+			pi /= big, pi0 /= big;
+			return true;
+		}
+		//Runs the dual method while the basis is primal infeasible and the primal method
+		//after it, up to options.maxIterations pivots in all
+		SimplexStatus solve() {
+			const size_t limit = _opt.maxIterations ? _opt.maxIterations : 20 * (_m + _n) + 10000;
+			_iter = 0, _status = SimplexStatus::IterationLimit;
+			if (!_factored) _refactor(), _valued = false;
+			if (!_valued) _evaluate();
+			for (size_t round = 0; round < 8; ++round) {
+				if (_optimal()) return _status = SimplexStatus::Optimal;
+				bool infeasible = false;
+				for (size_t p = 0; p < _m; ++p) if (_infeasibility(_head[p])) infeasible = true;
+				if (infeasible) {
+					_dualize();
+					int s;
+					while ((s = _dualStep()) != 1) {
+						if (s == 2) {
+							_refresh();
+							if ((s = _dualStep()) == 2) return _status = SimplexStatus::Infeasible;
+						}
+						if (s == 3) _refresh();
+						if (++_iter >= limit) return _status;
+					}
+					for (size_t j = 0; j < _n + _m; ++j) if (_box[j]) _box[j] = 0, _state[j] = _FREE;
+				}
+				int s;
+				while ((s = _primalStep()) != 1) {
+					if (s == 2) return _status = SimplexStatus::Unbounded;
+					if (++_iter >= limit) return _status;
+				}
+				_refresh();
+			}
+			return _status;
+		}
+		SimplexStatus status() const noexcept { return _status; }
+		size_t iterations() const noexcept { return _iter; }
+		_T objective() const noexcept {
+			_T y = 0;
+			for (size_t j = 0; j < _n; ++j) y -= _cost[j] * _x[j];
+			return y;
+		}
+		DynamicVector<_T> solution() const {
+			DynamicVector<_T> x(_n);
+			for (size_t j = 0; j < _n; ++j) x[j] = _x[j];
+			return x;
+		}
+		//Row activities A*x
+		DynamicVector<_T> activities() const {
+			DynamicVector<_T> r(_m);
+			for (size_t i = 0; i < _m; ++i) r[i] = _x[_n + i];
+			return r;
+		}
+		//Shadow prices: the rate the optimum changes at as the active bound of each row moves
+		DynamicVector<_T> duals() const {
+			DynamicVector<_T> y(_m);
+			for (size_t i = 0; i < _m; ++i) y[i] = -_d[_n + i];
+			return y;
+		}
+		DynamicVector<_T> reducedCosts() const {
+			DynamicVector<_T> d(_n);
+			for (size_t j = 0; j < _n; ++j) d[j] = -_d[j];
+			return d;
+		}
+	};
+	template <class _A, class _T> RevisedSimplex(const _A&, const DynamicVector<_T>&, const DynamicVector<_T>&,
+		const SimplexOptions & = {}) -> RevisedSimplex<_T>;
+	// Interior-point method
+	struct InteriorPointOptions {
+		double tolerance = 1e-8; //Relative primal and dual residuals and duality gap accepted as optimal
+		size_t maxIterations = 200;
+		double stepFactor = 0.9995; //Fraction of the step to the boundary taken
+	};
+	//Maximizes c*x over A*x + s = b, x, s >= 0 by Mehrotra's primal-dual predictor-corrector
+	//method, as the minimization of -c*z over [A I]*z = b, z = (x, s) >= 0, with dual
+	//[A I]^T*y + w = -c, w >= 0. Each iteration takes two Newton steps on the normal
+	//equations A*D_x*A^T + D_s, D = Z/W, factored once by Cholesky. When A*A^T is sparse its
+	//rows are put in minimum degree order and the factor keeps the pattern the elimination
+	//graph predicts; otherwise A*D_x*A^T is formed and factored by the dense kernels. Nearly
+	//singular pivots, which the normal equations run into as the method converges, are
+	//made huge so that their components of the solution vanish. The iteration count
+	//barely grows with the size of the problem
+	template <RealArithmetic _T = double> class InteriorPoint {
+		size_t _m, _n;
+		SparseMatrix<_T, SparseFormat::CSC> _a;
+		SparseMatrix<_T, SparseFormat::CSR> _ar;
+		DynamicVector<_T> _b, _c;
+		InteriorPointOptions _opt;
+		//Primal z = (x, s), dual slacks w and dual y of the minimization
+		DynamicVector<_T> _z, _w, _y;
+		//Normal equations. Dense: the m*m matrix, its factor in the lower triangle, and the
+		//scaled A. Sparse: row _perm[k] is eliminated at step k, _pos is the inverse, column k
+		//of L holds the entries below the diagonal at rows _lIdx[_lStart[k].._lStart[k + 1])
+		//in ascending order, and row k of L those left of the diagonal at columns _rIdx
+		bool _dense;
+		size_t _flops;
+		DynamicVector<_T> _full, _scaled;
+		DynamicVector<size_t> _perm, _pos, _lStart, _lIdx, _rStart, _rIdx, _next;
+		DynamicVector<_T> _lVal, _lDiag, _work;
+		SimplexStatus _status;
+		size_t _iter;
+		static _T _norm(const DynamicVector<_T>& v) noexcept {
+			_T t = 0;
+			for (const _T& x : v) t = max(t, abs(x));
+			return t;
+		}
+		static _T _dot(const DynamicVector<_T>& u, const DynamicVector<_T>& v) noexcept {
+			_T t = 0;
+			for (size_t k = 0; k < u.size(); ++k) t += u[k] * v[k];
+			return t;
+		}
+		//[A I]*v and [A I]^T*y
+		DynamicVector<_T> _mul(const DynamicVector<_T>& v) const {
+			DynamicVector<_T> r(_m);
+			_spmv(_m, _ar.pointers(), _ar.indices(), _ar.values(), v.data(), r.data());
+			for (size_t i = 0; i < _m; ++i) r[i] += v[_n + i];
+			return r;
+		}
+		DynamicVector<_T> _mulT(const DynamicVector<_T>& y) const {
+			DynamicVector<_T> r(_n + _m);
+			_spmv(_n, _a.pointers(), _a.indices(), _a.values(), y.data(), r.data());
+			for (size_t i = 0; i < _m; ++i) r[_n + i] = y[i];
+			return r;
+		}
+		//Minimum degree order of the rows on the graph of A*A^T, eliminated explicitly: the
+		//neighbours a row still has when it goes are the pattern of its column of L. Returns
+		//false once L would fill more than an eighth of its triangle, beyond which the dense
+		//kernels are faster
+		bool _order() {
+			const size_t m = _m, limit = m * m / 16;
+			const size_t* const cp = _a.pointers(), * const ci = _a.indices();
+			const size_t* const rp = _ar.pointers(), * const ri = _ar.indices();
+			size_t** const adj = new size_t*[m];
+			DynamicVector<size_t> deg(m), cap(m), mark(m), head(m + 1, size_t(-1)), next(m), prev(m);
+			size_t stamp = 0, low = m, nnz = 0;
+			for (size_t i = 0; i < m; ++i) {
+				++stamp, mark[i] = stamp;
+				size_t d = 0;
+				for (size_t p = rp[i]; p < rp[i + 1]; ++p) for (size_t q = cp[ri[p]]; q < cp[ri[p] + 1]; ++q)
+					if (mark[ci[q]] != stamp) mark[ci[q]] = stamp, ++d;
+				adj[i] = new size_t[cap[i] = d + 1], deg[i] = 0, ++stamp, mark[i] = stamp;
+				for (size_t p = rp[i]; p < rp[i + 1]; ++p) for (size_t q = cp[ri[p]]; q < cp[ri[p] + 1]; ++q)
+					if (mark[ci[q]] != stamp) mark[ci[q]] = stamp, adj[i][deg[i]++] = ci[q];
+			}
+			//Rows by degree in doubly linked buckets
+			const auto link = [&](size_t v) {
+				next[v] = head[deg[v]], prev[v] = size_t(-1);
+				if (next[v] != size_t(-1)) prev[next[v]] = v;
+				head[deg[v]] = v, low = min(low, deg[v]);
+			};
+			const auto unlink = [&](size_t v) {
+				if (prev[v] != size_t(-1)) next[prev[v]] = next[v];
+				else head[deg[v]] = next[v];
+				if (next[v] != size_t(-1)) prev[next[v]] = prev[v];
+			};
+			for (size_t i = 0; i < m; ++i) link(i);
+			DynamicVector<size_t> cnt(m + 1);
+			_lIdx = DynamicVector<size_t>(nnz);
+			bool ok = true;
+			for (size_t k = 0; k < m && ok; ++k) {
+				while (head[low] == size_t(-1)) ++low;
+				const size_t v = head[low];
+				unlink(v);
+				_perm[k] = v, _pos[v] = k, cnt[k + 1] = cnt[k] + deg[v];
+				//Degrees seldom fall, so the rows left are assumed to fill at least half as much
+				if ((nnz = cnt[k + 1]) + deg[v] * (m - k - 1) / 2 > limit) {
+					ok = false;
+					break;
+				}
+				if (_lIdx.size() < nnz) {
+					DynamicVector<size_t> t(max(nnz, 2 * _lIdx.size()));
+					for (size_t p = 0; p < cnt[k]; ++p) t[p] = _lIdx[p];
+					_lIdx = static_cast<DynamicVector<size_t>&&>(t);
+				}
+				for (size_t e = 0; e < deg[v]; ++e) _lIdx[cnt[k] + e] = adj[v][e];
+				for (size_t e = 0; e < deg[v]; ++e) {
+					const size_t u = adj[v][e];
+					unlink(u), ++stamp;
+					size_t d = 0;
+					for (size_t f = 0; f < deg[u]; ++f) if (adj[u][f] != v) mark[adj[u][f]] = stamp, adj[u][d++] = adj[u][f];
+					for (size_t f = 0; f < deg[v]; ++f) {
+						const size_t t = adj[v][f];
+						if (t == u || mark[t] == stamp) continue;
+						if (d == cap[u]) {
+							size_t* const a = new size_t[cap[u] *= 2];
+							for (size_t g = 0; g < d; ++g) a[g] = adj[u][g];
+							delete[] adj[u], adj[u] = a;
+						}
+						adj[u][d++] = t;
+					}
+					deg[u] = d, link(u);
+				}
+				delete[] adj[v], adj[v] = nullptr;
+			}
+			for (size_t i = 0; i < m; ++i) delete[] adj[i];
+			delete[] adj;
+			if (!ok) return false;
+			//Rows of L as positions, and the transposed pattern
+			_lStart = static_cast<DynamicVector<size_t>&&>(cnt);
+			_rStart = DynamicVector<size_t>(m + 1);
+			for (size_t k = 0; k < m; ++k) {
+				size_t* const col = _lIdx.data() + _lStart[k];
+				const size_t len = _lStart[k + 1] - _lStart[k];
+				for (size_t p = 0; p < len; ++p) ++_rStart[(col[p] = _pos[col[p]]) + 1];
+				_sortIndices(col, len);
+			}
+			for (size_t k = 0; k < m; ++k) _rStart[k + 1] += _rStart[k];
+			_rIdx = DynamicVector<size_t>(nnz);
+			DynamicVector<size_t> fill(_rStart);
+			for (size_t k = 0; k < m; ++k) for (size_t p = _lStart[k]; p < _lStart[k + 1]; ++p) _rIdx[fill[_lIdx[p]]++] = k;
+			_lVal = DynamicVector<_T>(nnz), _lDiag = _work = DynamicVector<_T>(m), _next = DynamicVector<size_t>(m);
+			return true;
+		}
+		//Chooses dense or sparse normal equations. Forming A*A^T costs the sum of the squared
+		//column counts; once that reaches m*m the product is taken to be dense
+		void _symbolic() {
+			_flops = 0;
+			for (size_t j = 0; j < _n; ++j) {
+				const size_t k = _a.pointers()[j + 1] - _a.pointers()[j];
+				_flops += k * k;
+			}
+			_perm = _pos = DynamicVector<size_t>(_m);
+			_dense = _flops >= _m * _m || !_order();
+			if (_dense) _full = DynamicVector<_T>(_m * _m);
+			if (_dense && 8 * _flops >= _m * _m * _n) _scaled = DynamicVector<_T>(_m * _n);
+		}
+		//Lower triangle of [A I]*D*[A I]^T + shift*I into _full: by gemm on the scaled A when
+		//A is nearly dense, else row by row from the columns each row meets
+		void _assemble(const DynamicVector<_T>& d, _T shift) {
+			const size_t m = _m, n = _n;
+			const size_t* const cp = _a.pointers(), * const ci = _a.indices();
+			const _T* const cv = _a.values();
+			const size_t* const rp = _ar.pointers(), * const ri = _ar.indices();
+			const _T* const rv = _ar.values();
+			_T* const f = _full.data();
+			for (_T& t : _full) t = 0;
+			if (_scaled.size()) {
+				for (_T& t : _scaled) t = 0;
+				for (size_t i = 0; i < m; ++i) for (size_t p = rp[i]; p < rp[i + 1]; ++p)
+					_scaled[i * n + ri[p]] = rv[p] * sqrt(d[ri[p]]);
+				Kernel::gemm<_T, 0, 0, 0, false, true>(m, n, m, _scaled.data(), n, _scaled.data(), n, f, m);
+			} else _parallelOuter(m, rp, [&](size_t i0, size_t i1) {
+				for (size_t i = i0; i < i1; ++i) for (size_t p = rp[i]; p < rp[i + 1]; ++p) {
+					const _T t = d[ri[p]] * rv[p];
+					for (size_t q = cp[ri[p]]; q < cp[ri[p] + 1] && ci[q] <= i; ++q) f[i * m + ci[q]] += t * cv[q];
+				}
+			});
+			for (size_t i = 0; i < m; ++i) f[i * m + i] += d[n + i] + shift;
+		}
+		//Factors [A I]*D*[A I]^T
+		void _factor(const DynamicVector<_T>& d) {
+			const _T eps = Limits<_T>::epsilon(), huge = sqrt(Limits<_T>::max());
+			if (_dense) {
+				_assemble(d, 0);
+				_T top = 0;
+				for (size_t i = 0; i < _m; ++i) top = max(top, _full[i * _m + i]);
+				//Rounding may leave the matrix short of definite; shift it until it is not
+				for (_T shift = 0; !Kernel::cholFactor(_m, _full.data(), _m); _assemble(d, shift)) {
+					shift = shift ? 100 * shift : eps * max(top, _T(1));
+					if (shift > max(top, _T(1))) throw Error(EDOM, "Not positive definite");
+				}
+				return;
+			}
+			//Left-looking: column k gathers its entries of the matrix, then subtracts the
+			//columns of L that have an entry in row k, each at its cursor _next
+			const size_t* const cp = _a.pointers(), * const ci = _a.indices();
+			const _T* const cv = _a.values();
+			const size_t* const rp = _ar.pointers(), * const ri = _ar.indices();
+			const _T* const rv = _ar.values();
+			for (size_t k = 0; k < _m; ++k) _next[k] = _lStart[k];
+			for (size_t k = 0; k < _m; ++k) {
+				const size_t i = _perm[k];
+				_work[k] += d[_n + i];
+				for (size_t p = rp[i]; p < rp[i + 1]; ++p) {
+					const _T t = d[ri[p]] * rv[p];
+					for (size_t q = cp[ri[p]]; q < cp[ri[p] + 1]; ++q)
+						if (_pos[ci[q]] >= k) _work[_pos[ci[q]]] += t * cv[q];
+				}
+				const _T a = _work[k];
+				for (size_t r = _rStart[k]; r < _rStart[k + 1]; ++r) {
+					const size_t j = _rIdx[r];
+					const _T l = _lVal[_next[j]];
+					for (size_t p = _next[j]++; p < _lStart[j + 1]; ++p) _work[_lIdx[p]] -= l * _lVal[p];
+				}
+				const _T piv = _work[k] > eps * a ? sqrt(_work[k]) : huge;
+				_lDiag[k] = piv, _work[k] = 0;
+				for (size_t p = _lStart[k]; p < _lStart[k + 1]; ++p) _lVal[p] = _work[_lIdx[p]] / piv, _work[_lIdx[p]] = 0;
+			}
+		}
+		//Solves the factored normal equations for r in place
+		void _solve(DynamicVector<_T>& r) {
+			if (_dense) return Kernel::cholSolve(_m, 1, _full.data(), _m, r.data(), 1);
+			for (size_t k = 0; k < _m; ++k) _work[k] = r[_perm[k]];
+			for (size_t k = 0; k < _m; ++k) {
+				const _T t = _work[k] /= _lDiag[k];
+				for (size_t p = _lStart[k]; p < _lStart[k + 1]; ++p) _work[_lIdx[p]] -= _lVal[p] * t;
+			}
+			for (size_t k = _m; k--; ) {
+				_T t = _work[k];
+				for (size_t p = _lStart[k]; p < _lStart[k + 1]; ++p) t -= _lVal[p] * _work[_lIdx[p]];
+				_work[k] = t / _lDiag[k];
+			}
+			for (size_t k = 0; k < _m; ++k) r[_perm[k]] = _work[k], _work[k] = 0;
+		}
+		//Newton direction for the residuals rb, rc and the complementarity target rzw:
+		//[A I]*dz = rb, [A I]^T*dy + dw = rc, W*dz + Z*dw = rzw
+		void _direction(const DynamicVector<_T>& rb, const DynamicVector<_T>& rc, const DynamicVector<_T>& rzw,
+			const DynamicVector<_T>& d, DynamicVector<_T>& dz, DynamicVector<_T>& dy, DynamicVector<_T>& dw) {
+			const size_t N = _n + _m;
+			for (size_t j = 0; j < N; ++j) dz[j] = d[j] * rc[j] - rzw[j] / _w[j];
+			dy = _mul(dz);
+			for (size_t i = 0; i < _m; ++i) dy[i] += rb[i];
+			_solve(dy);
+			dw = _mulT(dy);
+			for (size_t j = 0; j < N; ++j) dz[j] = d[j] * (dw[j] - rc[j]) + rzw[j] / _w[j], dw[j] = rc[j] - dw[j];
+		}
+		//Longest step in [0, 1] along dv that keeps v nonnegative
+		static _T _step(const DynamicVector<_T>& v, const DynamicVector<_T>& dv) noexcept {
+			_T a = 1;
+			for (size_t j = 0; j < v.size(); ++j) if (dv[j] < 0) a = min(a, -v[j] / dv[j]);
+			return a;
+		}
+		//Mehrotra's starting point: the least-norm solutions of the equality constraints
+		//shifted into the positive orthant
+		void _start() {
+			const size_t N = _n + _m;
+			const DynamicVector<_T> one(N, _T(1));
+			_factor(one);
+			DynamicVector<_T> t(_b);
+			_solve(t);
+			_z = _mulT(t);
+			_y = _mul(_c);
+			_solve(_y);
+			_w = _mulT(_y);
+			for (size_t j = 0; j < N; ++j) _w[j] = _c[j] - _w[j];
+			_T lz = 0, lw = 0;
+			for (size_t j = 0; j < N; ++j) lz = min(lz, _z[j]), lw = min(lw, _w[j]);
+			for (size_t j = 0; j < N; ++j) _z[j] -= 1.5 * lz, _w[j] -= 1.5 * lw;
+			const _T zw = _dot(_z, _w);
+			_T sz = 0, sw = 0;
+			for (size_t j = 0; j < N; ++j) sz += _z[j], sw += _w[j];
+			const _T hz = sw > 0 ? zw / (2 * sw) : _T(1), hw = sz > 0 ? zw / (2 * sz) : _T(1);
+			_T fz = 0, fw = 0;
+			for (size_t j = 0; j < N; ++j) fz = max(fz, _z[j] += hz), fw = max(fw, _w[j] += hw);
+			for (size_t j = 0; j < N; ++j) _z[j] = max(_z[j], 1e-4 * max(fz, _T(1))), _w[j] = max(_w[j], 1e-4 * max(fw, _T(1)));
+		}
+	public:
+		typedef _T ValueType;
+		//Maximize c*x subject to A*x <= b and x >= 0, as linearProgram does
+		InteriorPoint(SparseMatrix<_T, SparseFormat::CSC> a, const DynamicVector<_T>& b, const DynamicVector<_T>& c,
+			const InteriorPointOptions& options = {}) : _m(a.rows()), _n(a.columns()),
+			_a(static_cast<SparseMatrix<_T, SparseFormat::CSC>&&>(a)), _ar(_a), _b(b), _c(_n + _m), _opt(options),
+			_dense(false), _flops(0), _status(SimplexStatus::IterationLimit), _iter(0) {
+			if (b.size() != _m || c.size() != _n) throw Error(EDOM, "Dimension mismatch");
+			for (size_t j = 0; j < _n; ++j) _c[j] = -c[j];
+			_symbolic();
+		}
+		template <class _A> InteriorPoint(const _A& a, const DynamicVector<_T>& b, const DynamicVector<_T>& c,
+			const InteriorPointOptions& options = {}) : InteriorPoint(SparseMatrix<_T, SparseFormat::CSC>(a), b, c, options) {}
+		size_t rows() const noexcept { return _m; }
+		size_t columns() const noexcept { return _n; }
+		//True if the normal equations are factored as a dense matrix
+		bool dense() const noexcept { return _dense; }
+		//Optimal within options.tolerance. Infeasible or Unbounded when the dual or the
+		//primal iterates run off while the other side converges, which strongly suggests
+		//but does not prove it; linearProgram settles such cases by the simplex method
+		SimplexStatus solve() {
+			const size_t N = _n + _m;
+			const _T tol = _opt.tolerance, nb = 1 + _norm(_b), nc = 1 + _norm(_c), big = 1e10;
+			_start();
+			DynamicVector<_T> d(N), rzw(N), dz(N), dy(_m), dw(N), az(N), ay(_m), aw(N);
+			for (_iter = 0; _iter < _opt.maxIterations; ++_iter) {
+				DynamicVector<_T> rb = _mul(_z), rc = _mulT(_y);
+				for (size_t i = 0; i < _m; ++i) rb[i] = _b[i] - rb[i];
+				for (size_t j = 0; j < N; ++j) rc[j] = _c[j] - rc[j] - _w[j];
+				const _T pr = _norm(rb) / nb, dr = _norm(rc) / nc, primal = _dot(_c, _z), dual = _dot(_b, _y);
+				if (pr <= tol && dr <= tol && abs(primal - dual) <= tol * (1 + abs(primal))) return _status = SimplexStatus::Optimal;
+				if (dr <= tol && _norm(_z) > big * nb) return _status = SimplexStatus::Unbounded;
+				if (pr <= tol && _norm(_y) > big * nc) return _status = SimplexStatus::Infeasible;
+				if (_norm(_y) > big * big * nc || _norm(_z) > big * big * nb) break;
+				const _T mu = _dot(_z, _w) / N;
+				for (size_t j = 0; j < N; ++j) d[j] = min(max(_z[j] / _w[j], _T(1e-30)), _T(1e30)), rzw[j] = -_z[j] * _w[j];
+				_factor(d);
+				_direction(rb, rc, rzw, d, az, ay, aw);
+				const _T ap = _step(_z, az), ad = _step(_w, aw);
+				_T affine = 0;
+				for (size_t j = 0; j < N; ++j) affine += (_z[j] + ap * az[j]) * (_w[j] + ad * aw[j]);
+				const _T r = affine / N / mu, sigma = r * r * r;
+				for (size_t j = 0; j < N; ++j) rzw[j] = sigma * mu - _z[j] * _w[j] - az[j] * aw[j];
+				_direction(rb, rc, rzw, d, dz, dy, dw);
+				const _T sp = min(_T(1), _opt.stepFactor * _step(_z, dz)), sd = min(_T(1), _opt.stepFactor * _step(_w, dw));
+				if (max(sp, sd) < 1e-10) break; //Stalled
+				for (size_t j = 0; j < N; ++j) _z[j] += sp * dz[j], _w[j] += sd * dw[j];
+				for (size_t i = 0; i < _m; ++i) _y[i] += sd * dy[i];
+			}
+			return _status = SimplexStatus::IterationLimit;
+		}
+		SimplexStatus status() const noexcept { return _status; }
+		size_t iterations() const noexcept { return _iter; }
+		_T objective() const noexcept {
+			_T y = 0;
+			for (size_t j = 0; j < _n; ++j) y -= _c[j] * _z[j];
+			return y;
+		}
+		DynamicVector<_T> solution() const {
+			DynamicVector<_T> x(_n);
+			for (size_t j = 0; j < _n; ++j) x[j] = _z[j];
+			return x;
+		}
+		//Shadow prices of the rows, as RevisedSimplex::duals
+		DynamicVector<_T> duals() const {
+			DynamicVector<_T> y(_m);
+			for (size_t i = 0; i < _m; ++i) y[i] = -_y[i];
+			return y;
+		}
+	};
+	template <class _A, class _T> InteriorPoint(const _A&, const DynamicVector<_T>&, const DynamicVector<_T>&,
+		const InteriorPointOptions & = {}) -> InteriorPoint<_T>;
+	enum class LPMethod { Simplex, InteriorPoint };
+	//Solves by the method asked for. The interior point, if optimal, is crossed over to a
+	//basis the simplex method finishes from; any other outcome is settled by the simplex
+	//method from scratch
+	template <class _T, class _A> RevisedSimplex<_T> _linearProgram(const _A& a, const DynamicVector<_T>& b,
+		const DynamicVector<_T>& c, LPMethod method) {
+		const SparseMatrix<_T, SparseFormat::CSC> m(a);
+		RevisedSimplex<_T> lp(m, b, c);
+		if (method == LPMethod::InteriorPoint) {
+			InteriorPoint<_T> ip(m, b, c);
+			if (ip.solve() == SimplexStatus::Optimal) lp.crossover(ip.solution(), ip.duals());
+		}
+		lp.solve();
+		return lp;
+	}
+	// Maximize y=sum(c*x) assuming sum(a*x)<=b and x>=0 for a runtime-sized dense or sparse a,
+	// by the revised simplex method, or by the interior-point method and a crossover to a basis
+	// Return value: optimum x's, NaNs if there is none
+	template <class _T, class _S, bool C> DynamicVector<_T> linearProgram(const DynamicMatrix<_S, C>& a,
+		const DynamicVector<_T>& b, const DynamicVector<_T>& c, LPMethod method = LPMethod::Simplex) {
+		const RevisedSimplex<_T> lp = _linearProgram(a, b, c, method);
+		if (lp.status() == SimplexStatus::Optimal) return lp.solution();
+		DynamicVector<_T> x(c.size());
+		for (_T& t : x) t = nan();
+		return x;
+	}
+	template <class _T, class _S, SparseFormat F> DynamicVector<_T> linearProgram(const SparseMatrix<_S, F>& a,
+		const DynamicVector<_T>& b, const DynamicVector<_T>& c, LPMethod method = LPMethod::Simplex) {
+		const RevisedSimplex<_T> lp = _linearProgram(a, b, c, method);
+		if (lp.status() == SimplexStatus::Optimal) return lp.solution();
+		DynamicVector<_T> x(c.size());
+		for (_T& t : x) t = nan();
+		return x;
+	}
+	// Branch and bound
+	struct BranchOptions {
+		double integralityTolerance = 1e-6; //Largest distance from an integer an integer variable may keep
+		double gapTolerance = 1e-6; //Nodes whose bound beats the incumbent by less, relatively, are pruned
+		size_t maxNodes = 0; //0 for no limit
+		size_t cutRounds = 5; //Rounds of Gomory cuts at the root
+		size_t cutsPerRound = 50;
+		size_t threads = 0; //Node solvers, 0 for one per thread of the pool
+		SimplexOptions simplex; //For the relaxations
+	};
+	//Maximizes c*x over A*x <= b, x >= 0 with the flagged variables integer, all of them
+	//at first. The root relaxation is tightened by rounds of Gomory mixed-integer cuts,
+	//then the tree is searched by a team of node solvers with a copy of the LP each.
+	//A solver dives: of the two children of its node it keeps the one on the side the
+	//branching variable rounds to, which only changes a bound, so the dual simplex method
+	//goes on from the parent's basis, and queues the other with the parent's basis and
+	//objective. When the dive ends it takes the queued node of best bound.
+	template <RealArithmetic _T = double> class BranchAndBound {
+		static constexpr size_t _NONE = size_t(-1);
+		//Bound from the parent, bound changes from the root as variable and new bounds,
+		//and the parent's optimal basis
+		struct _Node {
+			_T bound;
+			size_t depth;
+			DynamicVector<size_t> var;
+			DynamicVector<_T> lo, hi;
+			typename RevisedSimplex<_T>::Basis basis;
+		};
+		RevisedSimplex<_T> _lp;
+		DynamicVector<unsigned char> _integer;
+		BranchOptions _opt;
+		DynamicVector<_T> _best;
+		_T _incumbent;
+		SimplexStatus _status;
+		//Max-heap of queued nodes by bound; _mutex guards it, the incumbent and the solvers
+		//busy with a node
+		_Node** _heap;
+		size_t _size, _cap, _active;
+		::std::atomic<size_t> _nodes;
+		::std::mutex _mutex;
+		bool _stop, _incomplete;
+		void _push(_Node* node) {
+			if (_size == _cap) {
+				_Node** h = new _Node*[_cap = _cap ? 2 * _cap : 64];
+				for (size_t k = 0; k < _size; ++k) h[k] = _heap[k];
+				delete[] _heap, _heap = h;
+			}
+			size_t k = _size++;
+			for (; k && _heap[(k - 1) / 2]->bound < node->bound; k = (k - 1) / 2) _heap[k] = _heap[(k - 1) / 2];
+			_heap[k] = node;
+		}
+		_Node* _pop() {
+			_Node* const top = _heap[0], * const last = _heap[--_size];
+			size_t k = 0;
+			for (size_t c; (c = 2 * k + 1) < _size; k = c) {
+				if (c + 1 < _size && _heap[c]->bound < _heap[c + 1]->bound) ++c;
+				if (_heap[c]->bound <= last->bound) break;
+				_heap[k] = _heap[c];
+			}
+			if (_size) _heap[k] = last;
+			return top;
+		}
+		//Bounds a node must beat to be worth solving; under _mutex
+		_T _cutoff() const noexcept {
+			return isfinite(_incumbent) ? _incumbent + _opt.gapTolerance * max(_T(1), abs(_incumbent)) : _incumbent;
+		}
+		static void _append(_Node& node, size_t j, _T lo, _T hi) {
+			if (node.depth == node.var.size()) {
+				const size_t cap = node.depth ? 2 * node.depth : 8;
+				DynamicVector<size_t> var(cap);
+				DynamicVector<_T> l(cap), h(cap);
+				for (size_t k = 0; k < node.depth; ++k) var[k] = node.var[k], l[k] = node.lo[k], h[k] = node.hi[k];
+				node.var = static_cast<DynamicVector<size_t>&&>(var);
+				node.lo = static_cast<DynamicVector<_T>&&>(l), node.hi = static_cast<DynamicVector<_T>&&>(h);
+			}
+			node.var[node.depth] = j, node.lo[node.depth] = lo, node.hi[node.depth++] = hi;
+		}
+		//One node solver, lo and hi the bounds at the root
+		void _work(RevisedSimplex<_T>& lp, const DynamicVector<_T>& lo, const DynamicVector<_T>& hi) {
+			const size_t n = lp.columns();
+			_Node* node = nullptr;
+			for (;;) {
+				if (!node) {
+					{
+						const ::std::lock_guard<::std::mutex> lock(_mutex);
+						while (_size && !_stop) {
+							node = _pop();
+							if (node->bound > _cutoff()) break;
+							delete node, node = nullptr;
+						}
+						if (node) ++_active;
+						else if (!_active || _stop) return;
+					}
+					if (!node) {
+						::std::this_thread::yield();
+						continue;
+					}
+					for (size_t j = 0; j < n; ++j) lp.setBounds(j, lo[j], hi[j]);
+					for (size_t k = 0; k < node->depth; ++k) lp.setBounds(node->var[k], node->lo[k], node->hi[k]);
+					lp.setBasis(node->basis);
+				}
+				const SimplexStatus s = lp.solve();
+				const size_t count = ++_nodes;
+				const _T z = lp.objective();
+				const DynamicVector<_T> x = lp.solution();
+				size_t j = _NONE;
+				_T worst = _opt.integralityTolerance;
+				if (s == SimplexStatus::Optimal) for (size_t k = 0; k < n; ++k) if (_integer[k]) {
+					const _T f = x[k] - floor(x[k]), d = min(f, 1 - f);
+					if (worst < d) worst = d, j = k;
+				}
+				const ::std::lock_guard<::std::mutex> lock(_mutex);
+				if (_opt.maxNodes && count >= _opt.maxNodes) _stop = true;
+				if (s != SimplexStatus::Optimal) _incomplete |= s != SimplexStatus::Infeasible;
+				else if (z > _cutoff() && j == _NONE) _incumbent = z, _best = x;
+				else if (z > _cutoff() && !_stop) { //Branch on the most fractional variable
+					const _T fl = floor(x[j]), l = lp.lowerBound(j), u = lp.upperBound(j);
+					const bool up = x[j] - fl >= 0.5;
+					_Node* const other = new _Node{ z, node->depth, node->var, node->lo, node->hi, lp.basis() };
+					_append(*other, j, up ? l : fl + 1, up ? fl : u);
+					_append(*node, j, up ? fl + 1 : l, up ? u : fl);
+					lp.setBounds(j, up ? fl + 1 : l, up ? u : fl);
+					_push(other);
+					continue;
+				}
+				delete node, node = nullptr;
+				--_active;
+			}
+		}
+	public:
+		template <class _A> BranchAndBound(const _A& a, const DynamicVector<_T>& b, const DynamicVector<_T>& c,
+			const BranchOptions& options = {}) : _lp(a, b, c, options.simplex), _integer(c.size(), 1), _opt(options),
+			_best(c.size()), _incumbent(-infinity<_T>()), _status(SimplexStatus::IterationLimit), _heap(nullptr),
+			_size(0), _cap(0), _active(0), _nodes(0), _stop(false), _incomplete(false) {}
+		BranchAndBound(const BranchAndBound&) = delete;
+		BranchAndBound& operator=(const BranchAndBound&) = delete;
+		~BranchAndBound() {
+			while (_size) delete _pop();
+			delete[] _heap;
+		}
+		size_t rows() const noexcept { return _lp.rows(); }
+		size_t columns() const noexcept { return _lp.columns(); }
+		void setInteger(size_t j, bool integer = true) {
+			if (j >= _integer.size()) throw Error(ERANGE, "Out of range");
+			_integer[j] = integer;
+		}
+		void setBounds(size_t j, _T lo, _T hi) { _lp.setBounds(j, lo, hi); }
+		void setRowBounds(size_t i, _T lo, _T hi) { _lp.setRowBounds(i, lo, hi); }
+		//Optimal if the search closed, IterationLimit if it stopped at options.maxNodes or
+		//lost a relaxation to its iteration limit, with the best solution found if any
+		SimplexStatus solve() {
+			const size_t n = _lp.columns();
+			const _T tol = _opt.integralityTolerance, inf = infinity<_T>();
+			_incumbent = -inf, _nodes = 0, _stop = _incomplete = false;
+			for (_T& t : _best) t = nan();
+			for (size_t j = 0; j < n; ++j) if (_integer[j]) {
+				_T lo = _lp.lowerBound(j), hi = _lp.upperBound(j);
+				if (isfinite(lo)) lo = ceil(lo - tol);
+				if (isfinite(hi)) hi = floor(hi + tol);
+				if (hi < lo) return _status = SimplexStatus::Infeasible;
+				_lp.setBounds(j, lo, hi);
+			}
+			SimplexStatus s = _lp.solve();
+			for (size_t round = 0; round < _opt.cutRounds && s == SimplexStatus::Optimal; ++round) {
+				const DynamicVector<_T> x = _lp.solution();
+				DynamicVector<size_t> ptr(_opt.cutsPerRound + 1), idx;
+				DynamicVector<_T> val, lo(_opt.cutsPerRound), hi(_opt.cutsPerRound, inf), pi;
+				size_t k = 0, nz = 0;
+				_T pi0;
+				for (size_t j = 0; j < n && k < _opt.cutsPerRound; ++j) {
+					if (!_integer[j] || !_lp.gomoryCut(j, _integer, pi, pi0)) continue;
+					_T t = 0;
+					for (size_t q = 0; q < n; ++q) t += pi[q] * x[q];
+					if (t > pi0 - 1e-6) continue;
+					for (size_t q = 0; q < n; ++q) if (pi[q]) {
+						if (nz == idx.size()) {
+							DynamicVector<size_t> i(2 * nz + n);
+							DynamicVector<_T> v(2 * nz + n);
+							for (size_t p = 0; p < nz; ++p) i[p] = idx[p], v[p] = val[p];
+							idx = static_cast<DynamicVector<size_t>&&>(i), val = static_cast<DynamicVector<_T>&&>(v);
+						}
+						idx[nz] = q, val[nz++] = pi[q];
+					}
+					lo[k] = pi0, ptr[++k] = nz;
+				}
+				if (!k) break;
+				DynamicVector<size_t> p(k + 1), i(nz);
+				DynamicVector<_T> v(nz), l(k), h(k, inf);
+				for (size_t r = 0; r <= k; ++r) p[r] = ptr[r];
+				for (size_t r = 0; r < k; ++r) l[r] = lo[r];
+				for (size_t q = 0; q < nz; ++q) i[q] = idx[q], v[q] = val[q];
+				const _T before = _lp.objective();
+				_lp.addRows(SparseMatrix<_T, SparseFormat::CSR>(k, n, static_cast<DynamicVector<size_t>&&>(p),
+					static_cast<DynamicVector<size_t>&&>(i), static_cast<DynamicVector<_T>&&>(v)), l, h);
+				s = _lp.solve();
+				if (s == SimplexStatus::Optimal && before - _lp.objective() < 1e-4 * max(_T(1), abs(before))) break;
+			}
+			if (s != SimplexStatus::Optimal) return _status = s;
+			DynamicVector<_T> lo(n), hi(n);
+			for (size_t j = 0; j < n; ++j) lo[j] = _lp.lowerBound(j), hi[j] = _lp.upperBound(j);
+			_push(new _Node{ _lp.objective(), 0, {}, {}, {}, _lp.basis() });
+			const size_t t = _opt.threads ? _opt.threads : threadPool().size();
+			parallelFor(0, t, 1, [&](size_t k0, size_t k1) {
+				for (size_t k = k0; k < k1; ++k) {
+					RevisedSimplex<_T> lp(_lp);
+					try {
+						_work(lp, lo, hi);
+					} catch (...) {
+						const ::std::lock_guard<::std::mutex> lock(_mutex);
+						_stop = true;
+						throw;
+					}
+				}
+			});
+			while (_size) delete _pop();
+			if (_stop || _incomplete) return _status = SimplexStatus::IterationLimit;
+			return _status = _incumbent == -inf ? SimplexStatus::Infeasible : SimplexStatus::Optimal;
+		}
+		SimplexStatus status() const noexcept { return _status; }
+		//Objective of the best solution found, -infinity if none
+		_T objective() const noexcept { return _incumbent; }
+		const DynamicVector<_T>& solution() const noexcept { return _best; }
+		//Nodes solved by the last solve
+		size_t nodes() const noexcept { return _nodes; }
+	};
+	template <class _A, class _T> BranchAndBound(const _A&, const DynamicVector<_T>&, const DynamicVector<_T>&,
+		const BranchOptions & = {}) -> BranchAndBound<_T>;
+	// Maximize y=sum(c*x) assuming sum(a*x)<=b, x>=0 and x integer for a runtime-sized dense
+	// or sparse a by branch and bound
+	// Return value: optimum x's, NaNs if there is none
+	template <class _T, class _S, bool C>
+	DynamicVector<_T> integerProgram(const DynamicMatrix<_S, C>& a, const DynamicVector<_T>& b, const DynamicVector<_T>& c) {
+		BranchAndBound<_T> ip(a, b, c);
+		ip.solve();
+		return ip.solution();
+	}
+	template <class _T, class _S, SparseFormat F>
+	DynamicVector<_T> integerProgram(const SparseMatrix<_S, F>& a, const DynamicVector<_T>& b, const DynamicVector<_T>& c) {
+		BranchAndBound<_T> ip(a, b, c);
+		ip.solve();
+		return ip.solution();
 	}
 }
 #else
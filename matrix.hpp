@@ -2,11 +2,13 @@
 #ifndef _MATHLAB_MATRIX_
 #define _MATHLAB_MATRIX_ 1
 #include "vector.hpp"
+#include "kernel.hpp"
 #include <initializer_list>
 namespace Mathlab {
+	template <class _T, size_t M, size_t N, class _Op, class _L, class _R> class MatrixExpr;
 	template <Arithmetic _T, size_t M, size_t N = M> class Matrix {
 		static_assert(M > 0 && N > 0 && NumericType<_T>);
-		_T _data[N][M];
+		_T _data[M][N];
 		typedef struct { size_t a, b; } _index_t;
 	public:
 		typedef _T ValueType;
@@ -31,6 +33,11 @@ namespace Mathlab {
 				_data[i][j] = other[i][j];
 		}
 		constexpr Matrix(const Matrix& other) noexcept = default;
+		template <class _S, class _Op, class _L, class _R>
+		constexpr Matrix(const MatrixExpr<_S, M, N, _Op, _L, _R>& e) noexcept : _data{ {0} } {
+			for (size_t i = 0; i < M; ++i) for (size_t j = 0; j < N; ++j)
+				_data[i][j] = e.at(i * N + j);
+		}
 		template <Arithmetic _S, size_t P, size_t Q>
 		explicit constexpr Matrix(const Matrix<_S, P, Q>& other) noexcept
 			requires (P <= M && Q <= N) {
@@ -59,10 +66,10 @@ namespace Mathlab {
 		constexpr const _T* operator[](size_t z) const noexcept {
 			return _data[z];
 		}
-		constexpr _T* operator[](_index_t z) noexcept {
+		constexpr _T& operator[](_index_t z) noexcept {
 			return _data[z.a][z.b];
 		}
-		constexpr const _T* operator[](_index_t z) const noexcept {
+		constexpr const _T& operator[](_index_t z) const noexcept {
 			return _data[z.a][z.b];
 		}
 #ifdef __cpp_multidimensional_subscript
@@ -73,24 +80,55 @@ namespace Mathlab {
 			return _data[a][b];
 		}
 #endif
+		//Element-wise expressions may refer to the Matrix they are assigned to
+		template <class _S, class _Op, class _L, class _R>
+		constexpr Matrix& operator=(const MatrixExpr<_S, M, N, _Op, _L, _R>& e) noexcept {
+			for (size_t i = 0; i < M; ++i) for (size_t j = 0; j < N; ++j)
+				_data[i][j] = e.at(i * N + j);
+			return *this;
+		}
+		template <class _S, class _Op, class _L, class _R>
+		constexpr Matrix& operator+=(const MatrixExpr<_S, M, N, _Op, _L, _R>& e) noexcept {
+			for (size_t i = 0; i < M; ++i) for (size_t j = 0; j < N; ++j)
+				_data[i][j] += e.at(i * N + j);
+			return *this;
+		}
+		template <class _S, class _Op, class _L, class _R>
+		constexpr Matrix& operator-=(const MatrixExpr<_S, M, N, _Op, _L, _R>& e) noexcept {
+			for (size_t i = 0; i < M; ++i) for (size_t j = 0; j < N; ++j)
+				_data[i][j] -= e.at(i * N + j);
+			return *this;
+		}
 		template <Arithmetic _S>
 		constexpr Matrix& operator+=(const Matrix<_S, M, N>& other) noexcept {
+			if constexpr (SameAs<_T, _S> && Kernel::Vectorizable<_T>)
+				if (!::std::is_constant_evaluated())
+					return Kernel::add(begin(), other.begin(), M * N), *this;
 			for (size_t i = 0; i < M; ++i) for (size_t j = 0; j < N; ++j)
-				_data[i][j] += other._data[i][j];
+				_data[i][j] += other[i][j];
 			return *this;
 		}
 		template <Arithmetic _S>
 		constexpr Matrix& operator-=(const Matrix<_S, M, N>& other) noexcept {
+			if constexpr (SameAs<_T, _S> && Kernel::Vectorizable<_T>)
+				if (!::std::is_constant_evaluated())
+					return Kernel::sub(begin(), other.begin(), M * N), *this;
 			for (size_t i = 0; i < M; ++i) for (size_t j = 0; j < N; ++j)
-				_data[i][j] -= other._data[i][j];
+				_data[i][j] -= other[i][j];
 			return *this;
 		}
 		template <Arithmetic _S> constexpr Matrix& operator*=(const _S& s) noexcept {
+			if constexpr (Kernel::VectorizableWith<_T, _S>)
+				if (!::std::is_constant_evaluated())
+					return Kernel::mul(begin(), _T(s), M * N), *this;
 			for (size_t i = 0; i < M; ++i) for (size_t j = 0; j < N; ++j)
 				_data[i][j] *= s;
 			return *this;
 		}
 		template <Arithmetic _S> constexpr Matrix& operator/=(const _S& s) noexcept {
+			if constexpr (Kernel::VectorizableWith<_T, _S>)
+				if (!::std::is_constant_evaluated())
+					return Kernel::div(begin(), _T(s), M * N), *this;
 			for (size_t i = 0; i < M; ++i) for (size_t j = 0; j < N; ++j)
 				_data[i][j] /= s;
 			return *this;
@@ -167,6 +205,54 @@ namespace Mathlab {
 			for (size_t j = 1; j < M * N; ++j) v[j] = _data[0][j];
 		}
 	};
+	template <class _T, size_t M, size_t N> inline constexpr bool _isLeaf<Matrix<_T, M, N>> = true;
+	//Lazy element-wise node over M*N operands, see the Vector counterpart
+	template <class _T, size_t M, size_t N, class _Op, class _L, class _R> class MatrixExpr {
+		_L _l;
+		_R _r;
+		typedef struct { size_t a, b; } _index_t;
+	public:
+		typedef _T ValueType;
+		static constexpr size_t rows = M;
+		static constexpr size_t columns = N;
+		constexpr MatrixExpr(const _Plain<_L>& l, const _Plain<_R>& r) noexcept : _l(l), _r(r) {}
+		constexpr _T at(size_t z) const noexcept {
+			return _T(_Op::apply(_element(_l, z), _element(_r, z)));
+		}
+		constexpr _T operator[](_index_t z) const noexcept {
+			return at(z.a * N + z.b);
+		}
+		constexpr Matrix<_T, M, N> eval() const noexcept {
+			return *this;
+		}
+		template <class _S> constexpr bool operator==(const _S& rhs) const noexcept requires (!_Scalar<_S>) {
+			for (size_t z = 0; z < M * N; ++z) if (at(z) != _element(rhs, z)) return false;
+			return true;
+		}
+	};
+	template <class _T, size_t M, size_t N, class _Op, class _L, class _R>
+	inline constexpr bool _isExpression<MatrixExpr<_T, M, N, _Op, _L, _R>> = true;
+	template <class _T, size_t M, size_t N, class _Op, class _L, class _R>
+	Matrix(const MatrixExpr<_T, M, N, _Op, _L, _R>&) -> Matrix<_T, M, N>;
+	template <class _T, size_t M, size_t N> class TransposedView;
+	template <class _T, size_t M, size_t N> inline constexpr bool _isExpression<TransposedView<_T, M, N>> = true;
+	//Matrix, matrix expression or TransposedView
+	template <class _T> inline constexpr bool _isMatrix = false;
+	template <class _T, size_t M, size_t N> inline constexpr bool _isMatrix<Matrix<_T, M, N>> = true;
+	template <class _T, size_t M, size_t N, class _Op, class _L, class _R>
+	inline constexpr bool _isMatrix<MatrixExpr<_T, M, N, _Op, _L, _R>> = true;
+	template <class _T, size_t M, size_t N> inline constexpr bool _isMatrix<TransposedView<_T, M, N>> = true;
+	template <class _T, class _S> concept _Matrices = _isMatrix<_T> && _isMatrix<_S> &&
+		_T::rows == _S::rows && _T::columns == _S::columns;
+	//Matrices of which at least one is a node or a TransposedView
+	template <class _T, class _S> concept _LazyMatrices = _Matrices<_Plain<_T>, _Plain<_S>>
+		&& (_isExpression<_Plain<_T>> || _isExpression<_Plain<_S>>);
+	template <class _T> concept _LazyMatrix = _isMatrix<_Plain<_T>> && _isExpression<_Plain<_T>>;
+	template <class _T> requires (_isLeaf<_Plain<_T>> && _isMatrix<_Plain<_T>>)
+	inline constexpr auto lazy(_T&& m) noexcept {
+		typedef _Plain<_T> _M;
+		return MatrixExpr<typename _M::ValueType, _M::rows, _M::columns, _First, _Operand<_T>, int>(m, 0);
+	}
 	template <class _T, class _S, size_t M, size_t N> inline constexpr auto
 		operator+(const Matrix<_T, M, N>& lhs, const Matrix<_S, M, N>& rhs) noexcept {
 		Matrix<CommonType<_T, _S>, M, N> m = lhs;
@@ -177,16 +263,16 @@ namespace Mathlab {
 		Matrix<CommonType<_T, _S>, M, N> m = lhs;
 		return m -= rhs;
 	}
-	template <class _T, class _S, size_t M, size_t N> inline constexpr auto
+	template <class _T, class _S, size_t M, size_t N> requires _Scalar<_S> inline constexpr auto
 		operator*(const Matrix<_T, M, N>& lhs, const _S& rhs) noexcept {
 		Matrix<CommonType<_T, _S>, M, N> m = lhs;
 		return m *= rhs;
 	}
-	template <class _T, class _S, size_t M, size_t N> inline constexpr auto
+	template <class _T, class _S, size_t M, size_t N> requires _Scalar<_T> inline constexpr auto
 		operator*(const _T& lhs, const Matrix<_S, M, N>& rhs) noexcept {
 		return rhs * lhs;
 	}
-	template <class _T, class _S, size_t M, size_t N> inline constexpr auto
+	template <class _T, class _S, size_t M, size_t N> requires _Scalar<_S> inline constexpr auto
 		operator/(const Matrix<_T, M, N>& lhs, const _S& rhs) noexcept {
 		Matrix<CommonType<_T, _S>, M, N> m = lhs;
 		return m /= rhs;
@@ -199,14 +285,61 @@ namespace Mathlab {
 	inline constexpr Matrix<_T, M, N> operator-(const Matrix<_T, M, N>& m) noexcept {
 		return m * -1;
 	}
+	template <class _T, class _S> requires _LazyMatrices<_T, _S> inline constexpr auto
+		operator+(_T&& lhs, _S&& rhs) noexcept {
+		typedef _Plain<_T> _A;
+		typedef CommonType<typename _A::ValueType, typename _Plain<_S>::ValueType> _R;
+		return MatrixExpr<_R, _A::rows, _A::columns, _Plus, _Operand<_T>, _Operand<_S>>(lhs, rhs);
+	}
+	template <class _T, class _S> requires _LazyMatrices<_T, _S> inline constexpr auto
+		operator-(_T&& lhs, _S&& rhs) noexcept {
+		typedef _Plain<_T> _A;
+		typedef CommonType<typename _A::ValueType, typename _Plain<_S>::ValueType> _R;
+		return MatrixExpr<_R, _A::rows, _A::columns, _Minus, _Operand<_T>, _Operand<_S>>(lhs, rhs);
+	}
+	template <class _T, class _S> requires (_LazyMatrix<_T> && _Scalar<_S>) inline constexpr auto
+		operator*(const _T& lhs, const _S& rhs) noexcept {
+		typedef CommonType<typename _T::ValueType, _S> _R;
+		return MatrixExpr<_R, _T::rows, _T::columns, _Times, _T, _S>(lhs, rhs);
+	}
+	template <class _T, class _S> requires (_Scalar<_T> && _LazyMatrix<_S>) inline constexpr auto
+		operator*(const _T& lhs, const _S& rhs) noexcept {
+		return rhs * lhs;
+	}
+	template <class _T, class _S> requires (_LazyMatrix<_T> && _Scalar<_S>) inline constexpr auto
+		operator/(const _T& lhs, const _S& rhs) noexcept {
+		typedef CommonType<typename _T::ValueType, _S> _R;
+		return MatrixExpr<_R, _T::rows, _T::columns, _Divide, _T, _S>(lhs, rhs);
+	}
+	template <class _T> requires _LazyMatrix<_T> inline constexpr auto operator+(const _T& m) noexcept {
+		return MatrixExpr<typename _T::ValueType, _T::rows, _T::columns, _Times, _T, int>(m, 1);
+	}
+	template <class _T> requires _LazyMatrix<_T> inline constexpr auto operator-(const _T& m) noexcept {
+		return MatrixExpr<typename _T::ValueType, _T::rows, _T::columns, _Times, _T, int>(m, -1);
+	}
+	//Products are not element-wise, so expression operands are evaluated first
+	template <class _T> concept _Product = _isMatrix<_T> || _vectorLength<_T> > 0;
+	template <class _T, class _S> requires ((_isExpression<_T> || _isExpression<_S>) &&
+		_Product<_T> && _Product<_S> && !_Vectors<_T, _S>)
+	inline constexpr auto operator*(const _T& lhs, const _S& rhs) noexcept {
+		return _evaluate(lhs) * _evaluate(rhs);
+	}
 	template <class _T, class _S, size_t M, size_t N, size_t P>
 	inline constexpr Matrix<Multiplies<_T, _S>, M, P>
 		operator*(const Matrix<_T, M, N>& lhs, const Matrix<_S, N, P>& rhs) noexcept {
-		Matrix<long double, M, P> m{ 0 };
-		for (size_t i = 0; i < M; ++i)
-			for (size_t k = 0; k < P; ++k)
-				for (size_t j = 0; j < N; ++j)
-					m[{i, k}] += lhs[i][j] * rhs[{j, k}];
+		typedef Multiplies<_T, _S> _R;
+		Matrix<_R, M, P> m{ 0 };
+		if constexpr (SameAs<_T, _S> && EitherOf<_T, float, double>) {
+			if (!::std::is_constant_evaluated()) {
+				Kernel::gemm<M, N, P>(lhs.begin(), rhs.begin(), m.begin());
+				return m;
+			}
+		}
+		for (size_t i = 0; i < M; ++i) //i-k-j order walks rhs and m along rows
+			for (size_t j = 0; j < N; ++j) {
+				const _R t = lhs[i][j];
+				for (size_t k = 0; k < P; ++k) m[i][k] += t * rhs[j][k];
+			}
 		return m;
 	}
 	template <class _T, class _S, size_t M, size_t N>
@@ -271,33 +404,415 @@ namespace Mathlab {
 	template <class _T, size_t M, size_t N>
 	inline constexpr Matrix<_T, N, M> transpose(const Matrix<_T, M, N>& m) noexcept {
 		Matrix<_T, N, M> n{ 0 };
-		for (size_t i = 1; i <= M; ++i)
-			for (size_t j = 1; j <= N; ++j)
-				n[{j, i}] = m[i][j];
+		Kernel::transpose(M, N, m.begin(), N, n.begin(), M);
 		return n;
 	}
 	template <class _T, size_t M, size_t N>
 	inline constexpr Matrix<_T, N, M> transjugate(const Matrix<_T, M, N>& m) noexcept {
 		Matrix<_T, N, M> n{ 0 };
-		for (size_t i = 1; i <= M; ++i)
-			for (size_t j = 1; j <= N; ++j)
-				n[{j, i}] = conj(m[i][j]);
+		Kernel::transpose<true>(M, N, m.begin(), N, n.begin(), M);
 		return n;
 	}
+	template <class _T, size_t N>
+	inline constexpr Matrix<_T, N, N>& transposeInPlace(Matrix<_T, N, N>& m) noexcept {
+		Kernel::transposeSquare(N, m.begin(), N);
+		return m;
+	}
+	//m^T without copying: reads m with swapped coordinates, and operator* hands m's own
+	//storage to gemm. Only valid while m lives
+	template <class _T, size_t M, size_t N> class TransposedView {
+		const Matrix<_T, M, N>& _m;
+		typedef struct { size_t a, b; } _index_t;
+	public:
+		typedef _T ValueType;
+		static constexpr size_t rows = N;
+		static constexpr size_t columns = M;
+		constexpr explicit TransposedView(const Matrix<_T, M, N>& m) noexcept : _m(m) {}
+		constexpr const Matrix<_T, M, N>& base() const noexcept { return _m; }
+		constexpr const _T& operator[](_index_t z) const noexcept { return _m[z.b][z.a]; }
+		constexpr const _T& at(size_t z) const noexcept { return _m[z % M][z / M]; }
+		constexpr Matrix<_T, N, M> eval() const noexcept { return transpose(_m); }
+		constexpr operator Matrix<_T, N, M>() const noexcept { return transpose(_m); }
+	};
+	template <class _T, size_t M, size_t N>
+	inline constexpr TransposedView<_T, M, N> transposed(const Matrix<_T, M, N>& m) noexcept {
+		return TransposedView<_T, M, N>(m);
+	}
+	template <class _T, class _S, size_t M, size_t N, size_t P>
+	inline constexpr Matrix<Multiplies<_T, _S>, N, P>
+		operator*(const TransposedView<_T, M, N>& lhs, const Matrix<_S, M, P>& rhs) noexcept {
+		typedef Multiplies<_T, _S> _R;
+		const Matrix<_T, M, N>& a = lhs.base();
+		Matrix<_R, N, P> m{ 0 };
+		if constexpr (SameAs<_T, _S> && EitherOf<_T, float, double>) {
+			if (!::std::is_constant_evaluated()) {
+				Kernel::gemm<N, M, P, true>(a.begin(), rhs.begin(), m.begin());
+				return m;
+			}
+		}
+		for (size_t i = 0; i < M; ++i) //Row i of a and rhs is a rank-1 update of m
+			for (size_t k = 0; k < N; ++k) {
+				const _R t = a[i][k];
+				for (size_t j = 0; j < P; ++j) m[k][j] += t * rhs[i][j];
+			}
+		return m;
+	}
+	template <class _T, class _S, size_t M, size_t N, size_t P>
+	inline constexpr Matrix<Multiplies<_T, _S>, M, P>
+		operator*(const Matrix<_T, M, N>& lhs, const TransposedView<_S, P, N>& rhs) noexcept {
+		typedef Multiplies<_T, _S> _R;
+		const Matrix<_S, P, N>& b = rhs.base();
+		Matrix<_R, M, P> m{ 0 };
+		if constexpr (SameAs<_T, _S> && EitherOf<_T, float, double>) {
+			if (!::std::is_constant_evaluated()) {
+				Kernel::gemm<M, N, P, false, true>(lhs.begin(), b.begin(), m.begin());
+				return m;
+			}
+		}
+		for (size_t i = 0; i < M; ++i) //Rows of lhs and b are dotted directly
+			for (size_t j = 0; j < P; ++j) {
+				_R t = 0;
+				for (size_t k = 0; k < N; ++k) t += lhs[i][k] * b[j][k];
+				m[i][j] = t;
+			}
+		return m;
+	}
+	template <class _T, class _S, size_t M, size_t N, size_t P>
+	inline constexpr Matrix<Multiplies<_T, _S>, M, P>
+		operator*(const TransposedView<_T, N, M>& lhs, const TransposedView<_S, P, N>& rhs) noexcept {
+		typedef Multiplies<_T, _S> _R;
+		const Matrix<_T, N, M>& a = lhs.base();
+		const Matrix<_S, P, N>& b = rhs.base();
+		Matrix<_R, M, P> m{ 0 };
+		if constexpr (SameAs<_T, _S> && EitherOf<_T, float, double>) {
+			if (!::std::is_constant_evaluated()) {
+				Kernel::gemm<M, N, P, true, true>(a.begin(), b.begin(), m.begin());
+				return m;
+			}
+		}
+		for (size_t i = 0; i < M; ++i)
+			for (size_t j = 0; j < P; ++j) {
+				_R t = 0;
+				for (size_t k = 0; k < N; ++k) t += a[k][i] * b[j][k];
+				m[i][j] = t;
+			}
+		return m;
+	}
+	template <class _T, class _S, size_t M, size_t N>
+	inline constexpr Vector<Multiplies<_T, _S>, N>
+		operator*(const TransposedView<_T, M, N>& lhs, const Vector<_S, M>& rhs) noexcept {
+		typedef Multiplies<_T, _S> _R;
+		const Matrix<_T, M, N>& a = lhs.base();
+		Vector<_R, N> v{ 0 };
+		for (size_t i = 0; i < M; ++i) {
+			const _R t = rhs[i];
+			for (size_t j = 0; j < N; ++j) v[j] += a[i][j] * t;
+		}
+		return v;
+	}
+	//LU decomposition P*A = L*U with partial pivoting, computed once and reused.
+	//N = 0 is the runtime-sized specialization over DynamicMatrix (see dynamic.hpp)
+	template <class _T, size_t N = 0> class LUDecomposition {
+		typedef Promoted<_T> _P;
+		Matrix<_P, N, N> _lu;
+		size_t _piv[N];
+		int _sign;
+	public:
+		typedef _P ValueType;
+		constexpr LUDecomposition(const Matrix<_T, N, N>& m) noexcept
+			: _lu(m), _piv{ 0 }, _sign(Kernel::luFactor(N, N, _lu.begin(), N, _piv)) {}
+		constexpr bool singular() const noexcept { return !_sign; }
+		//L below the diagonal (unit diagonal implied) and U on and above it
+		constexpr const Matrix<_P, N, N>& packed() const noexcept { return _lu; }
+		constexpr const size_t* pivots() const noexcept { return _piv; }
+		constexpr _P det() const noexcept {
+			_P t = _sign;
+			for (size_t i = 0; i < N && t; ++i) t *= _lu[i][i];
+			return t;
+		}
+		template <class _S> constexpr Vector<_P, N> solve(const Vector<_S, N>& b) const noexcept {
+			Vector<_P, N> x(b);
+			Kernel::luSolve(N, 1, _lu.begin(), N, _piv, x.begin(), 1);
+			return x;
+		}
+		template <class _S, size_t P>
+		constexpr Matrix<_P, N, P> solve(const Matrix<_S, N, P>& b) const noexcept {
+			Matrix<_P, N, P> x(b);
+			Kernel::luSolve(N, P, _lu.begin(), N, _piv, x.begin(), P);
+			return x;
+		}
+		constexpr Matrix<_P, N, N> inv() const noexcept {
+			return solve(identityMatrix<_P, N>());
+		}
+	};
+	template <class _T, size_t N> LUDecomposition(const Matrix<_T, N, N>&) -> LUDecomposition<_T, N>;
+	//Cholesky decomposition A = L*L^H of a Hermitian positive definite matrix, about half
+	//the work of LUDecomposition. solve and inv are meaningful only if positive()
+	template <class _T, size_t N = 0> class CholeskyDecomposition {
+		typedef Promoted<_T> _P;
+		Matrix<_P, N, N> _l;
+		bool _positive;
+	public:
+		typedef _P ValueType;
+		constexpr CholeskyDecomposition(const Matrix<_T, N, N>& m) noexcept
+			: _l(m), _positive(Kernel::cholFactor(N, _l.begin(), N)) {
+			for (size_t i = 0; i < N; ++i) for (size_t j = i + 1; j < N; ++j) _l[i][j] = 0;
+		}
+		constexpr bool positive() const noexcept { return _positive; }
+		constexpr const Matrix<_P, N, N>& lower() const noexcept { return _l; }
+		constexpr _P det() const noexcept {
+			_P t = _positive;
+			for (size_t i = 0; i < N && t; ++i) t *= _l[i][i] * _l[i][i];
+			return t;
+		}
+		template <class _S> constexpr Vector<_P, N> solve(const Vector<_S, N>& b) const noexcept {
+			Vector<_P, N> x(b);
+			Kernel::cholSolve(N, 1, _l.begin(), N, x.begin(), 1);
+			return x;
+		}
+		template <class _S, size_t P>
+		constexpr Matrix<_P, N, P> solve(const Matrix<_S, N, P>& b) const noexcept {
+			Matrix<_P, N, P> x(b);
+			Kernel::cholSolve(N, P, _l.begin(), N, x.begin(), P);
+			return x;
+		}
+		constexpr Matrix<_P, N, N> inv() const noexcept {
+			return solve(identityMatrix<_P, N>());
+		}
+	};
+	template <class _T, size_t N> CholeskyDecomposition(const Matrix<_T, N, N>&) -> CholeskyDecomposition<_T, N>;
+	//LDL^H decomposition of a Hermitian matrix, L unit lower triangular and D real diagonal.
+	//Avoids square roots and also covers indefinite matrices with nonsingular leading minors
+	template <class _T, size_t N = 0> class LDLDecomposition {
+		typedef Promoted<_T> _P;
+		Matrix<_P, N, N> _ld;
+		bool _singular;
+	public:
+		typedef _P ValueType;
+		constexpr LDLDecomposition(const Matrix<_T, N, N>& m) noexcept
+			: _ld(m), _singular(!Kernel::ldlFactor(N, _ld.begin(), N)) {
+			for (size_t i = 0; i < N; ++i) for (size_t j = i + 1; j < N; ++j) _ld[i][j] = 0;
+		}
+		constexpr bool singular() const noexcept { return _singular; }
+		//L below the diagonal (unit diagonal implied) and D on it
+		constexpr const Matrix<_P, N, N>& packed() const noexcept { return _ld; }
+		constexpr Vector<_P, N> diagonal() const noexcept {
+			Vector<_P, N> d{ 0 };
+			for (size_t i = 0; i < N; ++i) d[i] = _ld[i][i];
+			return d;
+		}
+		constexpr _P det() const noexcept {
+			_P t = 1;
+			for (size_t i = 0; i < N && t; ++i) t *= _ld[i][i];
+			return t;
+		}
+		template <class _S> constexpr Vector<_P, N> solve(const Vector<_S, N>& b) const noexcept {
+			Vector<_P, N> x(b);
+			Kernel::ldlSolve(N, 1, _ld.begin(), N, x.begin(), 1);
+			return x;
+		}
+		template <class _S, size_t P>
+		constexpr Matrix<_P, N, P> solve(const Matrix<_S, N, P>& b) const noexcept {
+			Matrix<_P, N, P> x(b);
+			Kernel::ldlSolve(N, P, _ld.begin(), N, x.begin(), P);
+			return x;
+		}
+		constexpr Matrix<_P, N, N> inv() const noexcept {
+			return solve(identityMatrix<_P, N>());
+		}
+	};
+	template <class _T, size_t N> LDLDecomposition(const Matrix<_T, N, N>&) -> LDLDecomposition<_T, N>;
+	//Rank-revealing pivoted Cholesky P^T*A*P = L*L^H of a Hermitian positive semidefinite
+	//matrix. Diagonal entries up to tol end the factorization; a negative tol selects N*eps*max
+	template <class _T, size_t N = 0> class PivotedCholesky {
+		typedef Promoted<_T> _P;
+		typedef decltype(real(_P())) _R;
+		Matrix<_P, N, N> _l;
+		size_t _piv[N];
+		size_t _rank;
+	public:
+		typedef _P ValueType;
+		constexpr PivotedCholesky(const Matrix<_T, N, N>& m, _R tol = -1) noexcept
+			: _l(m), _piv{ 0 }, _rank(0) {
+			if (tol < 0) {
+				_R big = 0;
+				for (size_t i = 0; i < N; ++i) if (big < real(_l[i][i])) big = real(_l[i][i]);
+				tol = big * Limits<_R>::epsilon() * N;
+			}
+			_rank = Kernel::cholPivoted(N, _l.begin(), N, _piv, tol);
+			for (size_t i = 0; i < N; ++i) for (size_t j = i + 1; j < N; ++j) _l[i][j] = 0;
+		}
+		constexpr size_t rank() const noexcept { return _rank; }
+		//Index k was swapped with pivots()[k] at step k
+		constexpr const size_t* pivots() const noexcept { return _piv; }
+		constexpr const Matrix<_P, N, N>& lower() const noexcept { return _l; }
+	};
+	template <class _T, size_t N> PivotedCholesky(const Matrix<_T, N, N>&) -> PivotedCholesky<_T, N>;
+	//Householder QR decomposition A = Q*R of an M*N matrix, Q kept as K = min(M, N)
+	//reflectors. solve() gives the least-squares solution when M >= N without forming A^H*A
+	template <class _T, size_t M = 0, size_t N = M> class QRDecomposition {
+		typedef Promoted<_T> _P;
+		static constexpr size_t K = M < N ? M : N;
+		Matrix<_P, M, N> _qr;
+		_P _tau[K];
+	public:
+		typedef _P ValueType;
+		constexpr QRDecomposition(const Matrix<_T, M, N>& m) noexcept : _qr(m), _tau{ 0 } {
+			Kernel::qrFactor(M, N, _qr.begin(), N, _tau);
+		}
+		//Whether R has a zero on its diagonal, that is A has deficient column rank
+		constexpr bool singular() const noexcept {
+			for (size_t i = 0; i < K; ++i) if (!_qr[i][i]) return true;
+			return M < N;
+		}
+		//R on and above the diagonal, the reflector vectors (unit head implied) below it
+		constexpr const Matrix<_P, M, N>& packed() const noexcept { return _qr; }
+		constexpr const _P* tau() const noexcept { return _tau; }
+		constexpr Matrix<_P, K, N> R() const noexcept {
+			Matrix<_P, K, N> r{ 0 };
+			for (size_t i = 0; i < K; ++i) for (size_t j = i; j < N; ++j) r[i][j] = _qr[i][j];
+			return r;
+		}
+		//The first K columns of Q
+		constexpr Matrix<_P, M, K> Q() const noexcept {
+			Matrix<_P, M, K> q{ 0 };
+			for (size_t i = 0; i < K; ++i) q[i][i] = 1;
+			Kernel::qrMultiply(M, K, _qr.begin(), N, _tau, q.begin(), K, K, false);
+			return q;
+		}
+		template <class _S> constexpr Vector<_P, N> solve(const Vector<_S, M>& b) const noexcept
+			requires (M >= N) {
+			Vector<_P, M> y(b);
+			Kernel::qrSolve(M, N, _qr.begin(), N, _tau, y.begin(), 1, 1);
+			Vector<_P, N> x{ 0 };
+			for (size_t i = 0; i < N; ++i) x[i] = y[i];
+			return x;
+		}
+		template <class _S, size_t P> constexpr Matrix<_P, N, P> solve(const Matrix<_S, M, P>& b) const noexcept
+			requires (M >= N) {
+			Matrix<_P, M, P> y(b);
+			Kernel::qrSolve(M, N, _qr.begin(), N, _tau, y.begin(), P, P);
+			Matrix<_P, N, P> x{ 0 };
+			for (size_t i = 0; i < N; ++i) for (size_t j = 0; j < P; ++j) x[i][j] = y[i][j];
+			return x;
+		}
+	};
+	template <class _T, size_t M, size_t N> QRDecomposition(const Matrix<_T, M, N>&) -> QRDecomposition<_T, M, N>;
+	//Eigendecomposition A = V*diag(w)*V^H of a Hermitian matrix, of which only the lower
+	//triangle is read: w real and ascending, V unitary with the eigenvectors as columns.
+	//Householder tridiagonalization, then divide and conquer; without vectors, QL on T only
+	template <class _T, size_t N = 0> class HermitianEigenDecomposition {
+		typedef Promoted<_T> _P;
+		typedef decltype(real(_P())) _R;
+		Vector<_R, N> _w;
+		Matrix<_P, N, N> _v;
+	public:
+		typedef _P ValueType;
+		constexpr HermitianEigenDecomposition(const Matrix<_T, N, N>& m, bool vectors = true) noexcept
+			: _w{ 0 }, _v{ 0 } {
+			Matrix<_P, N, N> a(m);
+			Kernel::hermitianEigen(N, a.begin(), N, _w.begin(), vectors ? _v.begin() : nullptr, N);
+		}
+		constexpr const Vector<_R, N>& eigenvalues() const noexcept { return _w; }
+		//Zero unless constructed with vectors
+		constexpr const Matrix<_P, N, N>& eigenvectors() const noexcept { return _v; }
+	};
+	template <class _T, size_t N> HermitianEigenDecomposition(const Matrix<_T, N, N>&, bool = true)
+		-> HermitianEigenDecomposition<_T, N>;
+	//Real Schur decomposition A = Z*T*Z^T of a real matrix: Z orthogonal, T quasi-upper
+	//triangular with each complex conjugate eigenvalue pair in a standardized 2*2 diagonal
+	//block. Hessenberg reduction, then Francis double-shift QR; without schur, only the
+	//eigenvalues are computed, of the balanced matrix and in about a third of the time
+	template <class _T, size_t N = 0> class SchurDecomposition {
+		typedef Promoted<_T> _P;
+		Matrix<_P, N, N> _t, _z;
+		Complex<_P> _w[N];
+		bool _converged;
+	public:
+		typedef _P ValueType;
+		constexpr SchurDecomposition(const Matrix<_T, N, N>& m, bool schur = true) noexcept
+			: _t(m), _z{ 0 }, _w{}, _converged(false) {
+			_P wr[N]{}, wi[N]{};
+			_converged = Kernel::realSchur(N, _t.begin(), N, wr, wi, schur ? _z.begin() : nullptr, N);
+			for (size_t i = 0; i < N; ++i) _w[i] = Complex<_P>{ wr[i], wi[i] };
+			if (!schur) _t = Matrix<_P, N, N>{ 0 };
+		}
+		//False if QR ran out of iterations; the eigenvalues and T are then incomplete
+		constexpr bool converged() const noexcept { return _converged; }
+		//In the order of the diagonal of T, each conjugate pair adjacent with the positive
+		//imaginary part first
+		constexpr const Complex<_P>* eigenvalues() const noexcept { return _w; }
+		//Zero unless constructed with schur
+		constexpr const Matrix<_P, N, N>& T() const noexcept { return _t; }
+		constexpr const Matrix<_P, N, N>& Z() const noexcept { return _z; }
+	};
+	template <class _T, size_t N> SchurDecomposition(const Matrix<_T, N, N>&, bool = true)
+		-> SchurDecomposition<_T, N>;
+	//Thin singular value decomposition A = U*diag(s)*V^H of an M*N matrix, K = min(M, N):
+	//s real and descending, U (M*K) and V (N*K) with orthonormal columns. Two QR steps,
+	//then one-sided Jacobi on the triangular factor, accurate even for tiny singular values
+	template <class _T, size_t M = 0, size_t N = M> class SingularValueDecomposition {
+		typedef Promoted<_T> _P;
+		typedef decltype(real(_P())) _R;
+		static constexpr size_t K = M < N ? M : N;
+		Vector<_R, K> _s;
+		Matrix<_P, M, K> _u;
+		Matrix<_P, N, K> _v;
+		bool _converged, _vectors;
+	public:
+		typedef _P ValueType;
+		constexpr SingularValueDecomposition(const Matrix<_T, M, N>& m, bool vectors = true) noexcept
+			: _s{ 0 }, _u{ 0 }, _v{ 0 }, _converged(false), _vectors(vectors) {
+			Matrix<_P, M, N> a(m);
+			_converged = Kernel::svd(M, N, a.begin(), N, _s.begin(),
+				vectors ? _u.begin() : nullptr, K, vectors ? _v.begin() : nullptr, K);
+		}
+		constexpr bool converged() const noexcept { return _converged; }
+		constexpr const Vector<_R, K>& singularValues() const noexcept { return _s; }
+		//Zero unless constructed with vectors
+		constexpr const Matrix<_P, M, K>& U() const noexcept { return _u; }
+		constexpr const Matrix<_P, N, K>& V() const noexcept { return _v; }
+		//Number of singular values above tol, max(M, N)*eps*s[0] if negative
+		constexpr size_t rank(_R tol = -1) const noexcept {
+			if (tol < 0) tol = Kernel::svdTolerance(M, N, _s.begin());
+			size_t r = 0;
+			while (r < K && tol < _s[r]) ++r;
+			return r;
+		}
+		//Spectral norm, the largest singular value
+		constexpr _R norm() const noexcept { return _s[0]; }
+		//2-norm condition number, infinite for a rank-deficient A
+		constexpr _R cond() const noexcept { return _s[K - 1] ? _s[0] / _s[K - 1] : infinity<_R>(); }
+		//Moore-Penrose pseudo-inverse over the singular values above tol, as in rank();
+		//needs the vectors
+		constexpr Matrix<_P, N, M> pinv(_R tol = -1) const {
+			if (!_vectors) throw Error(EDOM, "Singular vectors not computed");
+			if (tol < 0) tol = Kernel::svdTolerance(M, N, _s.begin());
+			Matrix<_P, N, M> p{ 0 };
+			Kernel::svdPinv(M, N, _s.begin(), _u.begin(), K, _v.begin(), K, tol, p.begin(), M);
+			return p;
+		}
+	};
+	template <class _T, size_t M, size_t N> SingularValueDecomposition(const Matrix<_T, M, N>&, bool = true)
+		-> SingularValueDecomposition<_T, M, N>;
 	template <class _T, size_t N> constexpr _T det(const Matrix<_T, N, N>& m) noexcept {
-		Matrix<_T, N, N> a = m;
-		_T t = 1;
-		for (size_t i = 0, n = 0; i < N; n = ++i) {
-			if (!a[{i, i}]) while (++n <= N) {
-				if (n == N) return 0;
-				if (a[{n, i}]) {
-					a.radd(i, n, 1); break;
+		if constexpr (N <= 4) return Kernel::determinant<N>(m.begin());
+		else if constexpr (::std::is_integral_v<_T>) { //Bareiss elimination stays exact
+			Matrix<_T, N, N> a = m;
+			_T prev = 1, sign = 1;
+			for (size_t k = 0; k + 1 < N; ++k) {
+				if (!a[k][k]) {
+					size_t p = k + 1;
+					while (p < N && !a[p][k]) ++p;
+					if (p == N) return 0;
+					a.rswap(p, k), sign = -sign;
 				}
-			}//top left corner of a is non-zero vvv
-			t *= a[{i, i}];
-			for (n += n == i; n < N; ++n) a.rsub(n, i, a[{n, i}] / a[{i, i}]);
-		}
-		return t;
+				for (size_t i = k + 1; i < N; ++i) for (size_t j = k + 1; j < N; ++j)
+					a[i][j] = (a[i][j] * a[k][k] - a[i][k] * a[k][j]) / prev;
+				prev = a[k][k];
+			}
+			return sign * a[N - 1][N - 1];
+		} else return LUDecomposition<_T, N>(m).det();
 	}
 	template <class _T>
 	inline constexpr _T det(const Matrix<_T, 1, 1>& m) noexcept {
@@ -310,6 +825,7 @@ namespace Mathlab {
 	template <class _T, size_t N>
 	constexpr Matrix<_T, N, N> adj(const Matrix<_T, N, N>& m) noexcept {
 		Matrix<_T, N, N> a = m;
+		if constexpr (N <= 4) return Kernel::adjugate<N>(m.begin(), a.begin()), a;
 		for (size_t i = 1; i <= N; ++i) for (size_t j = 1; j <= N; ++j)
 			a[{j, i}] = det(m.subm(i, j));
 		return a;
@@ -320,7 +836,38 @@ namespace Mathlab {
 	}
 	template <class _T, size_t N>
 	constexpr Matrix<_T, N, N> inv(const Matrix<_T, N, N>& m) noexcept {
-		return adj(m) / det(m);
+		if constexpr (N <= 4) { //adj(m)/det(m) in closed form
+			typedef Promoted<_T> _P;
+			Matrix<_P, N, N> a(m), b;
+			if constexpr (N == 4) if (!::std::is_constant_evaluated()) return Kernel::inverse4(a.begin(), b.begin()), b;
+			return b *= _P(1) / Kernel::adjugate<N>(a.begin(), b.begin());
+		} else return LUDecomposition<_T, N>(m).inv();
+	}
+	//Solve A*x = b, through Cholesky when A is Hermitian positive definite and LU otherwise
+	template <class _T, class _S, size_t N>
+	constexpr Vector<Promoted<_T>, N> solve(const Matrix<_T, N, N>& a, const Vector<_S, N>& b) noexcept {
+		if (isHermitian(a)) {
+			const CholeskyDecomposition<_T, N> c(a);
+			if (c.positive()) return c.solve(b);
+		}
+		return LUDecomposition<_T, N>(a).solve(b);
+	}
+	template <class _T, class _S, size_t N, size_t P>
+	constexpr Matrix<Promoted<_T>, N, P> solve(const Matrix<_T, N, N>& a, const Matrix<_S, N, P>& b) noexcept {
+		if (isHermitian(a)) {
+			const CholeskyDecomposition<_T, N> c(a);
+			if (c.positive()) return c.solve(b);
+		}
+		return LUDecomposition<_T, N>(a).solve(b);
+	}
+	//Minimize |A*x - b| over x for a tall A through QR
+	template <class _T, class _S, size_t M, size_t N> requires (M >= N)
+	constexpr Vector<Promoted<_T>, N> leastSquares(const Matrix<_T, M, N>& a, const Vector<_S, M>& b) noexcept {
+		return QRDecomposition<_T, M, N>(a).solve(b);
+	}
+	template <class _T, class _S, size_t M, size_t N, size_t P> requires (M >= N)
+	constexpr Matrix<Promoted<_T>, N, P> leastSquares(const Matrix<_T, M, N>& a, const Matrix<_S, M, P>& b) noexcept {
+		return QRDecomposition<_T, M, N>(a).solve(b);
 	}
 	template <class _T, size_t N>
 	constexpr _T track(const Matrix<_T, N, N>& m) noexcept {
@@ -328,31 +875,174 @@ namespace Mathlab {
 		for (size_t n = 1; n < N; ++n) t += m[{n, n}];
 		return t;
 	}
+	//Numerical rank: singular values above max(M, N)*eps*s[0]
 	template <class _T, size_t M, size_t N>
 	constexpr size_t rank(const Matrix<_T, M, N>& m) noexcept {
-		Matrix<long double, M, N> a = m;
-		size_t t = 0;
-		for (size_t i = 0, n = 0; i < N && i < M; n = ++i) {
-			if (!a[{i, i}]) while (++n < N) {
-				if (a[{n, i}]) {
-					a.rswap(i, n); break;
-				}
-			}//top left corner of a is non-zero vvv
-			if (n < N) ++t;
-			for (n += n == i; n < M; ++n) a.radd(n, i, -a[{n, i}] / a[{i, i}]);
+		return SingularValueDecomposition<_T, M, N>(m, false).rank();
+	}
+	//Spectral norm, the largest singular value
+	template <class _T, size_t M, size_t N>
+	constexpr auto norm2(const Matrix<_T, M, N>& m) noexcept {
+		return SingularValueDecomposition<_T, M, N>(m, false).norm();
+	}
+	//2-norm condition number
+	template <class _T, size_t M, size_t N>
+	constexpr auto cond(const Matrix<_T, M, N>& m) noexcept {
+		return SingularValueDecomposition<_T, M, N>(m, false).cond();
+	}
+	template <class _T, size_t M, size_t N>
+	constexpr Matrix<Promoted<_T>, N, M> pinv(const Matrix<_T, M, N>& m) noexcept {
+		return SingularValueDecomposition<_T, M, N>(m).pinv();
+	}
+	//Product of two squares for pow, through Strassen-Winograd from _MATHLAB_STRASSEN up
+	template <class _T, size_t N>
+	constexpr Matrix<_T, N, N> _powMul(const Matrix<_T, N, N>& x, const Matrix<_T, N, N>& y) noexcept {
+		if constexpr (EitherOf<_T, float, double> && N >= _MATHLAB_STRASSEN)
+			if (!::std::is_constant_evaluated()) {
+				Matrix<_T, N, N> z{ 0 };
+				Kernel::strassen(N, x.begin(), N, y.begin(), N, z.begin(), N);
+				return z;
+			}
+		return x * y;
+	}
+	//r * b^e by binary exponentiation, about 2*log2(e) products
+	template <class _M> constexpr _M _pow(_M b, unsigned long long e, _M r) {
+		for (bool first = true; e; e >>= 1) {
+			if (e & 1) {
+				r = first ? b : _powMul(r, b);
+				first = false;
+			}
+			if (e > 1) b = _powMul(b, b);
 		}
-		return t;
+		return r;
 	}
-	template <class _T, size_t N> inline constexpr Matrix<_T, N, N>
-	pow(const Matrix<_T, N, N>& m, int n) {
-		return n < 0 ? pow(inv(m), -n) : n ? m * pow(m, n - 1) : identityMatrix<_T, N>();
+	//m^n; a negative n inverts m once and raises the inverse
+	template <class _T, size_t N> constexpr Matrix<_T, N, N> pow(const Matrix<_T, N, N>& m, int n) {
+		return _pow(n < 0 ? inv(m) : m, n < 0 ? 0ull - n : n, identityMatrix<_T, N>());
 	}
-	template <class _T, size_t N> inline constexpr Matrix<_T, N, N>
-	exp(const Matrix<_T, N, N>& m) {
-		Matrix<_T, N, N> result = identityMatrix<_T, N>() + m, n = m;
-		_T t = 1;
-		while (m + t * n != m) result += n *= m / (t += 1);
-		return result;
+	//1-norm bounds theta_m up to which the Padé [m/m] approximant of exp is accurate in
+	//double precision, m = 3, 5, 7, 9, 13, and the approximant coefficients b_0..b_m
+	//(Higham, The Scaling and Squaring Method for the Matrix Exponential Revisited, 2005)
+	inline constexpr double _EXPM_THETA[] = { 1.495585217958292e-2, 2.539398330063230e-1,
+		9.504178996162932e-1, 2.097847961257068, 5.371920351148152 };
+	inline constexpr double _EXPM_PADE[][14] = {
+		{ 120, 60, 12, 1 },
+		{ 30240, 15120, 3360, 420, 30, 1 },
+		{ 17297280, 8648640, 1995840, 277200, 25200, 1512, 56, 1 },
+		{ 17643225600, 8821612800, 2075673600, 302702400, 30270240, 2162160, 110880, 3960, 90, 1 },
+		{ 64764752532480000, 32382376266240000, 7771770303897600, 1187353796428800,
+			129060195264000, 10559470521600, 670442572800, 33522128640, 1323241920,
+			40840800, 960960, 16380, 182, 1 } };
+	//y += t * x entry by entry, for matrices or vectors of the same shape and layout
+	template <class _M, class _T> inline constexpr void _axpy(_M& y, const _M& x, const _T& t) noexcept {
+		const auto* p = x.begin();
+		for (auto& e : y) e += t * *p++;
+	}
+	template <class _M> constexpr auto _norm1(const _M& a, size_t n) noexcept {
+		decltype(abs(*a.begin())) r = 0;
+		for (size_t j = 0; j < n; ++j) {
+			decltype(r) s = 0;
+			for (size_t i = 0; i < n; ++i) s += abs(a[{i, j}]);
+			if (r < s) r = s;
+		}
+		return r;
+	}
+	//exp(A) for an n*n Matrix or DynamicMatrix a, id the identity of the same type.
+	//Picks the lowest Padé degree whose theta covers |A|_1, or scales A by 2^-s into
+	//the reach of degree 13 and squares s times: at most 6 + s products and one solve
+	template <class _M> constexpr _M _expm(_M a, const _M& id, size_t n) {
+		auto norm = _norm1(a, n);
+		size_t d = 0, s = 0;
+		while (d < 4 && _EXPM_THETA[d] < norm) ++d;
+		if (d == 4) {
+			decltype(norm) f = 1;
+			while (_EXPM_THETA[4] < norm * f) f /= 2, ++s;
+			for (auto& t : a) t *= f;
+		}
+		const double* b = _EXPM_PADE[d];
+		const _M a2 = a * a;
+		_M u = a2, v = a2; //Odd part A*U(A^2) and even part V(A^2) of the numerator
+		for (auto& t : u) t = 0;
+		for (auto& t : v) t = 0;
+		_axpy(u, id, b[1]), _axpy(v, id, b[0]);
+		if (d < 4) {
+			_M p = a2;
+			for (size_t j = 1; j <= d + 1; ++j) {
+				if (j > 1) p = p * a2;
+				_axpy(u, p, b[2 * j + 1]), _axpy(v, p, b[2 * j]);
+			}
+		} else {
+			const _M a4 = a2 * a2, a6 = a4 * a2;
+			_M x = a6, y = a6;
+			for (auto& t : x) t = 0;
+			for (auto& t : y) t = 0;
+			_axpy(x, a6, b[13]), _axpy(x, a4, b[11]), _axpy(x, a2, b[9]);
+			_axpy(y, a6, b[12]), _axpy(y, a4, b[10]), _axpy(y, a2, b[8]);
+			_axpy(u, a6 * x, 1), _axpy(u, a6, b[7]), _axpy(u, a4, b[5]), _axpy(u, a2, b[3]);
+			_axpy(v, a6 * y, 1), _axpy(v, a6, b[6]), _axpy(v, a4, b[4]), _axpy(v, a2, b[2]);
+		}
+		u = a * u;
+		_M x(LUDecomposition(v - u).solve(v + u));
+		while (s--) x = x * x;
+		return x;
+	}
+	//1-norm bounds theta_m up to which the degree m Taylor polynomial of exp is accurate in
+	//double precision, m = 5, 10, ..., 55 (Al-Mohy and Higham, Computing the Action of the
+	//Matrix Exponential, 2011, Table 3.1)
+	inline constexpr double _EXPMV_THETA[] = { 2.4e-3, 1.4e-1, 6.4e-1, 1.4, 2.4, 3.5, 4.7, 6.0,
+		7.2, 8.5, 9.9 };
+	//exp(t*A)*v for an n*n Matrix or DynamicMatrix a without forming exp(t*A).
+	//A is shifted by its mean eigenvalue, then exp acts in s steps of the degree m Taylor
+	//series on t*A/s, s = ceil(|t*A|_1 / theta_m) for the m of fewest products m*s; a step
+	//ends once two consecutive terms are negligible. Costs only matrix-vector products.
+	template <class _M, class _V, class _R> constexpr _V _expmv(_M a, _V v, size_t n, const _R& t) {
+		_R mu = 0;
+		for (size_t i = 0; i < n; ++i) mu += a[{i, i}];
+		mu /= n;
+		for (size_t i = 0; i < n; ++i) a[{i, i}] -= mu;
+		const auto norm = _norm1(a, n) * abs(t);
+		if (!isfinite(norm) || norm > 0x1p52) throw Error(EDOM, "Norm out of range");
+		size_t s = 1, m = 0;
+		for (size_t d = 0; d < 11; ++d) {
+			const double q = norm / _EXPMV_THETA[d];
+			size_t c = size_t(q);
+			c += c < q || !c;
+			if (!m || (d + 1) * c < m * s) m = d + 1, s = c;
+		}
+		m *= 5;
+		const _R eta = exp(t * mu / s);
+		const auto inf = [](const _V& x) {
+			decltype(abs(*x.begin())) r = 0;
+			for (const auto& e : x) if (r < abs(e)) r = abs(e);
+			return r;
+		};
+		_V f = v;
+		for (size_t i = 0; i < s; ++i) {
+			auto c1 = inf(v);
+			for (size_t k = 1; k <= m; ++k) {
+				v = a * v;
+				for (auto& e : v) e *= t / _R(s * k);
+				const auto c2 = inf(v);
+				_axpy(f, v, 1);
+				if (c1 + c2 <= Limits<decltype(c2)>::epsilon() * inf(f)) break;
+				c1 = c2;
+			}
+			for (auto& e : f) e *= eta;
+			v = f;
+		}
+		return f;
+	}
+	//Matrix exponential by scaling and squaring
+	template <class _T, size_t N> constexpr Matrix<Promoted<_T>, N, N> expm(const Matrix<_T, N, N>& m) {
+		return _expm(Matrix<Promoted<_T>, N, N>(m), identityMatrix<Promoted<_T>, N>(), N);
+	}
+	template <class _T, size_t N> inline constexpr Matrix<Promoted<_T>, N, N> exp(const Matrix<_T, N, N>& m) {
+		return expm(m);
+	}
+	//exp(t*m)*v, for propagating a state vector without forming exp(t*m)
+	template <class _T, class _S, size_t N> constexpr Vector<Promoted<_T>, N>
+	expmv(const Matrix<_T, N, N>& m, const Vector<_S, N>& v, Promoted<_T> t = 1) {
+		return _expmv(Matrix<Promoted<_T>, N, N>(m), Vector<Promoted<_T>, N>(v), N, t);
 	}
 	template <class _T, class _S, size_t M, size_t N, size_t P, size_t Q>
 	inline constexpr auto operator->*(const Matrix<_T, M, N>& m, const Matrix<_T, P, Q>& n) {
@@ -364,25 +1054,25 @@ namespace Mathlab {
 	//4 Matrix pattern properties
 	template <class _T, size_t N>
 	inline constexpr bool isSymmetric(const Matrix<_T, N, N>& m) noexcept {
-		for (size_t i = 1; i <= N; ++i) for (size_t j = 1; j <= N; ++j)
+		for (size_t i = 0; i < N; ++i) for (size_t j = 0; j < i; ++j)
 			if (m[{j, i}] != m[i][j]) return 0;
 		return 1;
 	}
 	template <class _T, size_t N>
 	inline constexpr bool isSkewSymmetric(const Matrix<_T, N, N>& m) noexcept {
-		for (size_t i = 1; i <= N; ++i) for (size_t j = 1; j <= N; ++j)
+		for (size_t i = 0; i < N; ++i) for (size_t j = 0; j <= i; ++j)
 			if (m[{j, i}] != -m[i][j]) return 0;
 		return 1;
 	}
 	template <class _T, size_t N>
 	inline constexpr bool isHermitian(const Matrix<_T, N, N>& m) noexcept {
-		for (size_t i = 1; i <= N; ++i) for (size_t j = 1; j <= N; ++j)
+		for (size_t i = 0; i < N; ++i) for (size_t j = 0; j <= i; ++j)
 			if (m[{j, i}] != conj(m[i][j])) return 0;
 		return 1;
 	}
 	template <class _T, size_t N>
 	inline constexpr bool isSkewHermitian(const Matrix<_T, N, N>& m) noexcept {
-		for (size_t i = 1; i <= N; ++i) for (size_t j = 1; j <= N; ++j)
+		for (size_t i = 0; i < N; ++i) for (size_t j = 0; j <= i; ++j)
 			if (m[{j, i}] != -conj(m[i][j])) return 0;
 		return 1;
 	}
@@ -469,11 +1159,6 @@ namespace Mathlab {
 		for (_T& t : m) t = v[i++];
 	}
 	//6 Linear Transformation
-	template <class _T, size_t N> inline constexpr Matrix<_T, N + 1>
-	transform(const Vector<_T, N>& v) {
-		Matrix<_T, N> res = identityMatrix<_T, N + 1>();
-		res[N] = Vector<_T, N + 1>(v, 1);
-	}
 	template <class _T> inline constexpr Matrix<Promoted<_T>, 2>
 	rotate2D(const _T& theta) {
 		Promoted<_T> c = cos(theta), s = sin(theta);
@@ -482,20 +1167,20 @@ namespace Mathlab {
 	//Rotate by X axis
 	template <class _T> inline constexpr Matrix<Promoted<_T>, 3>
 	roll(const _T& theta) {
-		Promoted<_T> c = cos(theta), s = sin(theta);
-		return { 1, 0, 0, 0, c, -s, 0, s, c };
+		Promoted<_T> c = cos(theta), s = sin(theta), z = 0, o = 1;
+		return { o, z, z, z, c, -s, z, s, c };
 	}
 	//Rotate by Y axis
 	template <class _T> inline constexpr Matrix<Promoted<_T>, 3>
 	pitch(const _T& theta) {
-		Promoted<_T> c = cos(theta), s = sin(theta);
-		return { c, 0, s, 0, 1, 0, -s, 0, c };
+		Promoted<_T> c = cos(theta), s = sin(theta), z = 0, o = 1;
+		return { c, z, s, z, o, z, -s, z, c };
 	}
 	//Rotate by Z axis
 	template <class _T> inline constexpr Matrix<Promoted<_T>, 3>
 	yaw(const _T& theta) {
-		Promoted<_T> c = cos(theta), s = sin(theta);
-		return { c, -s, 0, s, c, 0, 0, 0, 1 };
+		Promoted<_T> c = cos(theta), s = sin(theta), z = 0, o = 1;
+		return { c, -s, z, s, c, z, z, z, o };
 	}
 	template <class _T> inline constexpr Matrix<_T, 3>
 	rotateQuaternion(const Vector<_T, 4>& v) {
@@ -0,0 +1,227 @@
+#pragma once
+#ifndef _MATHLAB_PARALLEL_
+#define _MATHLAB_PARALLEL_ 1
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "basics.hpp"
+// Threads of the library-wide pool, the calling thread included: 0 for one per hardware
+// thread, 1 to run every kernel serially on the caller
+#ifndef _MATHLAB_THREADS
+#define _MATHLAB_THREADS 0
+#endif
+// Fewest multiply-adds a dense kernel splits across threads
+#ifndef _MATHLAB_PARALLEL_GRAIN
+#define _MATHLAB_PARALLEL_GRAIN 1048576
+#endif
+namespace Mathlab {
+	// Fork-join pool with one task deque per thread. A parallel loop halves its range,
+	// queues one half and goes on with the other until pieces are no longer than the
+	// grain. Threads pop their own deque newest first; an idle one steals the oldest
+	// task of another, which is the largest piece left. Threads outside the pool share
+	// deque 0, and a thread waiting for its loop runs queued tasks meanwhile, so loops
+	// nest and run from several threads without deadlock.
+	class ThreadPool {
+		struct _Task {
+			virtual void run() = 0;
+			virtual ~_Task() = default;
+		};
+		struct _Queue {
+			::std::mutex mutex;
+			::std::deque<_Task*> tasks;
+		};
+		//One parallel loop: its tasks still queued or running, and the first exception
+		struct _Group {
+			::std::atomic<size_t> pending{ 0 };
+			::std::mutex mutex;
+			::std::exception_ptr error;
+		};
+		template <class _F> struct _RangeTask : _Task {
+			ThreadPool* pool;
+			_Group* group;
+			size_t b, e, grain;
+			const _F* f;
+			_RangeTask(ThreadPool* p, _Group* g, size_t b, size_t e, size_t grain, const _F* f)
+				: pool(p), group(g), b(b), e(e), grain(grain), f(f) {}
+			void run() override {
+				pool->_split(*group, b, e, grain, *f);
+				_Group* const g = group;
+				delete this;
+				g->pending.fetch_sub(1);
+			}
+		};
+		struct _Self {
+			const ThreadPool* pool;
+			size_t index;
+		};
+		_Queue* _queues;
+		::std::thread* _workers;
+		size_t _size;
+		bool _pin;
+		::std::atomic<size_t> _queued;
+		::std::atomic<bool> _stop;
+		::std::mutex _sleep;
+		::std::condition_variable _wake;
+		static _Self& _self() noexcept {
+			thread_local _Self self{ nullptr, 0 };
+			return self;
+		}
+		//Deque of the calling thread: its own for a worker, 0 for any other thread
+		size_t _index() const noexcept {
+			return _self().pool == this ? _self().index : 0;
+		}
+		void _push(_Task* t) {
+			_Queue& q = _queues[_index()];
+			{
+				const ::std::lock_guard<::std::mutex> lock(q.mutex);
+				q.tasks.push_back(t);
+			}
+			++_queued;
+			const ::std::lock_guard<::std::mutex> lock(_sleep);
+			_wake.notify_one();
+		}
+		_Task* _pop() {
+			const size_t self = _index();
+			for (size_t k = 0; k < _size; ++k) {
+				_Queue& q = _queues[(self + k) % _size];
+				const ::std::lock_guard<::std::mutex> lock(q.mutex);
+				if (q.tasks.empty()) continue;
+				_Task* t;
+				if (k) t = q.tasks.front(), q.tasks.pop_front();
+				else t = q.tasks.back(), q.tasks.pop_back();
+				--_queued;
+				return t;
+			}
+			return nullptr;
+		}
+		template <class _F> void _split(_Group& group, size_t b, size_t e, size_t grain, const _F& f) {
+			while (e - b > grain) {
+				const size_t m = b + (e - b) / 2;
+				++group.pending;
+				_push(new _RangeTask<_F>(this, &group, m, e, grain, &f));
+				e = m;
+			}
+			try {
+				f(b, e);
+			} catch (...) {
+				const ::std::lock_guard<::std::mutex> lock(group.mutex);
+				if (!group.error) group.error = ::std::current_exception();
+			}
+		}
+		void _work(size_t index) {
+			_self() = { this, index };
+#if defined(__linux__)
+			//hardware_concurrency() may not know the CPU count; leave the thread unpinned then
+			const size_t cpus = ::std::thread::hardware_concurrency();
+			if (_pin && cpus) {
+				cpu_set_t set;
+				CPU_ZERO(&set);
+				CPU_SET(index % cpus, &set);
+				pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+			}
+#endif
+			for (;;) {
+				if (_Task* t = _pop()) {
+					t->run();
+					continue;
+				}
+				::std::unique_lock<::std::mutex> lock(_sleep);
+				_wake.wait(lock, [this] { return _queued || _stop; });
+				if (_stop && !_queued) return;
+			}
+		}
+		void _start(size_t threads, bool pin) {
+			if (!threads) threads = ::std::thread::hardware_concurrency();
+			_size = threads ? threads : 1, _pin = pin, _stop = false, _queued = 0;
+			_queues = new _Queue[_size];
+			_workers = new ::std::thread[_size - 1];
+			for (size_t i = 1; i < _size; ++i) _workers[i - 1] = ::std::thread([this, i] { _work(i); });
+		}
+		void _halt() {
+			{
+				const ::std::lock_guard<::std::mutex> lock(_sleep);
+				_stop = true;
+			}
+			_wake.notify_all();
+			for (size_t i = 1; i < _size; ++i) _workers[i - 1].join();
+			delete[] _workers;
+			delete[] _queues;
+		}
+	public:
+		//threads counts the caller and is 0 for one per hardware thread. With pin, worker
+		//i is bound to core i (Linux only; elsewhere pin is ignored)
+		explicit ThreadPool(size_t threads = _MATHLAB_THREADS, bool pin = false) {
+			_start(threads, pin);
+		}
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		~ThreadPool() {
+			_halt();
+		}
+		//Restart with another thread count; no loop may be running on the pool
+		void resize(size_t threads, bool pin = false) {
+			_halt();
+			_start(threads, pin);
+		}
+		size_t size() const noexcept { return _size; }
+		bool pinned() const noexcept { return _pin; }
+		//Calls f(i0, i1) on disjoint ranges covering [b, e), none longer than grain, and
+		//returns when all are done, rethrowing the first exception any of them threw
+		template <class _F> void parallelFor(size_t b, size_t e, size_t grain, const _F& f) {
+			if (b >= e) return;
+			if (!grain) grain = 1;
+			if (_size < 2 || e - b <= grain) return f(b, e);
+			_Group group;
+			_split(group, b, e, grain, f);
+			while (group.pending) {
+				if (_Task* t = _pop()) t->run();
+				else ::std::this_thread::yield();
+			}
+			if (group.error) ::std::rethrow_exception(group.error);
+		}
+		//Splits [b, e) into a few ranges per thread
+		template <class _F> void parallelFor(size_t b, size_t e, const _F& f) {
+			parallelFor(b, e, b < e ? (e - b + 4 * _size - 1) / (4 * _size) : 1, f);
+		}
+		//join(...join(join(init, f(b, b + grain)), f(b + grain, b + 2 * grain))..., f(..., e)):
+		//the chunks are fixed by grain alone, so the result does not depend on the thread
+		//count or on the schedule
+		template <class _T, class _F, class _J>
+		_T parallelReduce(size_t b, size_t e, size_t grain, _T init, const _F& f, const _J& join) {
+			if (b >= e) return init;
+			if (!grain) grain = 1;
+			const size_t n = (e - b + grain - 1) / grain;
+			const ::std::unique_ptr<_T[]> part(new _T[n]);
+			parallelFor(0, n, 1, [&](size_t c0, size_t c1) {
+				for (size_t c = c0; c < c1; ++c)
+					part[c] = f(b + c * grain, e - b - c * grain < grain ? e : b + (c + 1) * grain);
+			});
+			for (size_t c = 0; c < n; ++c) init = join(init, part[c]);
+			return init;
+		}
+	};
+	//The pool every kernel runs on, _MATHLAB_THREADS wide until resized
+	inline ThreadPool& threadPool() {
+		static ThreadPool pool;
+		return pool;
+	}
+	template <class _F> inline void parallelFor(size_t b, size_t e, size_t grain, const _F& f) {
+		threadPool().parallelFor(b, e, grain, f);
+	}
+	template <class _F> inline void parallelFor(size_t b, size_t e, const _F& f) {
+		threadPool().parallelFor(b, e, f);
+	}
+	template <class _T, class _F, class _J>
+	inline _T parallelReduce(size_t b, size_t e, size_t grain, _T init, const _F& f, const _J& join) {
+		return threadPool().parallelReduce(b, e, grain, init, f, join);
+	}
+}
+#endif
\ No newline at end of file
@@ -3,202 +3,693 @@
 #define _MATHLAB_POLY_
 #include "basics.hpp"
 #include "iterator.hpp"
+#include "dynamic.hpp"
+// Polynomial::evaluate on exact types takes the subproduct tree once power * points exceeds
+// this many times (points + power) log^2 points
+#ifndef _MATHLAB_SUBPRODUCT
+#define _MATHLAB_SUBPRODUCT 64
+#endif
 namespace Mathlab {
-	template <Arithmetic _T> class Polynomial;
-	namespace Mathlab {
-		template <Arithmetic _T> class Polynomial {
-			_T* _data;
-			size_t _power;
-		public:
-			typedef _T ValueType;
-			constexpr Polynomial(const _T& t = 0, const size_t p = 0) noexcept
-				: _data(new _T[p + 1]{0}), _power(p) {
-				_data[p] = t;
-			}
-			constexpr Polynomial(const Polynomial& r) noexcept
-				: _data(new _T[r.power() + 1]{*r._data}), _power(r.power()) {
-				for (size_t n = 1; n <= _power; ++n) {
-					_data[n] = r._data[n];
+	// Division of f(a + 1) by g(b + 1), g[b] != 0: q(a - b + 1) receives the quotient and
+	// f the remainder in its first b coefficients, zeros above. Long division costs
+	// (a - b + 1)b; when that exceeds a few transforms of length a and g[b] is a unit
+	// (always for floating types), the reversed quotient is rev(f) / rev(g) mod t^(a-b+1),
+	// the inverse series refined by Newton steps h <- h - h(rev(g)h - 1) that double its
+	// precision, so the division costs a few multiplications
+	template <class _T> constexpr void _divide(_T* f, size_t a, const _T* g, size_t b, _T* q) {
+		const size_t m = a - b + 1;
+		size_t lg = 1;
+		while (size_t(1) << lg < a) ++lg;
+		if (::std::is_constant_evaluated() || m * b <= 64 * (a + 1) * lg
+			|| Integral<_T> && _T(1) / g[b] * g[b] != _T(1)) {
+			for (size_t i = a + 1; i-- > b;) {
+				const _T c = q[i - b] = f[i] / g[b];
+				f[i] = _T(0);
+				for (size_t j = 0; j < b; ++j) f[i - b + j] -= c * g[j];
+			}
+			return;
+		}
+		_T* const G = new _T[5 * m + a + 1], * const h = G + m, * const v = h + m, * const p = v + 2 * m;
+		for (size_t i = 0; i < m; ++i) G[i] = i <= b ? g[b - i] : _T(0);
+		h[0] = _T(1) / G[0];
+		for (size_t k = 1; k < m; k *= 2) {
+			const size_t l = 2 * k < m ? 2 * k : m;
+			Kernel::convolve(G, l, h, k, p);         //rev(g)h = 1 + O(t^k)
+			Kernel::convolve(h, l - k, p + k, l - k, v);
+			for (size_t i = 0; i < l - k; ++i) h[k + i] = -v[i];
+		}
+		for (size_t i = 0; i < m; ++i) G[i] = f[a - i];
+		Kernel::convolve(G, m, h, m, p);
+		for (size_t i = 0; i < m; ++i) q[m - 1 - i] = p[i];
+		Kernel::convolve(q, m < b ? m : b, g, b, p);
+		for (size_t i = 0; i <= a; ++i) f[i] = i < b ? f[i] - p[i] : _T(0);
+		delete[] G;
+	}
+	// y(n) = values of c(d + 1) at x(n) by Horner on blocks of 32 points that advance
+	// together through the coefficients, one vectorizable multiply-add across the block per
+	// step; blocks run in parallel
+	template <class _T, class _S, class _R> void _horner(const _T* c, size_t d, const _S* x, size_t n, _R* y) {
+		constexpr size_t B = 32;
+		const size_t work = (d + 1) * B, grain = work < _MATHLAB_PARALLEL_GRAIN ? _MATHLAB_PARALLEL_GRAIN / work : 1;
+		parallelFor(0, (n + B - 1) / B, grain, [&](size_t b0, size_t b1) {
+			_R acc[B], t[B];
+			for (size_t b = b0; b < b1; ++b) {
+				const size_t i0 = b * B, m = n - i0 < B ? n - i0 : B;
+				for (size_t k = 0; k < B; ++k) t[k] = k < m ? _R(x[i0 + k]) : _R(0), acc[k] = c[d];
+				for (size_t j = d; j--;) {
+					const _R cj = c[j];
+					for (size_t k = 0; k < B; ++k) acc[k] = acc[k] * t[k] + cj;
 				}
+				for (size_t k = 0; k < m; ++k) y[i0 + k] = acc[k];
 			}
-			template <class _S> constexpr Polynomial(const Polynomial<_S>& r) noexcept
-				: _data(new _T[r.power() + 1]{*r._data}), _power(r.power()) {
-				for (size_t n = 1; n <= _power; ++n) {
-					_data[n] = r._data[n];
+		});
+	}
+	// Subproduct tree over x(n): level k cuts the points into blocks of 32 << k and holds for
+	// block j the monic product of (t - x[i]) over its points at node(k, j), constant term
+	// first; the last level is a single block. Levels build bottom-up in parallel across
+	// nodes, the products of large ones by fast multiplication
+	template <class _T> class _SubproductTree {
+		const _T* _x;
+		size_t _n, _levels;
+		_T** _level;
+	public:
+		_SubproductTree(const _T* x, size_t n) : _x(x), _n(n), _levels(1) {
+			while (width(_levels - 1) < n) ++_levels;
+			_level = new _T*[_levels];
+			for (size_t k = 0; k < _levels; ++k) _level[k] = new _T[blocks(k) * (width(k) + 1)];
+			parallelFor(0, blocks(0), 1, [&](size_t j0, size_t j1) {
+				for (size_t j = j0; j < j1; ++j) {
+					_T* const p = node(0, j);
+					const size_t m = points(0, j);
+					p[0] = _T(1);
+					for (size_t i = 0; i < m; ++i) {
+						const _T xi = x[j * width(0) + i];
+						p[i + 1] = p[i];
+						for (size_t l = i; l; --l) p[l] = p[l - 1] - xi * p[l];
+						p[0] = _T(0) - xi * p[0];
+					}
+				}
+			});
+			for (size_t k = 1; k < _levels; ++k) parallelFor(0, blocks(k), 1, [&](size_t j0, size_t j1) {
+				for (size_t j = j0; j < j1; ++j) {
+					const size_t ml = points(k - 1, 2 * j);
+					if (2 * j + 1 < blocks(k - 1))
+						Kernel::convolve(node(k - 1, 2 * j), ml + 1, node(k - 1, 2 * j + 1), points(k - 1, 2 * j + 1) + 1, node(k, j));
+					else for (size_t i = 0; i <= ml; ++i) node(k, j)[i] = node(k - 1, 2 * j)[i];
 				}
+			});
+		}
+		_SubproductTree(const _SubproductTree&) = delete;
+		_SubproductTree& operator=(const _SubproductTree&) = delete;
+		~_SubproductTree() {
+			for (size_t k = 0; k < _levels; ++k) delete[] _level[k];
+			delete[] _level;
+		}
+		static constexpr size_t width(size_t k) noexcept { return size_t(32) << k; }
+		size_t levels() const noexcept { return _levels; }
+		size_t blocks(size_t k) const noexcept { return (_n + width(k) - 1) / width(k); }
+		size_t points(size_t k, size_t j) const noexcept { return _n - j * width(k) < width(k) ? _n - j * width(k) : width(k); }
+		_T* node(size_t k, size_t j) const noexcept { return _level[k] + j * (width(k) + 1); }
+		// y(n) = c(d + 1) at the points: c is reduced modulo the root, each remainder modulo
+		// the two children, and the blocks of the first level finish by Horner
+		void evaluate(const _T* c, size_t d, _T* y) const {
+			_T* r = new _T[_n + 1], * s = new _T[_n + 1];
+			{
+				const size_t m = d + 1 > _n ? d + 1 : _n;
+				_T* const f = new _T[m], * const q = new _T[m];
+				for (size_t i = 0; i < m; ++i) f[i] = i <= d ? c[i] : _T(0);
+				if (d >= _n) _divide(f, d, node(_levels - 1, 0), _n, q);
+				for (size_t i = 0; i < _n; ++i) r[i] = f[i];
+				delete[] f;
+				delete[] q;
+			}
+			for (size_t k = _levels - 1; k; --k) {
+				parallelFor(0, blocks(k - 1), 1, [&](size_t j0, size_t j1) {
+					const size_t w = width(k), h = width(k - 1);
+					_T* const f = new _T[w], * const q = new _T[w];
+					for (size_t j = j0; j < j1; ++j) {
+						const size_t a = points(k, j / 2), b = points(k - 1, j);
+						const _T* const rp = r + j / 2 * w;
+						for (size_t i = 0; i < a; ++i) f[i] = rp[i];
+						if (a > b) _divide(f, a - 1, node(k - 1, j), b, q);
+						for (size_t i = 0; i < b; ++i) s[j * h + i] = f[i];
+					}
+					delete[] f;
+					delete[] q;
+				});
+				Mathlab::swap(r, s);
 			}
-			template <class _S> constexpr Polynomial(const InitializerList<_S>& r) noexcept
-				: _data(new _T[r.size()]{*r.begin()}), _power(r.size() - 1) {
-				for (size_t n = 1; n <= _power; ++n) {
-					_data[n] = r.begin()[n];
+			parallelFor(0, blocks(0), 1, [&](size_t j0, size_t j1) {
+				for (size_t j = j0; j < j1; ++j) {
+					const size_t m = points(0, j), i0 = j * width(0);
+					for (size_t i = 0; i < m; ++i) {
+						_T v = r[i0 + m - 1];
+						for (size_t l = m - 1; l--;) v = v * _x[i0 + i] + r[i0 + l];
+						y[i0 + i] = v;
+					}
 				}
+			});
+			delete[] r;
+			delete[] s;
+		}
+		// p(n) = sum of w[i] * M / (t - x[i]) over the points, M the root: synthetic division
+		// within the blocks of the first level, then P = Pl * Mr + Pr * Ml up the tree
+		void combine(const _T* w, _T* p) const {
+			_T* r = new _T[_n], * s = new _T[_n];
+			parallelFor(0, blocks(0), 1, [&](size_t j0, size_t j1) {
+				for (size_t j = j0; j < j1; ++j) {
+					const size_t m = points(0, j), i0 = j * width(0);
+					const _T* const M = node(0, j);
+					_T* const P = r + i0;
+					for (size_t l = 0; l < m; ++l) P[l] = _T(0);
+					for (size_t i = 0; i < m; ++i) {
+						_T q = M[m];
+						P[m - 1] += w[i0 + i] * q;
+						for (size_t l = m - 1; l; --l) q = M[l] + _x[i0 + i] * q, P[l - 1] += w[i0 + i] * q;
+					}
+				}
+			});
+			for (size_t k = 1; k < _levels; ++k) {
+				parallelFor(0, blocks(k), 1, [&](size_t j0, size_t j1) {
+					for (size_t j = j0; j < j1; ++j) {
+						const size_t h = width(k - 1), ml = points(k - 1, 2 * j), a = j * width(k);
+						if (2 * j + 1 >= blocks(k - 1)) {
+							for (size_t i = 0; i < ml; ++i) s[a + i] = r[a + i];
+							continue;
+						}
+						const size_t mr = points(k - 1, 2 * j + 1);
+						_T* const t = new _T[ml + mr];
+						Kernel::convolve(r + a, ml, node(k - 1, 2 * j + 1), mr + 1, s + a);
+						Kernel::convolve(r + a + h, mr, node(k - 1, 2 * j), ml + 1, t);
+						for (size_t i = 0; i < ml + mr; ++i) s[a + i] += t[i];
+						delete[] t;
+					}
+				});
+				Mathlab::swap(r, s);
 			}
-			constexpr ~Polynomial() noexcept {
-				delete[] _data;
-				_power = 0;
+			for (size_t i = 0; i < _n; ++i) p[i] = r[i];
+			delete[] r;
+			delete[] s;
+		}
+	};
+	template <Arithmetic _T> class Polynomial {
+		_T* _data;
+		size_t _power;
+		template <Arithmetic> friend class Polynomial;
+	public:
+		typedef _T ValueType;
+		constexpr Polynomial(const _T& t = 0, const size_t p = 0) noexcept
+			: _data(new _T[p + 1]{0}), _power(p) {
+			_data[p] = t;
+		}
+		constexpr Polynomial(const Polynomial& r) noexcept
+			: _data(new _T[r.power() + 1]{*r._data}), _power(r.power()) {
+			for (size_t n = 1; n <= _power; ++n) {
+				_data[n] = r._data[n];
+			}
+		}
+		template <class _S> constexpr Polynomial(const Polynomial<_S>& r) noexcept
+			: _data(new _T[r.power() + 1]{*r._data}), _power(r.power()) {
+			for (size_t n = 1; n <= _power; ++n) {
+				_data[n] = r._data[n];
+			}
+		}
+		template <class _S> constexpr Polynomial(const InitializerList<_S>& r) noexcept
+			: _data(new _T[r.size()]{*r.begin()}), _power(r.size() - 1) {
+			for (size_t n = 1; n <= _power; ++n) {
+				_data[n] = r.begin()[n];
 			}
-			constexpr Polynomial& operator=(const Polynomial& r) noexcept {
+		}
+		constexpr ~Polynomial() noexcept {
+			delete[] _data;
+			_power = 0;
+		}
+		constexpr Polynomial& operator=(const Polynomial& r) noexcept {
+			delete[] _data;
+			_data = new _T[(_power = r.power()) + 1]{*r._data};
+			for (size_t n = 1; n <= _power; ++n) {
+				_data[n] = r._data[n];
+			}
+			return *this;
+		}
+		template <class _S> constexpr Polynomial& operator=(const Polynomial<_S>& r) noexcept {
+			delete[] _data;
+			_data = new _T[(_power = r.power()) + 1]{*r._data};
+			for (size_t n = 1; n <= _power; ++n) {
+				_data[n] = r._data[n];
+			}
+			return *this;
+		}
+		// Iterators
+		constexpr _T* begin() noexcept { return _data; }
+		constexpr _T* end() noexcept { return _data + _power + 1; }
+		constexpr ReverseIterator<_T*> rbegin() noexcept { return _data + _power; }
+		constexpr ReverseIterator<_T*> rend() noexcept { return _data - 1; }
+		constexpr const _T* begin() const noexcept { return _data; }
+		constexpr const _T* end() const noexcept { return _data + _power + 1; }
+		constexpr ReverseIterator<const _T*> rbegin() const noexcept { return _data + _power; }
+		constexpr ReverseIterator<const _T*> rend() const noexcept { return _data - 1; }
+		// Power
+		constexpr size_t power(bool cap = false) const noexcept {
+			if (cap) return _power;
+			for (size_t n = _power; n; --n) if (_data[n]) return n;
+			return 0;
+		}
+		// Coefficient
+		constexpr _T& operator[](size_t n) {
+			if (n > _power) {
+				_T* temp = new _T[n + 1]{0};
+				for (size_t i = 0; i <= _power; ++i) temp[i] = _data[i];
 				delete[] _data;
-				_data = new _T[(_power = r.power()) + 1]{*r._data};
-				for (size_t n = 1; n <= _power; ++n) {
-					_data[n] = r._data[n];
+				_data = temp, _power = n;
+			}
+			return _data[n];
+		}
+		constexpr _T operator[](size_t n) const noexcept {
+			return n <= _power ? _data[n] : _T(0);
+		}
+		// Evaluation
+		template <Arithmetic _S> constexpr CommonType<_T, _S> operator()(const _S& x) const noexcept {
+			size_t n = _power;
+			CommonType<_T, _S> res = _data[n];
+			while (n--) res = _data[n] + res * x;
+			return res;
+		}
+		template <Arithmetic _S> constexpr Polynomial<CommonType<_T, _S>> operator()(const Polynomial<_S>& x) const noexcept {
+			size_t n = _power;
+			Polynomial<CommonType<_T, _S>> res = _data[n];
+			while (n--) res = _data[n] + res * x;
+			return res;
+		}
+		// Values at each of points. Batched Horner costs power() + 1 multiply-adds per point
+		// and is the only choice for floating types, whose subproduct tree polynomials grow
+		// too fast to keep any accuracy; exact types take the tree once power() * points
+		// outweighs its O(M(n) log n)
+		template <Arithmetic _S> DynamicVector<CommonType<_T, _S>> evaluate(const DynamicVector<_S>& points) const {
+			typedef CommonType<_T, _S> _R;
+			const size_t d = power(), n = points.size();
+			DynamicVector<_R> y(n);
+			if constexpr (!FloatingPoint<_R>) {
+				size_t lg = 1;
+				while (size_t(1) << lg < n) ++lg;
+				if (double(d + 1) * double(n) > _MATHLAB_SUBPRODUCT * double(n + d) * double(lg * lg)) {
+					const DynamicVector<_R> x(points);
+					const Polynomial<_R> c(*this);
+					_SubproductTree<_R>(x.data(), n).evaluate(c.begin(), d, y.data());
+					return y;
 				}
-				return *this;
 			}
-			template <class _S> constexpr Polynomial& operator=(const Polynomial<_S>& r) noexcept {
-				delete[] _data;
-				_data = new _T[(_power = r.power()) + 1]{*r._data};
-				for (size_t n = 1; n <= _power; ++n) {
-					_data[n] = r._data[n];
+			_horner(_data, d, points.data(), n, y.data());
+			return y;
+		}
+		// Reduce storage
+		constexpr Polynomial& shrinkToFit() noexcept {
+			size_t n = _power = power();
+			_T* temp = new _T[++n]{*_data};
+			while (--n) temp[n] = _data[n];
+			delete[] _data;
+			_data = temp;
+			return *this;
+		}
+	};
+	// The polynomial of degree below n through (x[i], y[i]). Newton's divided differences
+	// and their expansion, O(n^2) and split across the pool; exact non-integral types past
+	// a few hundred points go through the subproduct tree instead, M' evaluated at the
+	// points and the weights y[i] / M'(x[i]) combined up the tree in O(M(n) log n)
+	template <Arithmetic _T> Polynomial<_T> interpolate(const DynamicVector<_T>& x, const DynamicVector<_T>& y) {
+		const size_t n = x.size();
+		if (y.size() != n) throw Error(EDOM, "Dimension mismatch");
+		if (!n) return Polynomial<_T>();
+		Polynomial<_T> p(0, n - 1);
+		_T* const c = new _T[2 * n], * d = c + n;
+		::std::atomic<bool> duplicate = false;
+		if constexpr (!FloatingPoint<_T> && !Integral<_T>) if (n > 256) {
+			const _SubproductTree<_T> tree(x.data(), n);
+			const _T* const m = tree.node(tree.levels() - 1, 0);
+			for (size_t i = 0; i < n; ++i) d[i] = _T(i + 1) * m[i + 1];
+			tree.evaluate(d, n - 1, c);
+			for (size_t i = 0; i < n; ++i) {
+				if (!c[i]) {
+					duplicate = true;
+					break;
 				}
-				return *this;
-			}
-			// Iterators
-			constexpr _T* begin() noexcept { return _data; }
-			constexpr _T* end() noexcept { return _data + _power + 1; }
-			constexpr ReverseIterator<_T*> rbegin() noexcept { return _data + _power; }
-			constexpr ReverseIterator<_T*> rend() noexcept { return _data - 1; }
-			constexpr const _T* begin() const noexcept { return _data; }
-			constexpr const _T* end() const noexcept { return _data + _power + 1; }
-			constexpr ReverseIterator<const _T*> rbegin() const noexcept { return _data + _power; }
-			constexpr ReverseIterator<const _T*> rend() const noexcept { return _data - 1; }
-			// Power
-			constexpr size_t power(bool cap = false) const noexcept {
-				if (cap) return _power;
-				for (size_t n = _power; n; --n) if (_data[n]) return n;
-				return 0;
-			}
-			// Coefficient
-			constexpr _T& operator[](size_t n) noexcept {
-				_T t = 0;
-				return n <= _power ? _data[n] : t;
-			}
-			constexpr const _T& operator[](size_t n) const noexcept {
-				return n <= _power ? _data[n] : 0;
-			}
-			// Evaluation
-			template <Arithmetic _S> constexpr CommonType<_T, _S> operator()(const _S& x) const noexcept {
-				size_t n = _power;
-				CommonType<_T, _S> res = _data[n];
-				while (n--) res = _data[n] + res * x;
-				return res;
-			}
-			template <Arithmetic _S> constexpr CommonType<_T, _S> operator()(const Polynomial<_S>& x) const noexcept {
-				size_t n = _power;
-				Polynomial<CommonType<_T, _S>> res = _data[n];
-				while (n--) res = _data[n] + res * x;
-				return res;
-			}
-			// Reduce storage
-			constexpr Polynomial& shrinkToFit() noexcept {
-				size_t n = _power = power();
-				_T* temp = new _T[++n]{*_data};
-				while (--n) temp[n] = _data[n];
-				delete[] _data;
-				_data = temp;
-				return *this;
-			}
-		};
-		// Polynomial operations
-		template <class _T, class _S>
-		inline constexpr Polynomial<Plus<_T, _S>> operator+(const Polynomial<_T>& f, const Polynomial<_S>& g) {
-			size_t a = f.power(), b = g.power();
-			Polynomial<Plus<_T, _S>> p(0, a < b ? b : a);
-			for (size_t i = 0; i <= a || i <= b; ++i) p[i] = f[i] + g[i];
+				c[i] = y[i] / c[i];
+			}
+			if (!duplicate) tree.combine(c, p.begin());
+			delete[] c;
+			if (duplicate) throw Error(EDOM, "Duplicate nodes");
 			return p.shrinkToFit();
 		}
-		template <class _T, class _S>
-		inline constexpr Polynomial<Plus<_T, _S>> operator+(const Polynomial<_T>& f, const _S& g) {
-			return f + Polynomial<_S>(g);
+		_T* s = c;
+		for (size_t i = 0; i < n; ++i) s[i] = y[i];
+		for (size_t j = 1; j < n && !duplicate; ++j) {
+			parallelFor(j, n, _MATHLAB_PARALLEL_GRAIN / 4, [&](size_t i0, size_t i1) {
+				for (size_t i = i0; i < i1; ++i) {
+					const _T h = x[i] - x[i - j];
+					if (!h) duplicate = true;
+					else d[i] = (s[i] - s[i - 1]) / h;
+				}
+			});
+			for (size_t i = 0; i < j; ++i) d[i] = s[i];
+			Mathlab::swap(s, d);
 		}
-		template <class _T, class _S>
-		inline constexpr Polynomial<Plus<_T, _S>> operator+(const _T& f, const Polynomial<_S>& g) {
-			return Polynomial<_T>(f) + g;
+		if (duplicate) {
+			delete[] c;
+			throw Error(EDOM, "Duplicate nodes");
 		}
-		template <class _T, class _S>
-		inline constexpr Polynomial<Minus<_T, _S>> operator-(const Polynomial<_T>& f, const Polynomial<_S>& g) {
-			size_t a = f.power(), b = g.power();
-			Polynomial<Plus<_T, _S>> p(0, a < b ? b : a);
-			for (size_t i = 0; i <= a || i <= b; ++i) p[i] = f[i] - g[i];
-			return p.shrinkToFit();
+		//p = s[n-1], then p = p * (t - x[i]) + s[i] down to i = 0
+		_T* u = d, * v = p.begin();
+		u[0] = s[n - 1];
+		for (size_t i = n - 1; i--;) {
+			const size_t m = n - 1 - i;
+			parallelFor(0, m + 1, _MATHLAB_PARALLEL_GRAIN / 4, [&](size_t l0, size_t l1) {
+				for (size_t l = l0; l < l1; ++l) v[l] = (l ? u[l - 1] : s[i]) - (l < m ? x[i] * u[l] : _T(0));
+			});
+			Mathlab::swap(u, v);
 		}
-		template <class _T, class _S>
-		inline constexpr Polynomial<Plus<_T, _S>> operator-(const Polynomial<_T>& f, const _S& g) {
-			return f - Polynomial<_S>(g);
+		if (u != p.begin()) for (size_t l = 0; l < n; ++l) p[l] = u[l];
+		delete[] c;
+		return p.shrinkToFit();
+	}
+	// All roots of a polynomial, each with a radius guaranteed to enclose it. Aberth-Ehrlich
+	// moves every approximation at once, z_i <- z_i - 1 / (p'(z_i) / p(z_i) - S_i) with
+	// S_i = sum over j != i of 1 / (z_i - z_j), cubically convergent for simple roots. The
+	// start is read off the Newton polygon of log |a_k|, one circle per edge of its upper
+	// hull, or for RootMethod::Companion the eigenvalues of the balanced companion matrix,
+	// which is also where Aberth restarts if the first start runs out of sweeps. Updates are
+	// Jacobi steps, split across the pool and over split real and imaginary parts so the S_i
+	// loop vectorizes; a root freezes once |p(z_i)| keeps within the rounding of its evaluation.
+	// The disks of radius n |p(z_i)| / |a_n prod (z_i - z_j)|, rounding included, cover all
+	// roots, and a connected union of k of them holds exactly k
+	enum class RootMethod { Aberth, Companion };
+	template <Arithmetic _T> class PolynomialRoots {
+		typedef Promoted<_T> _P;
+		_Buffer<Complex<_P>> _z;
+		DynamicVector<_P> _e;
+		size_t _iterations;
+		bool _converged;
+		static _P _modulus(_P x, _P y) noexcept { return x || y ? _P(hypot(x, y)) : _P(0); }
+		// 1 / (x + iy), scaled first so that neither tiny nor huge moduli square out of range
+		static void _reciprocal(_P x, _P y, _P& u, _P& v) noexcept {
+			const _P m = abs(x) < abs(y) ? abs(y) : abs(x);
+			if (!m || !isfinite(m)) return void(u = v = 0);
+			x /= m, y /= m;
+			const _P q = (x * x + y * y) * m;
+			u = x / q, v = -y / q;
 		}
-		template <class _T, class _S>
-		inline constexpr Polynomial<Plus<_T, _S>> operator-(const _T& f, const Polynomial<_S>& g) {
-			return Polynomial<_T>(f) - g;
+		// p'(z) / p(z) into (gx, gy), |p(z)| into r and the bound 4n eps sum |a_k| |z|^k on its
+		// rounding into b; past the unit circle through the reversed coefficients, both r and
+		// b then divided by |z|^n
+		static void _newton(const _P* a, size_t n, _P x, _P y, _P& gx, _P& gy, _P& r, _P& b) noexcept {
+			const _P zz = x * x + y * y, eps = 4 * _P(n) * Limits<_P>::epsilon();
+			const bool reversed = zz > 1;
+			const _P wx = reversed ? x / zz : x, wy = reversed ? -y / zz : y, m = _modulus(wx, wy);
+			_P px = a[reversed ? 0 : n], py = 0, dx = 0, dy = 0, s = abs(px);
+			for (size_t k = 1; k <= n; ++k) {
+				const _P c = a[reversed ? k : n - k], t = dx * wx - dy * wy + px;
+				dy = dx * wy + dy * wx + py, dx = t;
+				const _P u = px * wx - py * wy + c;
+				py = px * wy + py * wx, px = u;
+				s = s * m + abs(c);
+			}
+			r = _modulus(px, py), b = eps * s;
+			//p'/p, reversed w (n q - w q') / q
+			if (reversed) {
+				const _P ux = n * px - (wx * dx - wy * dy), uy = n * py - (wx * dy + wy * dx);
+				dx = wx * ux - wy * uy, dy = wx * uy + wy * ux;
+			}
+			_reciprocal(px, py, px, py);
+			gx = dx * px - dy * py, gy = dx * py + dy * px;
 		}
-		template <class _T, class _S>
-		inline constexpr Polynomial<Multiplies<_T, _S>> operator*(const Polynomial<_T>& f, const Polynomial<_S>& g) {
-			size_t a = f.power(), b = g.power();
-			Polynomial<Multiplies<_T, _S>> p(0, a + b);
-			for (size_t i = 0; i <= a; ++i) for (size_t j = 0; j <= b; ++j) p[i + j] = f[i] * g[j];
-			return p.shrinkToFit();
+		// Circles of radius (|a_k| / |a_l|)^(1 / (l - k)) for the upper hull edges (k, l)
+		static void _polygon(const _P* a, size_t n, _P* x, _P* y) {
+			DynamicVector<_P> h(n + 1);
+			size_t* const v = new size_t[n + 1];
+			size_t m = 0;
+			for (size_t k = 0; k <= n; ++k) {
+				if (!a[k]) continue;
+				h[k] = log(abs(a[k]));
+				while (m > 1 && (h[v[m - 1]] - h[v[m - 2]]) * _P(k - v[m - 2])
+					<= (h[k] - h[v[m - 2]]) * _P(v[m - 1] - v[m - 2])) --m;
+				v[m++] = k;
+			}
+			for (size_t e = 0; e + 1 < m; ++e) {
+				const size_t k = v[e], l = v[e + 1];
+				const _P r = exp((h[k] - h[l]) / _P(l - k));
+				for (size_t j = k; j < l; ++j) {
+					_P t = 2 * M_PI * (_P(j - k) / _P(l - k) + _P(k) / _P(n)) + 0.4;
+					if (t >= 2 * M_PI) t -= 2 * M_PI;
+					x[j] = r * cos(t), y[j] = r * sin(t);
+				}
+			}
+			delete[] v;
 		}
-		template <class _T, class _S>
-		inline constexpr Polynomial<Plus<_T, _S>> operator*(const Polynomial<_T>& f, const _S& g) {
-			return f * Polynomial<_S>(g);
-		}
-		template <class _T, class _S>
-		inline constexpr Polynomial<Plus<_T, _S>> operator*(const _T& f, const Polynomial<_S>& g) {
-			return Polynomial<_T>(f) * g;
-		}
-		template <class _T, class _S>
-		inline constexpr Polynomial<Divides<_T, _S>> operator/(const Polynomial<_T>& f, const Polynomial<_S>& g) {
-			size_t a = f.power(), b = g.power();
-			if (a < b) return 0;
-			Polynomial<Divides<_T, _S>> q(0, a - b);
-			Polynomial<_T> r = f;
-			for (size_t i = a; i >= b; --i) {
-				auto& c = q[i - b] = r[i] / g[b];
-				for (size_t j = r[i] = 0; j < b; ++j) r[i - b + j] -= c * g[j];
-			}
-			return q.shrinkToFit();
-		}
-		template <class _T, class _S>
-		inline constexpr Polynomial<Plus<_T, _S>> operator/(const Polynomial<_T>& f, const _S& g) {
-			return f * Polynomial<_S>(1 / g);
-		}
-		template <class _T, class _S>
-		inline constexpr Polynomial<Modulus<_T, _S>> operator%(const Polynomial<_T>& f, const Polynomial<_S>& g) {
-			size_t a = f.power(), b = g.power();
-			if (a < b) return f;
-			Polynomial<Modulus<_T, _S>> r = f;
-			for (size_t i = a; i >= b; --i) {
-				auto c = r[i] / g[b];
-				for (size_t j = r[i] = 0; j < b; ++j) r[i - b + j] -= c * g[j];
-			}
-			return r;
-		}
-		template <class _T, class _S>
-		inline constexpr bool operator==(const Polynomial<_T>& f, const Polynomial<_S>& g) {
-			int a = f.power(), b = g.power();
-			if (a != b) return 0;
-			for (int i = 0; i < a; ++i) if (f[a] != f[b]) return 0;
-			return 1;
-		}
-		template <class _T, class _S>
-		inline constexpr bool operator<(const Polynomial<_T>& f, const Polynomial<_S>& g) {
-			int a = f.power(), b = g.power();
-			if (a != b) return a < b;
-			do {
-				if (f[a] != g[a]) return f[a] < g[a];
-			} while (a--);
-			return 0;
+		static void _companion(const _P* a, size_t n, _P* x, _P* y) {
+			DynamicMatrix<_P> c(n, n);
+			for (size_t j = 0; j < n; ++j) c.data()[j] = -a[n - 1 - j] / a[n];
+			for (size_t i = 1; i < n; ++i) c.data()[i * n + i - 1] = 1;
+			Kernel::realSchur<_P>(n, c.data(), n, x, y, nullptr, n);
 		}
-#if !_OLD_CXX
-		template <class _T, class _S>
-		inline constexpr Comparison<_T, _S> operator<=>(const Polynomial<_T>& f, const Polynomial<_S>& g) {
-			int a = f.power(), b = g.power();
-			if (a != b) return a <=> b;
-			do {
-				if (f[a] != g[a]) return f[a] <=> g[a];
-			} while (a--);
-			return 1;
+		// Jacobi sweeps from (x, y) until every root is frozen or limit sweeps have passed. A
+		// root freezes on its third sweep with |p| within rounding: the first such step tends
+		// to stop well short of the attainable accuracy on clusters
+		static bool _aberth(const _P* a, size_t n, _P* x, _P* y, size_t limit, size_t& iterations) {
+			DynamicVector<_P> u(n), w(n);
+			_Buffer<unsigned char> done(n);
+			size_t active = n;
+			for (; active && limit--; ++iterations) {
+				parallelFor(0, n, 1 + _MATHLAB_PARALLEL_GRAIN / (4 * n), [&](size_t i0, size_t i1) {
+					for (size_t i = i0; i < i1; ++i) {
+						u[i] = x[i], w[i] = y[i];
+						if (done[i] >= 3) continue;
+						_P gx, gy, r, b, sx = 0, sy = 0;
+						_newton(a, n, x[i], y[i], gx, gy, r, b);
+						if (!r) {
+							done[i] = 3;
+							continue;
+						}
+						done[i] += r <= b;
+						const _P xi = x[i], yi = y[i];
+						for (size_t j = 0; j < i; ++j) {
+							const _P dx = xi - x[j], dy = yi - y[j], q = dx * dx + dy * dy;
+							sx += dx / q, sy -= dy / q;
+						}
+						for (size_t j = i + 1; j < n; ++j) {
+							const _P dx = xi - x[j], dy = yi - y[j], q = dx * dx + dy * dy;
+							sx += dx / q, sy -= dy / q;
+						}
+						_P dx, dy;
+						_reciprocal(gx - sx, gy - sy, dx, dy);
+						if (dx || dy) u[i] = xi - dx, w[i] = yi - dy;
+						//Coincident approximations: push apart off the real axis
+						else w[i] = yi + (abs(xi) + abs(yi) + 1) * 0x1p-20 * (i & 1 ? 1 : -1);
+					}
+				});
+				for (size_t i = 0; i < n; ++i) x[i] = u[i], y[i] = w[i];
+				active = 0;
+				for (size_t i = 0; i < n; ++i) active += done[i] < 3;
+			}
+			return !active;
 		}
-#endif
+		static constexpr _P _power2(int e) noexcept {
+			_P p = 1;
+			for (; e > 0; --e) p *= 2;
+			for (; e < 0; ++e) p /= 2;
+			return p;
+		}
+		// 2^(E/4) and its square root for the largest binary exponent E of _P, so a product
+		// or quotient of two steps stays finite and normal
+		static constexpr _P _step = _power2(Limits<_P>::max_exponent / 4);
+		static constexpr _P _root = _power2(Limits<_P>::max_exponent / 8);
+		// m f, or m / f, with m _step^k kept at m within [1 / _step, _step]; a zero or
+		// non-finite factor leaves m at its limit, 0 or infinity, for good
+		static void _scale(_P& m, long& k, _P f, bool inverse = false) noexcept {
+			if (!m || !isfinite(m)) return;
+			if (!f || !isfinite(f)) return void(m = inverse != !f ? _P(0) : infinity<_P>());
+			long j = 0;
+			for (; f > _step; ++j) f /= _step;
+			for (; f < 1 / _step; --j) f *= _step;
+			if (inverse) m /= f, k -= j;
+			else m *= f, k += j;
+			for (; m > _step; ++k) m /= _step;
+			for (; m < 1 / _step; --k) m *= _step;
+		}
+		// Inclusion radius n (|p(z_i)| + b) / |a_n prod (z_i - z_j)|, its squared inverse
+		// gathered through _scale so degree-many factors can neither overflow nor vanish
+		static void _radii(const _P* a, size_t n, const _P* x, const _P* y, _P* e) {
+			parallelFor(0, n, 1 + _MATHLAB_PARALLEL_GRAIN / (4 * n), [&](size_t i0, size_t i1) {
+				for (size_t i = i0; i < i1; ++i) {
+					_P gx, gy, r, b, m = 1;
+					_newton(a, n, x[i], y[i], gx, gy, r, b);
+					const _P zz = x[i] * x[i] + y[i] * y[i], u = _P(n) * (r + b);
+					long k = 0;
+					bool finite = isfinite(u) && isfinite(zz);
+					if (!u) {
+						e[i] = 0;
+						continue;
+					}
+					if (finite) {
+						_scale(m, k, abs(a[n])), _scale(m, k, abs(a[n]));
+						_scale(m, k, u, true), _scale(m, k, u, true);
+						if (zz > 1) _scale(m, k, zz, true);
+					}
+					for (size_t j = 0; j < n && finite; ++j) {
+						if (j == i) continue;
+						const _P dx = x[i] - x[j], dy = y[i] - y[j], q = dx * dx + dy * dy;
+						if (!q || !isfinite(q)) finite = q;
+						else _scale(m, k, zz > 1 ? q / zz : q);
+					}
+					_P t = finite ? 1 / _P(sqrt(m)) : infinity<_P>();
+					for (; k > 0 && t; --k) t /= _root;
+					for (; k < 0 && isfinite(t); ++k) t *= _root;
+					e[i] = t;
+				}
+			});
+		}
+	public:
+		typedef _P ValueType;
+		PolynomialRoots(const Polynomial<_T>& p, RootMethod method = RootMethod::Aberth)
+			: _z(p.power()), _e(p.power()), _iterations(0), _converged(true) {
+			const size_t d = p.power();
+			if (!d) {
+				if (!p[0]) throw Error(EDOM, "Zero polynomial");
+				return;
+			}
+			//Zero roots split off exactly
+			size_t z = 0;
+			while (!p[z]) _z[z++] = Complex<_P>{ 0, 0 };
+			const size_t n = d - z;
+			if (!n) return;
+			DynamicVector<_P> a(n + 1), x(n), y(n);
+			for (size_t k = 0; k <= n; ++k) a[k] = _P(p[z + k]);
+			const size_t limit = 64 + n / 4;
+			if (method == RootMethod::Aberth) {
+				_polygon(a.data(), n, x.data(), y.data());
+				_converged = _aberth(a.data(), n, x.data(), y.data(), limit, _iterations);
+			}
+			if (method == RootMethod::Companion || !_converged) {
+				_companion(a.data(), n, x.data(), y.data());
+				_converged = _aberth(a.data(), n, x.data(), y.data(), limit, _iterations);
+			}
+			_radii(a.data(), n, x.data(), y.data(), _e.data() + z);
+			for (size_t i = 0; i < n; ++i) _z[z + i] = Complex<_P>{ x[i], y[i] };
+		}
+		constexpr size_t size() const noexcept { return _z.size(); }
+		constexpr bool converged() const noexcept { return _converged; }
+		//Aberth sweeps taken, over both starts when the companion one was needed
+		constexpr size_t iterations() const noexcept { return _iterations; }
+		constexpr const Complex<_P>* roots() const noexcept { return _z.data(); }
+		constexpr const DynamicVector<_P>& errors() const noexcept { return _e; }
+	};
+	template <class _T> PolynomialRoots(const Polynomial<_T>&, RootMethod = RootMethod::Aberth)
+		-> PolynomialRoots<_T>;
+	// Polynomial operations
+	template <class _T> inline constexpr bool _isPolynomial = false;
+	template <class _T> inline constexpr bool _isPolynomial<Polynomial<_T>> = true;
+	template <class _T, class _S>
+	inline constexpr Polynomial<Plus<_T, _S>> operator+(const Polynomial<_T>& f, const Polynomial<_S>& g) {
+		size_t a = f.power(), b = g.power();
+		Polynomial<Plus<_T, _S>> p(0, a < b ? b : a);
+		for (size_t i = 0; i <= a || i <= b; ++i) p[i] = f[i] + g[i];
+		return p.shrinkToFit();
+	}
+	template <class _T, class _S> requires (!_isPolynomial<_S>)
+	inline constexpr Polynomial<Plus<_T, _S>> operator+(const Polynomial<_T>& f, const _S& g) {
+		return f + Polynomial<_S>(g);
+	}
+	template <class _T, class _S> requires (!_isPolynomial<_T>)
+	inline constexpr Polynomial<Plus<_T, _S>> operator+(const _T& f, const Polynomial<_S>& g) {
+		return Polynomial<_T>(f) + g;
+	}
+	template <class _T, class _S>
+	inline constexpr Polynomial<Minus<_T, _S>> operator-(const Polynomial<_T>& f, const Polynomial<_S>& g) {
+		size_t a = f.power(), b = g.power();
+		Polynomial<Minus<_T, _S>> p(0, a < b ? b : a);
+		for (size_t i = 0; i <= a || i <= b; ++i) p[i] = f[i] - g[i];
+		return p.shrinkToFit();
+	}
+	template <class _T, class _S> requires (!_isPolynomial<_S>)
+	inline constexpr Polynomial<Minus<_T, _S>> operator-(const Polynomial<_T>& f, const _S& g) {
+		return f - Polynomial<_S>(g);
+	}
+	template <class _T, class _S> requires (!_isPolynomial<_T>)
+	inline constexpr Polynomial<Minus<_T, _S>> operator-(const _T& f, const Polynomial<_S>& g) {
+		return Polynomial<_T>(f) - g;
+	}
+	// Schoolbook, Karatsuba, FFT or NTT product by degree and coefficient type
+	template <class _T, class _S>
+	inline constexpr Polynomial<Multiplies<_T, _S>> operator*(const Polynomial<_T>& f, const Polynomial<_S>& g) {
+		typedef Multiplies<_T, _S> _R;
+		const Polynomial<_R> x(f), y(g);
+		const size_t a = x.power(true), b = y.power(true);
+		Polynomial<_R> p(0, a + b);
+		Kernel::convolve(x.begin(), a + 1, y.begin(), b + 1, p.begin());
+		return p.shrinkToFit();
+	}
+	template <class _T, class _S> requires (!_isPolynomial<_S>)
+	inline constexpr Polynomial<Multiplies<_T, _S>> operator*(const Polynomial<_T>& f, const _S& g) {
+		return f * Polynomial<_S>(g);
 	}
+	template <class _T, class _S> requires (!_isPolynomial<_T>)
+	inline constexpr Polynomial<Multiplies<_T, _S>> operator*(const _T& f, const Polynomial<_S>& g) {
+		return Polynomial<_T>(f) * g;
+	}
+	template <class _T, class _S>
+	inline constexpr Polynomial<Divides<_T, _S>> operator/(const Polynomial<_T>& f, const Polynomial<_S>& g) {
+		typedef Divides<_T, _S> _R;
+		const size_t a = f.power(), b = g.power();
+		if (!g[b]) throw Error(EDOM, "Division by zero");
+		if (a < b) return Polynomial<_R>();
+		Polynomial<_R> q(0, a - b), r(f);
+		const Polynomial<_R> d(g);
+		_divide(r.begin(), a, d.begin(), b, q.begin());
+		return q.shrinkToFit();
+	}
+	template <class _T, class _S> requires (!_isPolynomial<_S>)
+	inline constexpr Polynomial<Divides<_T, _S>> operator/(const Polynomial<_T>& f, const _S& g) {
+		const size_t a = f.power();
+		Polynomial<Divides<_T, _S>> p(0, a);
+		for (size_t i = 0; i <= a; ++i) p[i] = f[i] / g;
+		return p.shrinkToFit();
+	}
+	template <class _T, class _S>
+	inline constexpr Polynomial<Divides<_T, _S>> operator%(const Polynomial<_T>& f, const Polynomial<_S>& g) {
+		typedef Divides<_T, _S> _R;
+		const size_t a = f.power(), b = g.power();
+		if (!g[b]) throw Error(EDOM, "Division by zero");
+		Polynomial<_R> r(f);
+		if (a < b) return r;
+		Polynomial<_R> q(0, a - b);
+		const Polynomial<_R> d(g);
+		_divide(r.begin(), a, d.begin(), b, q.begin());
+		return r.shrinkToFit();
+	}
+	template <class _T, class _S>
+	inline constexpr bool operator==(const Polynomial<_T>& f, const Polynomial<_S>& g) {
+		size_t a = f.power(), b = g.power();
+		if (a != b) return 0;
+		for (size_t i = 0; i <= a; ++i) if (f[i] != g[i]) return 0;
+		return 1;
+	}
+	template <class _T, class _S>
+	inline constexpr bool operator<(const Polynomial<_T>& f, const Polynomial<_S>& g) {
+		int a = f.power(), b = g.power();
+		if (a != b) return a < b;
+		do {
+			if (f[a] != g[a]) return f[a] < g[a];
+		} while (a--);
+		return 0;
+	}
+#if !_OLD_CXX
+	template <class _T, class _S>
+	inline constexpr Comparison<_T, _S> operator<=>(const Polynomial<_T>& f, const Polynomial<_S>& g) {
+		int a = f.power(), b = g.power();
+		if (a != b) return a <=> b;
+		do {
+			if (f[a] != g[a]) return f[a] <=> g[a];
+		} while (a--);
+		return 1;
+	}
+#endif
 }
 #endif
\ No newline at end of file
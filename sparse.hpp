@@ -0,0 +1,378 @@
+#pragma once
+#ifndef _MATHLAB_SPARSE_
+#define _MATHLAB_SPARSE_ 1
+#include "dynamic.hpp"
+#ifndef _MATHLAB_SPARSE_GRAIN
+//Fewest nonzeros a sparse product hands to a thread of its own
+#define _MATHLAB_SPARSE_GRAIN 32768
+#endif
+namespace Mathlab {
+	// 0 Kernels shared by the formats
+	//Calls f(r0, r1) on consecutive ranges of the n outer indices of ptr, cut so that the
+	//ranges hold about as many nonzeros each, one range per thread of the pool
+	template <class _F> void _parallelOuter(size_t n, const size_t* ptr, const _F& f) {
+		const size_t nnz = ptr[n], hw = threadPool().size();
+		size_t t = nnz / _MATHLAB_SPARSE_GRAIN;
+		if (t > hw) t = hw;
+		if (t > n) t = n;
+		if (t < 2) return f(size_t(0), n);
+		DynamicVector<size_t> cut(t + 1);
+		for (size_t k = 1; k < t; ++k) {
+			size_t lo = cut[k - 1], hi = n;
+			const size_t goal = nnz / t * k;
+			while (lo < hi) {
+				const size_t mid = lo + (hi - lo) / 2;
+				if (ptr[mid] < goal) lo = mid + 1;
+				else hi = mid;
+			}
+			cut[k] = lo;
+		}
+		cut[t] = n;
+		parallelFor(0, t, 1, [&](size_t k0, size_t k1) {
+			for (size_t k = k0; k < k1; ++k) f(cut[k], cut[k + 1]);
+		});
+	}
+	template <class _F> constexpr void _forOuter(size_t n, const size_t* ptr, const _F& f) {
+		if (::std::is_constant_evaluated()) f(size_t(0), n);
+		else _parallelOuter(n, ptr, f);
+	}
+	//Ascending order; insertion sort for the short runs that dominate, heapsort beyond
+	constexpr void _sortIndices(size_t* a, size_t n) noexcept {
+		if (n <= 32) {
+			for (size_t i = 1; i < n; ++i) {
+				const size_t t = a[i];
+				size_t j = i;
+				for (; j && t < a[j - 1]; --j) a[j] = a[j - 1];
+				a[j] = t;
+			}
+			return;
+		}
+		const auto sift = [a](size_t i, size_t e) {
+			for (size_t c; (c = 2 * i + 1) < e; i = c) {
+				if (c + 1 < e && a[c] < a[c + 1]) ++c;
+				if (!(a[i] < a[c])) break;
+				swap(a[i], a[c]);
+			}
+		};
+		for (size_t i = n / 2; i-- > 0;) sift(i, n);
+		for (size_t e = n; --e > 0;) swap(a[0], a[e]), sift(0, e);
+	}
+	template <class _T> constexpr void _shrink(DynamicVector<_T>& v, size_t n) {
+		if (n == v.size()) return;
+		DynamicVector<_T> w(n);
+		for (size_t i = 0; i < n; ++i) w[i] = v[i];
+		v = static_cast<DynamicVector<_T>&&>(w);
+	}
+	//Sorts nnz triplets by (outer, inner) through two stable counting sorts and sums
+	//duplicates, giving compressed storage over n outer and m inner indices
+	template <class _T, class _S> constexpr void _compress(size_t n, size_t m, size_t nnz,
+		const size_t* outer, const size_t* inner, const _S* val,
+		DynamicVector<size_t>& ptr, DynamicVector<size_t>& idx, DynamicVector<_T>& v) {
+		DynamicVector<size_t> cnt(m + 1), byInner(nnz), order(nnz);
+		for (size_t k = 0; k < nnz; ++k) ++cnt[inner[k] + 1];
+		for (size_t j = 0; j < m; ++j) cnt[j + 1] += cnt[j];
+		for (size_t k = 0; k < nnz; ++k) byInner[cnt[inner[k]]++] = k;
+		ptr = DynamicVector<size_t>(n + 1);
+		for (size_t k = 0; k < nnz; ++k) ++ptr[outer[k] + 1];
+		for (size_t i = 0; i < n; ++i) ptr[i + 1] += ptr[i];
+		DynamicVector<size_t> pos(ptr);
+		for (size_t k : byInner) order[pos[outer[k]]++] = k;
+		idx = DynamicVector<size_t>(nnz), v = DynamicVector<_T>(nnz);
+		size_t q = 0;
+		for (size_t i = 0; i < n; ++i) {
+			const size_t start = q;
+			for (size_t p = ptr[i]; p < ptr[i + 1]; ++p) {
+				const size_t k = order[p];
+				if (q > start && idx[q - 1] == inner[k]) v[q - 1] += val[k];
+				else idx[q] = inner[k], v[q] = val[k], ++q;
+			}
+			ptr[i] = start;
+		}
+		ptr[n] = q;
+		_shrink(idx, q), _shrink(v, q);
+	}
+	//Compressed storage of an n*m matrix into that of its m*n transpose, conjugated if
+	//Conj; a counting sort on the inner indices, which leaves every list sorted
+	template <bool Conj, class _T> constexpr void _transposeCompressed(size_t n, size_t m,
+		const size_t* ptr, const size_t* idx, const _T* val,
+		DynamicVector<size_t>& tptr, DynamicVector<size_t>& tidx, DynamicVector<_T>& tval) {
+		const size_t nnz = ptr[n];
+		tptr = DynamicVector<size_t>(m + 1), tidx = DynamicVector<size_t>(nnz), tval = DynamicVector<_T>(nnz);
+		for (size_t p = 0; p < nnz; ++p) ++tptr[idx[p] + 1];
+		for (size_t j = 0; j < m; ++j) tptr[j + 1] += tptr[j];
+		DynamicVector<size_t> pos(tptr);
+		for (size_t i = 0; i < n; ++i) for (size_t p = ptr[i]; p < ptr[i + 1]; ++p) {
+			const size_t q = pos[idx[p]]++;
+			tidx[q] = i;
+			if constexpr (Conj) tval[q] = conj(val[p]);
+			else tval[q] = val[p];
+		}
+	}
+	//y(n) = A x for compressed rows, threaded over row ranges
+	template <class _R, class _T, class _S> constexpr void _spmv(size_t n, const size_t* ptr,
+		const size_t* idx, const _T* val, const _S* x, _R* y) {
+		_forOuter(n, ptr, [=](size_t r0, size_t r1) {
+			for (size_t i = r0; i < r1; ++i) {
+				_R t = 0;
+				for (size_t p = ptr[i]; p < ptr[i + 1]; ++p) t += val[p] * x[idx[p]];
+				y[i] = t;
+			}
+		});
+	}
+	//C(n*m) = A B for compressed rows (Gustavson): a symbolic pass counts each row of C,
+	//then a numeric pass gathers it in a dense accumulator. Both are threaded over rows
+	template <class _R, class _T, class _S> constexpr void _spgemm(size_t n, size_t m,
+		const size_t* aptr, const size_t* aidx, const _T* aval,
+		const size_t* bptr, const size_t* bidx, const _S* bval,
+		DynamicVector<size_t>& ptr, DynamicVector<size_t>& idx, DynamicVector<_R>& val) {
+		ptr = DynamicVector<size_t>(n + 1);
+		size_t* const cptr = ptr.data();
+		_forOuter(n, aptr, [=](size_t r0, size_t r1) {
+			DynamicVector<size_t> mark(m, size_t(-1));
+			for (size_t i = r0; i < r1; ++i) {
+				size_t c = 0;
+				for (size_t p = aptr[i]; p < aptr[i + 1]; ++p)
+					for (size_t q = bptr[aidx[p]]; q < bptr[aidx[p] + 1]; ++q)
+						if (mark[bidx[q]] != i) mark[bidx[q]] = i, ++c;
+				cptr[i + 1] = c;
+			}
+		});
+		for (size_t i = 0; i < n; ++i) cptr[i + 1] += cptr[i];
+		idx = DynamicVector<size_t>(cptr[n]), val = DynamicVector<_R>(cptr[n]);
+		size_t* const cidx = idx.data();
+		_R* const cval = val.data();
+		_forOuter(n, aptr, [=](size_t r0, size_t r1) {
+			DynamicVector<size_t> mark(m, size_t(-1));
+			DynamicVector<_R> acc(m);
+			for (size_t i = r0; i < r1; ++i) {
+				size_t c = cptr[i];
+				for (size_t p = aptr[i]; p < aptr[i + 1]; ++p) {
+					const _T a = aval[p];
+					for (size_t q = bptr[aidx[p]]; q < bptr[aidx[p] + 1]; ++q) {
+						const size_t j = bidx[q];
+						if (mark[j] != i) mark[j] = i, cidx[c++] = j, acc[j] = a * bval[q];
+						else acc[j] += a * bval[q];
+					}
+				}
+				_sortIndices(cidx + cptr[i], c - cptr[i]);
+				for (size_t q = cptr[i]; q < c; ++q) cval[q] = acc[cidx[q]];
+			}
+		});
+	}
+	// 1 Sparse matrices
+	//CSR keeps each row's column indices in ascending order with their values, CSC is
+	//the CSR storage of the transpose, COO is an unordered list of (row, column, value)
+	//triplets for assembly, where duplicates are summed on conversion
+	enum class SparseFormat { CSR, CSC, COO };
+	template <Arithmetic _T = double, SparseFormat F = SparseFormat::CSR> class SparseMatrix {
+		static_assert(F != SparseFormat::COO);
+		size_t _rows, _cols;
+		DynamicVector<size_t> _ptr, _idx;
+		DynamicVector<_T> _val;
+		typedef struct { size_t a, b; } _index_t;
+		static constexpr bool _csr = F == SparseFormat::CSR;
+		template <Arithmetic, SparseFormat> friend class SparseMatrix;
+	public:
+		typedef _T ValueType;
+		static constexpr SparseFormat format = F;
+		constexpr SparseMatrix() noexcept : _rows(0), _cols(0) {}
+		//Zero matrix
+		constexpr SparseMatrix(size_t x, size_t y) : _rows(x), _cols(y), _ptr((_csr ? x : y) + 1) {}
+		//Takes compressed storage as is: ptr has one more entry than there are rows (CSR)
+		//or columns (CSC), and each list of indices is ascending
+		constexpr SparseMatrix(size_t x, size_t y, DynamicVector<size_t> ptr,
+			DynamicVector<size_t> idx, DynamicVector<_T> val)
+			: _rows(x), _cols(y), _ptr(static_cast<DynamicVector<size_t>&&>(ptr)),
+			_idx(static_cast<DynamicVector<size_t>&&>(idx)), _val(static_cast<DynamicVector<_T>&&>(val)) {
+			const size_t n = _csr ? x : y;
+			if (_ptr.size() != n + 1 || _idx.size() != _ptr[n] || _val.size() != _ptr[n])
+				throw Error(EDOM, "Dimension mismatch");
+		}
+		//Nonzero entries of a dense matrix
+		template <class _S, bool C> explicit constexpr SparseMatrix(const DynamicMatrix<_S, C>& m)
+			: _rows(m.rows()), _cols(m.columns()) {
+			const size_t n = _csr ? _rows : _cols, k = _csr ? _cols : _rows;
+			_ptr = DynamicVector<size_t>(n + 1);
+			for (size_t i = 0; i < n; ++i) for (size_t j = 0; j < k; ++j)
+				_ptr[i + 1] += (_csr ? m[{i, j}] : m[{j, i}]) != 0;
+			for (size_t i = 0; i < n; ++i) _ptr[i + 1] += _ptr[i];
+			_idx = DynamicVector<size_t>(_ptr[n]), _val = DynamicVector<_T>(_ptr[n]);
+			for (size_t i = 0, q = 0; i < n; ++i) for (size_t j = 0; j < k; ++j) {
+				const _S& s = _csr ? m[{i, j}] : m[{j, i}];
+				if (s != 0) _idx[q] = j, _val[q++] = s;
+			}
+		}
+		template <class _S> explicit constexpr SparseMatrix(const SparseMatrix<_S, SparseFormat::COO>& m)
+			: _rows(m.rows()), _cols(m.columns()) {
+			_compress(_csr ? _rows : _cols, _csr ? _cols : _rows, m.nonZeros(),
+				_csr ? m.rowIndices() : m.columnIndices(), _csr ? m.columnIndices() : m.rowIndices(),
+				m.values(), _ptr, _idx, _val);
+		}
+		template <class _S, SparseFormat G> requires (G != SparseFormat::COO)
+		explicit constexpr SparseMatrix(const SparseMatrix<_S, G>& m) : _rows(m._rows), _cols(m._cols) {
+			const size_t n = m._csr ? _rows : _cols;
+			if constexpr (G == F) {
+				_ptr = m._ptr, _idx = m._idx, _val = DynamicVector<_T>(m._val.size());
+				for (size_t p = 0; p < _val.size(); ++p) _val[p] = m._val[p];
+			} else {
+				DynamicVector<_S> val;
+				_transposeCompressed<false>(n, m._csr ? _cols : _rows, m.pointers(), m.indices(), m.values(),
+					_ptr, _idx, val);
+				_val = DynamicVector<_T>(val.size());
+				for (size_t p = 0; p < _val.size(); ++p) _val[p] = val[p];
+			}
+		}
+		constexpr size_t rows() const noexcept { return _rows; }
+		constexpr size_t columns() const noexcept { return _cols; }
+		constexpr size_t nonZeros() const noexcept { return _val.size(); }
+		//Compressed storage: entries ptr[k] to ptr[k + 1] of indices and values belong to
+		//row k (CSR) or column k (CSC)
+		constexpr const size_t* pointers() const noexcept { return _ptr.data(); }
+		constexpr const size_t* indices() const noexcept { return _idx.data(); }
+		constexpr const _T* values() const noexcept { return _val.data(); }
+		constexpr _T* values() noexcept { return _val.data(); }
+		//Entry (a, b), found by binary search
+		constexpr _T operator[](_index_t z) const noexcept {
+			const size_t o = _csr ? z.a : z.b, i = _csr ? z.b : z.a;
+			size_t lo = _ptr[o], hi = _ptr[o + 1];
+			while (lo < hi) {
+				const size_t mid = lo + (hi - lo) / 2;
+				if (_idx[mid] < i) lo = mid + 1;
+				else hi = mid;
+			}
+			return lo < _ptr[o + 1] && _idx[lo] == i ? _val[lo] : _T(0);
+		}
+		template <bool C> explicit constexpr operator DynamicMatrix<_T, C>() const {
+			DynamicMatrix<_T, C> m(_rows, _cols);
+			const size_t n = _csr ? _rows : _cols;
+			for (size_t k = 0; k < n; ++k) for (size_t p = _ptr[k]; p < _ptr[k + 1]; ++p)
+				if (_csr) m[{ k, _idx[p] }] = _val[p];
+				else m[{ _idx[p], k }] = _val[p];
+			return m;
+		}
+		template <Arithmetic _S> constexpr SparseMatrix& operator*=(const _S& s) noexcept {
+			for (_T& t : _val) t *= s;
+			return *this;
+		}
+		template <Arithmetic _S> constexpr SparseMatrix& operator/=(const _S& s) noexcept {
+			for (_T& t : _val) t /= s;
+			return *this;
+		}
+	};
+	template <Arithmetic _T> class SparseMatrix<_T, SparseFormat::COO> {
+		size_t _rows, _cols, _nnz;
+		DynamicVector<size_t> _row, _col;
+		DynamicVector<_T> _val;
+	public:
+		typedef _T ValueType;
+		static constexpr SparseFormat format = SparseFormat::COO;
+		constexpr SparseMatrix() noexcept : _rows(0), _cols(0), _nnz(0) {}
+		//Empty matrix with room for capacity entries before the storage grows
+		constexpr SparseMatrix(size_t x, size_t y, size_t capacity = 0)
+			: _rows(x), _cols(y), _nnz(0), _row(capacity), _col(capacity), _val(capacity) {}
+		template <class _S, bool C> explicit constexpr SparseMatrix(const DynamicMatrix<_S, C>& m)
+			: SparseMatrix(m.rows(), m.columns()) {
+			for (size_t i = 0; i < _rows; ++i) for (size_t j = 0; j < _cols; ++j)
+				if (m[{i, j}] != 0) insert(i, j, m[{i, j}]);
+		}
+		template <class _S, SparseFormat G> requires (G != SparseFormat::COO)
+		explicit constexpr SparseMatrix(const SparseMatrix<_S, G>& m)
+			: SparseMatrix(m.rows(), m.columns(), m.nonZeros()) {
+			const bool csr = G == SparseFormat::CSR;
+			const size_t* ptr = m.pointers();
+			for (size_t k = 0; k < (csr ? _rows : _cols); ++k) for (size_t p = ptr[k]; p < ptr[k + 1]; ++p)
+				csr ? insert(k, m.indices()[p], m.values()[p]) : insert(m.indices()[p], k, m.values()[p]);
+		}
+		constexpr size_t rows() const noexcept { return _rows; }
+		constexpr size_t columns() const noexcept { return _cols; }
+		constexpr size_t nonZeros() const noexcept { return _nnz; }
+		constexpr const size_t* rowIndices() const noexcept { return _row.data(); }
+		constexpr const size_t* columnIndices() const noexcept { return _col.data(); }
+		constexpr const _T* values() const noexcept { return _val.data(); }
+		constexpr _T* values() noexcept { return _val.data(); }
+		//Appends t at (a, b), doubling the storage when it is full
+		constexpr SparseMatrix& insert(size_t a, size_t b, const _T& t) {
+			if (a >= _rows || b >= _cols) throw Error(ERANGE, "Out of range");
+			if (_nnz == _val.size()) {
+				const size_t cap = _nnz ? 2 * _nnz : 16;
+				DynamicVector<size_t> row(cap), col(cap);
+				DynamicVector<_T> val(cap);
+				for (size_t k = 0; k < _nnz; ++k) row[k] = _row[k], col[k] = _col[k], val[k] = _val[k];
+				_row = static_cast<DynamicVector<size_t>&&>(row), _col = static_cast<DynamicVector<size_t>&&>(col);
+				_val = static_cast<DynamicVector<_T>&&>(val);
+			}
+			_row[_nnz] = a, _col[_nnz] = b, _val[_nnz++] = t;
+			return *this;
+		}
+		template <bool C> explicit constexpr operator DynamicMatrix<_T, C>() const {
+			DynamicMatrix<_T, C> m(_rows, _cols);
+			for (size_t k = 0; k < _nnz; ++k) m[{ _row[k], _col[k] }] += _val[k];
+			return m;
+		}
+	};
+	// 2 Operations
+	template <bool Conj, class _T, SparseFormat F> constexpr SparseMatrix<_T, F> _transpose(const SparseMatrix<_T, F>& m) {
+		if constexpr (F == SparseFormat::COO) {
+			SparseMatrix<_T, F> t(m.columns(), m.rows(), m.nonZeros());
+			for (size_t k = 0; k < m.nonZeros(); ++k)
+				t.insert(m.columnIndices()[k], m.rowIndices()[k], Conj ? conj(m.values()[k]) : m.values()[k]);
+			return t;
+		} else {
+			const bool csr = F == SparseFormat::CSR;
+			DynamicVector<size_t> ptr, idx;
+			DynamicVector<_T> val;
+			_transposeCompressed<Conj>(csr ? m.rows() : m.columns(), csr ? m.columns() : m.rows(),
+				m.pointers(), m.indices(), m.values(), ptr, idx, val);
+			return SparseMatrix<_T, F>(m.columns(), m.rows(), static_cast<DynamicVector<size_t>&&>(ptr),
+				static_cast<DynamicVector<size_t>&&>(idx), static_cast<DynamicVector<_T>&&>(val));
+		}
+	}
+	template <class _T, SparseFormat F> constexpr SparseMatrix<_T, F> transpose(const SparseMatrix<_T, F>& m) {
+		return _transpose<false>(m);
+	}
+	template <class _T, SparseFormat F> constexpr SparseMatrix<_T, F> transjugate(const SparseMatrix<_T, F>& m) {
+		return _transpose<true>(m);
+	}
+	template <class _T, class _S, SparseFormat F> constexpr DynamicVector<Multiplies<_T, _S>>
+		operator*(const SparseMatrix<_T, F>& lhs, const DynamicVector<_S>& rhs) {
+		typedef Multiplies<_T, _S> _R;
+		if (lhs.columns() != rhs.size()) throw Error(EDOM, "Dimension mismatch");
+		DynamicVector<_R> v(lhs.rows());
+		if constexpr (F == SparseFormat::CSR)
+			_spmv(lhs.rows(), lhs.pointers(), lhs.indices(), lhs.values(), rhs.data(), v.data());
+		else if constexpr (F == SparseFormat::CSC) { //Scatter column j times x[j]
+			const size_t* ptr = lhs.pointers();
+			for (size_t j = 0; j < lhs.columns(); ++j) for (size_t p = ptr[j]; p < ptr[j + 1]; ++p)
+				v[lhs.indices()[p]] += lhs.values()[p] * rhs[j];
+		} else for (size_t k = 0; k < lhs.nonZeros(); ++k)
+			v[lhs.rowIndices()[k]] += lhs.values()[k] * rhs[lhs.columnIndices()[k]];
+		return v;
+	}
+	template <class _T, class _S, SparseFormat F, size_t N> constexpr DynamicVector<Multiplies<_T, _S>>
+		operator*(const SparseMatrix<_T, F>& lhs, const Vector<_S, N>& rhs) {
+		return lhs * DynamicVector<_S>(rhs);
+	}
+	//Sparse product in the format of lhs; a CSC product is the CSR product of the
+	//transposes in reverse order, and other operands are converted first
+	template <class _T, class _S, SparseFormat F, SparseFormat G> constexpr SparseMatrix<Multiplies<_T, _S>, F>
+		operator*(const SparseMatrix<_T, F>& lhs, const SparseMatrix<_S, G>& rhs) {
+		typedef Multiplies<_T, _S> _R;
+		if (lhs.columns() != rhs.rows()) throw Error(EDOM, "Dimension mismatch");
+		if constexpr (F == SparseFormat::COO)
+			return SparseMatrix<_R, F>(SparseMatrix<_T>(lhs) * rhs);
+		else if constexpr (G != F) return lhs * SparseMatrix<_S, F>(rhs);
+		else {
+			const bool csr = F == SparseFormat::CSR;
+			const size_t n = csr ? lhs.rows() : rhs.columns(), m = csr ? rhs.columns() : lhs.rows();
+			DynamicVector<size_t> ptr, idx;
+			DynamicVector<_R> val;
+			if (csr) _spgemm(n, m, lhs.pointers(), lhs.indices(), lhs.values(),
+				rhs.pointers(), rhs.indices(), rhs.values(), ptr, idx, val);
+			else _spgemm(n, m, rhs.pointers(), rhs.indices(), rhs.values(),
+				lhs.pointers(), lhs.indices(), lhs.values(), ptr, idx, val);
+			return SparseMatrix<_R, F>(lhs.rows(), rhs.columns(), static_cast<DynamicVector<size_t>&&>(ptr),
+				static_cast<DynamicVector<size_t>&&>(idx), static_cast<DynamicVector<_R>&&>(val));
+		}
+	}
+}
+#endif
\ No newline at end of file
@@ -1,12 +1,19 @@
 #pragma once
 #include "slice.hpp"
 #include "math.hpp"
+#include "parallel.hpp"
+//Fewest elements a statistic splits across threads
+#ifndef _MATHLAB_STATS_GRAIN
+#define _MATHLAB_STATS_GRAIN 65536
+#endif
 namespace Mathlab {
 	// 1 Types
 	template <class _T> struct _ValueType : _TypeHolder<_T> {};
 	template <class _T> struct _ValueType<_T[]> : _TypeHolder<_T> {};
 	template <class _T> struct _ValueType<Slice<_T>> : _TypeHolder<_T> {};
 	template <class _T> struct _ValueType<LinkedList<_T>> : _TypeHolder<_T> {};
+	template <class _T> requires requires { typename _T::ValueType; }
+	struct _ValueType<_T> : _TypeHolder<typename _T::ValueType> {};
 	template <class _T> struct _ValueType<const _T> : _TypeHolder<_T> {};
 	template <class _T> struct _ValueType<volatile _T> : _TypeHolder<_T> {};
 	template <class _T> struct _ValueType<const volatile _T> : _TypeHolder<_T> {};
@@ -16,19 +23,38 @@ namespace Mathlab {
 	template <Range... _R> using CommonValueType = CommonType<ValueType<_R>...>;
 	template <Range... _R> using PromotedValueType = Promoted<ValueType<_R>...>;
 	// 2 Functions
+	//init folded with every element of r by f; an indexable r of _MATHLAB_STATS_GRAIN
+	//elements or more is cut into chunks of that many, folded on the thread pool from init
+	//each and combined in order by join, for which init must be an identity
+	template <class _T, Range _R, class _F, class _J>
+	constexpr _T _fold(const _R& r, _T init, const _F& f, const _J& join) {
+		if constexpr (requires(size_t i) { r.size(); r[i]; })
+			if (!::std::is_constant_evaluated() && r.size() >= _MATHLAB_STATS_GRAIN)
+				return parallelReduce(size_t(0), size_t(r.size()), _MATHLAB_STATS_GRAIN, init,
+					[&](size_t i0, size_t i1) {
+						_T b = init;
+						for (size_t i = i0; i < i1; ++i) b = f(b, r[i]);
+						return b;
+					}, join);
+		for (auto a : r) init = f(init, a);
+		return init;
+	}
 	template <Range _R> constexpr ValueType<_R> sum(const _R& r) {
-		ValueType<_R> b = 0;
-		for (auto a : r) b += a;
-		return b;
+		typedef ValueType<_R> _V;
+		const auto plus = [](_V b, _V a) -> _V { return b + a; };
+		return _fold(r, _V(0), plus, plus);
 	}
 	template <Range _R> constexpr ValueType<_R> product(const _R& r) {
-		ValueType<_R> b = 1;
-		for (auto a : r) b *= a;
-		return b;
+		typedef ValueType<_R> _V;
+		const auto times = [](_V b, _V a) -> _V { return b * a; };
+		return _fold(r, _V(1), times, times);
 	}
 	template <Range _R> constexpr ValueType<_R> arithmeticMean(const _R& r) {
-		ValueType<_R> b = 0, n = 0;
-		for (auto a : r) b += a, n += 1;
+		typedef ValueType<_R> _V;
+		struct _S { _V b, n; };
+		const _S s = _fold(r, _S{ 0, 0 }, [](_S s, _V a) { return _S{ s.b + a, s.n + 1 }; },
+			[](_S x, _S y) { return _S{ x.b + y.b, x.n + y.n }; });
+		_V b = s.b, n = s.n;
 		if (!n) return nan(errno = EPERM);
 		if (isfinite(b)) return b / n;
 		for (b = 0; auto a:r) b += a / n;
@@ -52,15 +78,13 @@ namespace Mathlab {
 	}
 	template <Range _R> constexpr ValueType<_R> maximum(_R r) {
 		using _V = ValueType<_R>;
-		_V b = Limits<_V>::has_infinity ? -Limits<_V>::infinity() : Limits<_V>::lowest();
-		for (auto a : r) if (b < a) b = a;
-		return b;
+		const auto larger = [](_V b, _V a) { return b < a ? a : b; };
+		return _fold(r, Limits<_V>::has_infinity ? -Limits<_V>::infinity() : Limits<_V>::lowest(), larger, larger);
 	}
 	template <Range _R> constexpr ValueType<_R> minimum(_R r) {
 		using _V = ValueType<_R>;
-		_V b = Limits<_V>::has_infinity ? Limits<_V>::infinity() : Limits<_V>::max();
-		for (auto a : r) if (a < b) b = a;
-		return b;
+		const auto smaller = [](_V b, _V a) { return a < b ? a : b; };
+		return _fold(r, Limits<_V>::has_infinity ? Limits<_V>::infinity() : Limits<_V>::max(), smaller, smaller);
 	}
 	template <Range _R, RealArithmetic _T> constexpr ValueType<_R> mean(_R r, _T y = 1) {
 		long double b = 0, n = 0;
@@ -74,8 +98,10 @@ namespace Mathlab {
 		return pow(b, 1 / y);
 	}
 	template <Range _R> constexpr ValueType<_R> variance(const _R& r, bool sample = false) {
-		long double b = 0, c = 0, n = 0;
-		for (auto a : r) b += a * a, c += a, n += 1;
+		struct _S { long double b, c, n; };
+		const _S s = _fold(r, _S{ 0, 0, 0 }, [](_S s, ValueType<_R> a) { return _S{ s.b + a * a, s.c + a, s.n + 1 }; },
+			[](_S x, _S y) { return _S{ x.b + y.b, x.c + y.c, x.n + y.n }; });
+		long double b = s.b, c = s.c, n = s.n;
 		if (n <= sample) return nan(errno = EPERM);
 		if (isfinite(b - c * c)) return (b - c * c / n) / (n - sample);
 		for (b = c = 0, n -= sample; auto a : r) b += a * a / n, c += a / n;
@@ -3,7 +3,9 @@
 #define _MATHLAB_VECTOR_
 #include <initializer_list>
 #include "math.hpp"
+#include "kernel.hpp"
 namespace Mathlab {
+	template <class _T, size_t N, class _Op, class _L, class _R> class VectorExpr;
 	template <Arithmetic _T, size_t N> class Vector {
 		static_assert(N > 0 && NumericType<_T>);
 		_T _data[N];
@@ -23,6 +25,10 @@ namespace Mathlab {
 		template <Arithmetic _S> constexpr Vector(const Vector<_S, N>& other) noexcept : _data{ 0 } {
 			for (size_t i = 0; i < N; ++i) _data[i] = other[i];
 		}
+		template <class _S, class _Op, class _L, class _R>
+		constexpr Vector(const VectorExpr<_S, N, _Op, _L, _R>& e) noexcept : _data{ 0 } {
+			for (size_t i = 0; i < N; ++i) _data[i] = e.at(i);
+		}
 		template <Arithmetic _S, size_t M, ConvertibleTo<_T>... _U>
 		explicit constexpr Vector(const Vector<_S, M>& other, const _U&... u) noexcept : _data{ 0 } {
 			static_assert(N > M && N >= M + sizeof...(_U));
@@ -46,19 +52,44 @@ namespace Mathlab {
 		constexpr const _T& operator[](size_t a) const noexcept {
 			return _data[a];
 		}
+		//Expressions are evaluated straight into the Vector; each entry only reads the same
+		//entry of its operands, so the Vector may appear in the expression itself
+		template <class _S, class _Op, class _L, class _R>
+		constexpr Vector& operator=(const VectorExpr<_S, N, _Op, _L, _R>& e) noexcept {
+			for (size_t i = 0; i < N; ++i) _data[i] = e.at(i);
+			return *this;
+		}
+		template <class _S, class _Op, class _L, class _R>
+		constexpr Vector& operator+=(const VectorExpr<_S, N, _Op, _L, _R>& e) noexcept {
+			for (size_t i = 0; i < N; ++i) _data[i] += e.at(i);
+			return *this;
+		}
+		template <class _S, class _Op, class _L, class _R>
+		constexpr Vector& operator-=(const VectorExpr<_S, N, _Op, _L, _R>& e) noexcept {
+			for (size_t i = 0; i < N; ++i) _data[i] -= e.at(i);
+			return *this;
+		}
 		template <Arithmetic _S> constexpr Vector& operator+=(const Vector<_S, N>& other) noexcept {
-			for (size_t i = 0; i < N; ++i) _data[i] += other._data[i];
+			if constexpr (SameAs<_T, _S> && Kernel::Vectorizable<_T>)
+				if (!::std::is_constant_evaluated()) return Kernel::add(_data, other.begin(), N), *this;
+			for (size_t i = 0; i < N; ++i) _data[i] += other[i];
 			return *this;
 		}
 		template <Arithmetic _S> constexpr Vector& operator-=(const Vector<_S, N>& other) noexcept {
-			for (size_t i = 0; i < N; ++i) _data[i] -= other._data[i];
+			if constexpr (SameAs<_T, _S> && Kernel::Vectorizable<_T>)
+				if (!::std::is_constant_evaluated()) return Kernel::sub(_data, other.begin(), N), *this;
+			for (size_t i = 0; i < N; ++i) _data[i] -= other[i];
 			return *this;
 		}
 		template <Arithmetic _S> constexpr Vector& operator*=(const _S& s) noexcept {
+			if constexpr (Kernel::VectorizableWith<_T, _S>)
+				if (!::std::is_constant_evaluated()) return Kernel::mul(_data, _T(s), N), *this;
 			for (_T* t = begin(); t < end(); ++t) *t *= s;
 			return *this;
 		}
 		template <Arithmetic _S> constexpr Vector& operator/=(const _S& s) noexcept {
+			if constexpr (Kernel::VectorizableWith<_T, _S>)
+				if (!::std::is_constant_evaluated()) return Kernel::div(_data, _T(s), N), *this;
 			for (_T* t = begin(); t < end(); ++t) *t /= s;
 			return *this;
 		}
@@ -67,38 +98,114 @@ namespace Mathlab {
 			return true;
 		}
 	};
-	//1 Operators
+	//1 Expression templates
+	//+, - and scalar * and / on Vector and Matrix return filled results, through the
+	//vectorized compound operators. lazy(v) opts an operand into lazy nodes instead: any
+	//operator with a node operand returns a node, so lazy(a) + b * 2 - c is computed by
+	//one fused loop when it is assigned to a Vector or Matrix. Named leaves are held by
+	//reference, temporaries and sub-expressions by value, so a node must not outlive the
+	//leaves it names; functions taking a Vector or Matrix need eval() on it
+	template <class _T> inline constexpr bool _isLeaf = false;
+	template <class _T, size_t N> inline constexpr bool _isLeaf<Vector<_T, N>> = true;
+	template <class _T> inline constexpr bool _isExpression = false;
+	template <class _T, size_t N, class _Op, class _L, class _R>
+	inline constexpr bool _isExpression<VectorExpr<_T, N, _Op, _L, _R>> = true;
+	//Leaves and expressions are excluded first so that checking Arithmetic<Matrix> ends
+	template <class _T> concept _Scalar = !_isLeaf<_T> && !_isExpression<_T> && Arithmetic<_T>;
+	template <class _T> using _Plain = ::std::remove_cvref_t<_T>;
+	template <class _T> using _Operand = ::std::conditional_t<_isLeaf<_Plain<_T>>
+		&& ::std::is_lvalue_reference_v<_T>, const _Plain<_T>&, _Plain<_T>>;
+	//Entry z of a leaf or an expression in row-major order; a scalar is its own entry
+	template <class _T> inline constexpr decltype(auto) _element(const _T& t, size_t z) noexcept {
+		if constexpr (_isExpression<_T>) return t.at(z);
+		else if constexpr (_isLeaf<_T>) {
+			if constexpr (requires { _T::rows; }) //Matrix rows are separate arrays to the constant evaluator
+				if (::std::is_constant_evaluated()) return t[z / _T::columns][z % _T::columns];
+			return t.begin()[z];
+		}
+		else return t;
+	}
+	//Materializes an expression operand of a product, passing anything else through
+	template <class _T> inline constexpr decltype(auto) _evaluate(const _T& t) noexcept {
+		if constexpr (_isExpression<_T>) return t.eval();
+		else return (t);
+	}
+	struct _First {
+		template <class _T, class _S> static constexpr const _T& apply(const _T& t, const _S&) noexcept { return t; }
+	};
+	struct _Plus {
+		template <class _T, class _S> static constexpr auto apply(const _T& t, const _S& s) noexcept { return t + s; }
+	};
+	struct _Minus {
+		template <class _T, class _S> static constexpr auto apply(const _T& t, const _S& s) noexcept { return t - s; }
+	};
+	struct _Times {
+		template <class _T, class _S> static constexpr auto apply(const _T& t, const _S& s) noexcept { return t * s; }
+	};
+	struct _Divide {
+		template <class _T, class _S> static constexpr auto apply(const _T& t, const _S& s) noexcept { return t / s; }
+	};
+	//_L and _R are _Operand types, references for named leaves
+	template <class _T, size_t N, class _Op, class _L, class _R> class VectorExpr {
+		_L _l;
+		_R _r;
+	public:
+		typedef _T ValueType;
+		static constexpr size_t columns = N;
+		constexpr VectorExpr(const _Plain<_L>& l, const _Plain<_R>& r) noexcept : _l(l), _r(r) {}
+		constexpr _T at(size_t z) const noexcept {
+			return _T(_Op::apply(_element(_l, z), _element(_r, z)));
+		}
+		constexpr _T operator[](size_t z) const noexcept {
+			return at(z);
+		}
+		constexpr Vector<_T, N> eval() const noexcept {
+			return *this;
+		}
+		template <class _S> constexpr bool operator==(const _S& rhs) const noexcept requires (!_Scalar<_S>) {
+			for (size_t i = 0; i < N; ++i) if (at(i) != _element(rhs, i)) return false;
+			return true;
+		}
+	};
+	template <class _T, size_t N, class _Op, class _L, class _R>
+	Vector(const VectorExpr<_T, N, _Op, _L, _R>&) -> Vector<_T, N>;
+	//Length of a Vector or vector expression, 0 for anything else
+	template <class _T> inline constexpr size_t _vectorLength = 0;
+	template <class _T, size_t N> inline constexpr size_t _vectorLength<Vector<_T, N>> = N;
+	template <class _T, size_t N, class _Op, class _L, class _R>
+	inline constexpr size_t _vectorLength<VectorExpr<_T, N, _Op, _L, _R>> = N;
+	template <class _T, class _S> concept _Vectors = _vectorLength<_T> > 0 && _vectorLength<_T> == _vectorLength<_S>;
+	//Vectors of which at least one is a node
+	template <class _T, class _S> concept _LazyVectors = _Vectors<_Plain<_T>, _Plain<_S>>
+		&& (_isExpression<_Plain<_T>> || _isExpression<_Plain<_S>>);
+	template <class _T> concept _LazyVector = _vectorLength<_Plain<_T>> > 0 && _isExpression<_Plain<_T>>;
+	template <class _T> requires (_isLeaf<_Plain<_T>> && _vectorLength<_Plain<_T>> > 0)
+	inline constexpr auto lazy(_T&& v) noexcept {
+		typedef _Plain<_T> _V;
+		return VectorExpr<typename _V::ValueType, _V::columns, _First, _Operand<_T>, int>(v, 0);
+	}
+	//2 Operators
 	template <class _T, class _S, size_t N> inline constexpr auto operator+(const Vector<_T, N>& lhs, const Vector<_S, N>& rhs) noexcept {
-		auto a = lhs[0] + rhs[0];
-		Vector<decltype(a), N> v = { a };
-		for (size_t i = 1; i < N; ++i) v[i] = lhs[i] + rhs[i];
-		return v;
+		Vector<decltype(lhs[0] + rhs[0]), N> v = lhs;
+		return v += rhs;
 	}
 	template <class _T, class _S, size_t N> inline constexpr auto operator-(const Vector<_T, N>& lhs, const Vector<_S, N>& rhs) noexcept {
-		auto a = lhs[0] - rhs[0];
-		Vector<decltype(a), N> v = { a };
-		for (size_t i = 1; i < N; ++i) v[i] = lhs[i] - rhs[i];
-		return v;
-	}
-	template <class _T, class _S, size_t N> inline constexpr auto operator*(const Vector<_T, N>& lhs, const _S& rhs) noexcept {
-		auto a = lhs[0] * rhs;
-		Vector<decltype(a), N> v = { a };
-		for (size_t i = 1; i < N; ++i) v[i] = lhs[i] * rhs;
-		return v;
-	}
-	template <class _T, class _S, size_t N> inline constexpr auto operator/(const Vector<_T, N>& lhs, const _S& rhs) noexcept {
-		auto a = lhs[0] / rhs;
-		Vector<decltype(a), N> v = { a };
-		for (size_t i = 1; i < N; ++i) v[i] = lhs[i] / rhs;
-		return v;
-	}
-	template <class _T, class _S, size_t N> inline constexpr auto operator*(const _T& lhs, const Vector<_S, N>& rhs) noexcept {
-		return rhs * lhs;
+		Vector<decltype(lhs[0] - rhs[0]), N> v = lhs;
+		return v -= rhs;
 	}
-	template <class _T, class _S, size_t N>	inline constexpr auto operator*(const Vector<_T, N>& lhs, const Vector<_S, N>& rhs) noexcept {
-		auto a = lhs[0] * conj(rhs[0]);
-		for (size_t i = 1; i < N; ++i) a += lhs[i] * conj(rhs[i]);
-		return a;
+	template <class _T, class _S, size_t N> requires _Scalar<_S>
+	inline constexpr auto operator*(const Vector<_T, N>& lhs, const _S& rhs) noexcept {
+		Vector<decltype(lhs[0] * rhs), N> v = lhs;
+		return v *= rhs;
+	}
+	template <class _T, class _S, size_t N> requires _Scalar<_S>
+	inline constexpr auto operator/(const Vector<_T, N>& lhs, const _S& rhs) noexcept {
+		Vector<decltype(lhs[0] / rhs), N> v = lhs;
+		return v /= rhs;
+	}
+	template <class _T, class _S, size_t N> requires _Scalar<_T>
+	inline constexpr auto operator*(const _T& lhs, const Vector<_S, N>& rhs) noexcept {
+		return rhs * lhs;
 	}
 	template <class _T, size_t N> inline constexpr Vector<_T, N> operator+(const Vector<_T, N>& m) noexcept {
 		return m * 1;
@@ -106,7 +213,43 @@ namespace Mathlab {
 	template <class _T, size_t N> inline constexpr Vector<_T, N> operator-(const Vector<_T, N>& m) noexcept {
 		return m * -1;
 	}
-	//2 Vector operations
+	template <class _T, class _S> requires _LazyVectors<_T, _S>
+	inline constexpr auto operator+(_T&& lhs, _S&& rhs) noexcept {
+		typedef decltype(_element(lhs, 0) + _element(rhs, 0)) _R;
+		return VectorExpr<_R, _vectorLength<_Plain<_T>>, _Plus, _Operand<_T>, _Operand<_S>>(lhs, rhs);
+	}
+	template <class _T, class _S> requires _LazyVectors<_T, _S>
+	inline constexpr auto operator-(_T&& lhs, _S&& rhs) noexcept {
+		typedef decltype(_element(lhs, 0) - _element(rhs, 0)) _R;
+		return VectorExpr<_R, _vectorLength<_Plain<_T>>, _Minus, _Operand<_T>, _Operand<_S>>(lhs, rhs);
+	}
+	template <class _T, class _S> requires (_LazyVector<_T> && _Scalar<_S>)
+	inline constexpr auto operator*(const _T& lhs, const _S& rhs) noexcept {
+		typedef decltype(_element(lhs, 0) * rhs) _R;
+		return VectorExpr<_R, _vectorLength<_T>, _Times, _T, _S>(lhs, rhs);
+	}
+	template <class _T, class _S> requires (_LazyVector<_T> && _Scalar<_S>)
+	inline constexpr auto operator/(const _T& lhs, const _S& rhs) noexcept {
+		typedef decltype(_element(lhs, 0) / rhs) _R;
+		return VectorExpr<_R, _vectorLength<_T>, _Divide, _T, _S>(lhs, rhs);
+	}
+	template <class _T, class _S> requires (_Scalar<_T> && _LazyVector<_S>)
+	inline constexpr auto operator*(const _T& lhs, const _S& rhs) noexcept {
+		return rhs * lhs;
+	}
+	template <class _T> requires _LazyVector<_T> inline constexpr auto operator+(const _T& m) noexcept {
+		return VectorExpr<typename _T::ValueType, _vectorLength<_T>, _Times, _T, int>(m, 1);
+	}
+	template <class _T> requires _LazyVector<_T> inline constexpr auto operator-(const _T& m) noexcept {
+		return VectorExpr<typename _T::ValueType, _vectorLength<_T>, _Times, _T, int>(m, -1);
+	}
+	template <class _T, class _S> requires _Vectors<_T, _S>
+	inline constexpr auto operator*(const _T& lhs, const _S& rhs) noexcept {
+		auto a = lhs[0] * conj(rhs[0]);
+		for (size_t i = 1; i < _vectorLength<_T>; ++i) a += lhs[i] * conj(rhs[i]);
+		return a;
+	}
+	//3 Vector operations
 	template <class _T, size_t N> inline constexpr _T abs(const Vector<_T, N>& v) noexcept {
 		long double r = 0;
 		for (_T t : v) {
@@ -116,16 +259,24 @@ namespace Mathlab {
 		}
 		return r;
 	}
-	template <class _T, class _S, size_t N> inline constexpr CommonType<_T, _S> angle(const Vector<_T, N>& lhs, const Vector<_S, N>& rhs) noexcept {
+	template <class _V> requires _LazyVector<_V>
+	inline constexpr typename _V::ValueType abs(const _V& v) noexcept {
+		return abs(v.eval());
+	}
+	template <class _T, class _S> requires _Vectors<_T, _S> inline constexpr
+		CommonType<typename _T::ValueType, typename _S::ValueType> angle(const _T& lhs, const _S& rhs) noexcept {
 		return acos(lhs * rhs / abs(lhs) / abs(rhs));
 	}
-	template <class _T, class _S, size_t N> inline constexpr CommonType<_T, _S> operator|(const Vector<_T, N>& lhs, const Vector<_S, N>& rhs) noexcept {
+	template <class _T, class _S> requires _Vectors<_T, _S> inline constexpr
+		CommonType<typename _T::ValueType, typename _S::ValueType> operator|(const _T& lhs, const _S& rhs) noexcept {
 		return acos(lhs * rhs / abs(lhs) / abs(rhs));
 	}
-	template <class _T, size_t N> inline constexpr Vector<_T, N> unitVector(const Vector<_T, N>& v) noexcept {
+	template <class _V> requires (_vectorLength<_V> > 0)
+	inline constexpr Vector<typename _V::ValueType, _vectorLength<_V>> unitVector(const _V& v) noexcept {
 		return v / abs(v);
 	}
-	template <class _T, size_t N> inline constexpr Vector<_T, N> operator*(const Vector<_T, N>& v) noexcept {
+	template <class _V> requires (_vectorLength<_V> > 0)
+	inline constexpr Vector<typename _V::ValueType, _vectorLength<_V>> operator*(const _V& v) noexcept {
 		return v / abs(v);
 	}
 }